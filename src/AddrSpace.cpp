@@ -18,6 +18,7 @@
 
 #include "AddrSpace.h"
 #include "Emulation.h"
+#include "Snapshot.h"
 
 using namespace std;
 
@@ -25,6 +26,8 @@ AddrSpace::AddrSpace(uint8_t nullByte)
 {
     m_nullByte = nullByte;
     m_itemCountR = m_itemCountW = 0;
+    buildPageTable(m_pagesR, 0, nullptr, nullptr, nullptr, nullptr);
+    buildPageTable(m_pagesW, 0, nullptr, nullptr, nullptr, nullptr);
     /*m_firstAddressesR = new int [m_maxAsItems];
     m_firstAddressesW = new int [m_maxAsItems];
     m_itemSizesR = new int [m_maxAsItems];
@@ -67,6 +70,9 @@ void AddrSpace::addReadRange(int firstAddr, int lastAddr, AddressableDevice* add
     m_firstAddressesR = m_firstAddressesRVector.data();
     m_itemSizesR = m_itemSizesRVector.data();
     m_devFirstAddressesR = m_devFirstAddressesRVector.data();
+
+    buildPageTable(m_pagesR, m_itemCountR, m_devicesR, m_firstAddressesR, m_itemSizesR, m_devFirstAddressesR);
+    invalidateDirectPages();
 }
 
 
@@ -94,6 +100,48 @@ void AddrSpace::addWriteRange(int firstAddr, int lastAddr, AddressableDevice* ad
     m_firstAddressesW = m_firstAddressesWVector.data();
     m_itemSizesW = m_itemSizesWVector.data();
     m_devFirstAddressesW = m_devFirstAddressesWVector.data();
+
+    buildPageTable(m_pagesW, m_itemCountW, m_devicesW, m_firstAddressesW, m_itemSizesW, m_devFirstAddressesW);
+    invalidateDirectPages();
+}
+
+
+// Построение таблицы страниц по отсортированным спискам областей.
+// Страница обслуживается напрямую, если все ее адреса попадают в одну область
+// (или все не распределены), иначе помечается для поиска по спискам.
+void AddrSpace::buildPageTable(AddrSpacePage* pages, int itemCount, AddressableDevice** devices, int* firstAddresses, int* itemSizes, int* devFirstAddresses)
+{
+    const int pageSize = 1 << c_pageShift;
+
+    for (int page = 0; page < c_nPages; page++) {
+        int pageFirst = page << c_pageShift;
+        int pageLast = pageFirst + pageSize - 1;
+
+        int i;
+        for (i = 0; i < itemCount && firstAddresses[i] <= pageFirst; i++);
+
+        AddrSpacePage& entry = pages[page];
+        entry.device = nullptr;
+        entry.offset = 0;
+        entry.isSlow = false;
+
+        if (i < itemCount && firstAddresses[i] <= pageLast) {
+            // в пределах страницы начинается другая область
+            entry.isSlow = true;
+            continue;
+        }
+
+        if (i == 0)
+            continue; // страница не распределена
+
+        i--;
+        int itemLast = firstAddresses[i] + itemSizes[i] - 1;
+        if (itemLast >= pageLast) {
+            entry.device = devices[i];
+            entry.offset = devFirstAddresses[i] - firstAddresses[i];
+        } else if (itemLast >= pageFirst)
+            entry.isSlow = true; // область заканчивается внутри страницы
+    }
 }
 
 
@@ -101,6 +149,56 @@ uint8_t AddrSpace::readByte(int addr)
 {
     if (m_addrMask)
         addr &= m_addrMask;
+
+    if (unsigned(addr) < 0x10000) {
+        const AddrSpacePage& page = m_pagesR[addr >> c_pageShift];
+        if (!page.isSlow)
+            return page.device ? page.device->readByte(addr + page.offset) : m_nullByte;
+    }
+
+    return readByteSlow(addr);
+}
+
+
+void AddrSpace::writeByte(int addr, uint8_t value)
+{
+    if (m_addrMask)
+        addr &= m_addrMask;
+
+    if (unsigned(addr) < 0x10000) {
+        const AddrSpacePage& page = m_pagesW[addr >> c_pageShift];
+        if (!page.isSlow) {
+            if (page.device)
+                page.device->writeByte(addr + page.offset, value);
+            return;
+        }
+    }
+
+    writeByteSlow(addr, value);
+}
+
+
+uint8_t* AddrSpace::getDirectPagePtr(int addr, bool write)
+{
+    if (m_addrMask) {
+        if ((m_addrMask & 0xFF) != 0xFF)
+            return nullptr;
+        addr &= m_addrMask;
+    }
+
+    if (unsigned(addr) >= 0x10000)
+        return nullptr;
+
+    const AddrSpacePage& page = write ? m_pagesW[addr >> c_pageShift] : m_pagesR[addr >> c_pageShift];
+    if (page.isSlow || !page.device)
+        return nullptr;
+
+    return page.device->getDirectPagePtr(addr + page.offset, write);
+}
+
+
+uint8_t AddrSpace::readByteSlow(int addr)
+{
     int i;
     for (i = 0; i < m_itemCountR && m_firstAddressesR[i] <= addr; i++);
     if (i == 0)
@@ -110,10 +208,8 @@ uint8_t AddrSpace::readByte(int addr)
 }
 
 
-void AddrSpace::writeByte(int addr, uint8_t value)
+void AddrSpace::writeByteSlow(int addr, uint8_t value)
 {
-    if (m_addrMask)
-        addr &= m_addrMask;
     int i;
     for (i = 0; i < m_itemCountW && m_firstAddressesW[i] <= addr; i++);
     if (i == 0)
@@ -167,13 +263,16 @@ void AddrSpaceMapper::attachPage(int page, AddressableDevice* as)
 {
     if (page < m_nPages)
         m_pages[page] = as;
+    invalidateDirectPages();
 }
 
 
 void AddrSpaceMapper::setCurPage(int page)
 {
-    if (page < m_nPages)
+    if (page < m_nPages && page != m_curPage) {
         m_curPage = page;
+        invalidateDirectPages();
+    }
 }
 
 
@@ -186,6 +285,12 @@ uint8_t AddrSpaceMapper::readByte(int addr)
 }
 
 
+uint8_t* AddrSpaceMapper::getDirectPagePtr(int addr, bool write)
+{
+    return m_pages[m_curPage] ? m_pages[m_curPage]->getDirectPagePtr(addr, write) : nullptr;
+}
+
+
 void AddrSpaceMapper::writeByte(int addr, uint8_t value)
 {
     if (m_pages[m_curPage])
@@ -193,6 +298,18 @@ void AddrSpaceMapper::writeByte(int addr, uint8_t value)
 }
 
 
+void AddrSpaceMapper::saveState(SnapshotWriter& writer)
+{
+    writer.writeInt(m_curPage);
+}
+
+
+void AddrSpaceMapper::loadState(SnapshotReader& reader)
+{
+    setCurPage(reader.readInt());
+}
+
+
 bool AddrSpaceMapper::setProperty(const string& propertyName, const EmuValuesList& values)
 {
     if (AddressableDevice::setProperty(propertyName, values))
@@ -31,6 +31,14 @@
     int devFirstAddr;              // смещение в области памяти устройства
 };*/
 
+// Элемент таблицы страниц адресного пространства
+struct AddrSpacePage {
+    AddressableDevice* device; // устройство или nullptr, если страница не распределена
+    int offset;                // смещение: адрес в устройстве = addr + offset
+    bool isSlow;               // страница содержит несколько областей, используется поиск по спискам
+};
+
+
 class AddrSpace : public AddressableDevice
 {
     public:
@@ -40,6 +48,7 @@ class AddrSpace : public AddressableDevice
 
         uint8_t readByte(int addr) override;
         void writeByte(int addr, uint8_t value) override;
+        uint8_t* getDirectPagePtr(int addr, bool write) override;
 
         void addRange(int firstAddr, int lastAddr, AddressableDevice* addrDevice, int devFirstAddr = 0);
         virtual void addReadRange(int firstAddr, int lastAddr, AddressableDevice* addrDevice, int devFirstAddr = 0);
@@ -48,8 +57,18 @@ class AddrSpace : public AddressableDevice
         static EmuObject* create(const EmuValuesList&) {return new AddrSpace();}
 
 private:
+        static const int c_pageShift = 8;                                // размер страницы 256 байт
+        static const int c_nPages = 0x10000 >> c_pageShift;              // количество страниц в 64К
+
         uint8_t m_nullByte;          // байт, считываемый из нераспределенного пространства
 
+        AddrSpacePage m_pagesR[c_nPages]; // таблица страниц для чтения
+        AddrSpacePage m_pagesW[c_nPages]; // таблица страниц для записи
+
+        static void buildPageTable(AddrSpacePage* pages, int itemCount, AddressableDevice** devices, int* firstAddresses, int* itemSizes, int* devFirstAddresses);
+        uint8_t readByteSlow(int addr);
+        void writeByteSlow(int addr, uint8_t value);
+
         int m_itemCountR;            // количество элементов чтения
         std::vector<AddressableDevice*> m_devicesRVector; // вектор устройств для чтения
         std::vector<int> m_firstAddressesRVector;         // вектор начальных адресов устройств для чтения
@@ -81,13 +100,18 @@ class AddrSpaceMapper : public AddressableDevice
         ~AddrSpaceMapper();
 
         bool setProperty(const std::string& propertyName, const EmuValuesList& values) override;
-        void reset() override {m_curPage = 0;}
+        void reset() override {m_curPage = 0; invalidateDirectPages();}
 
         void attachPage(int page, AddressableDevice* as);
         void setCurPage(int page);
+        int getCurPage() {return m_curPage;}
 
         void writeByte(int addr, uint8_t value) override;
         uint8_t readByte(int addr) override;
+        uint8_t* getDirectPagePtr(int addr, bool write) override;
+
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
 
         static EmuObject* create(const EmuValuesList& parameters) {return parameters[0].isInt() ? new AddrSpaceMapper(parameters[0].asInt()) : nullptr;}
 
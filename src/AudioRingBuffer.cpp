@@ -0,0 +1,105 @@
+﻿/*
+ *  Emu80 v. 4.x
+ *  © Viktor Pykhonin <pyk@mail.ru>, 2016-2019
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string.h>
+
+#include "AudioRingBuffer.h"
+
+using namespace std;
+
+
+AudioRingBuffer::AudioRingBuffer(int capacity)
+{
+    unsigned size = 1;
+    while (size < unsigned(capacity))
+        size <<= 1;
+
+    m_buffer = new int16_t[size];
+    m_mask = size - 1;
+    m_writePos.store(0, memory_order_relaxed);
+    m_readPos.store(0, memory_order_relaxed);
+}
+
+
+AudioRingBuffer::~AudioRingBuffer()
+{
+    delete[] m_buffer;
+}
+
+
+int AudioRingBuffer::write(const int16_t* samples, int nSamples)
+{
+    unsigned writePos = m_writePos.load(memory_order_relaxed);
+    unsigned readPos = m_readPos.load(memory_order_acquire);
+
+    unsigned freeSpace = m_mask + 1 - (writePos - readPos);
+    unsigned n = unsigned(nSamples) < freeSpace ? nSamples : freeSpace;
+
+    unsigned offset = writePos & m_mask;
+    unsigned n1 = n < m_mask + 1 - offset ? n : m_mask + 1 - offset;
+    memcpy(m_buffer + offset, samples, n1 * sizeof(int16_t));
+    memcpy(m_buffer, samples + n1, (n - n1) * sizeof(int16_t));
+
+    m_writePos.store(writePos + n, memory_order_release);
+    return n;
+}
+
+
+int AudioRingBuffer::read(int16_t* samples, int nSamples)
+{
+    unsigned readPos = m_readPos.load(memory_order_relaxed);
+    unsigned writePos = m_writePos.load(memory_order_acquire);
+
+    unsigned queued = writePos - readPos;
+    unsigned n = unsigned(nSamples) < queued ? nSamples : queued;
+
+    unsigned offset = readPos & m_mask;
+    unsigned n1 = n < m_mask + 1 - offset ? n : m_mask + 1 - offset;
+    memcpy(samples, m_buffer + offset, n1 * sizeof(int16_t));
+    memcpy(samples + n1, m_buffer, (n - n1) * sizeof(int16_t));
+
+    m_readPos.store(readPos + n, memory_order_release);
+    return n;
+}
+
+
+int AudioRingBuffer::skip(int nSamples)
+{
+    unsigned readPos = m_readPos.load(memory_order_relaxed);
+    unsigned writePos = m_writePos.load(memory_order_acquire);
+
+    unsigned queued = writePos - readPos;
+    unsigned n = unsigned(nSamples) < queued ? nSamples : queued;
+
+    m_readPos.store(readPos + n, memory_order_release);
+    return n;
+}
+
+
+int AudioRingBuffer::getOccupancy() const
+{
+    unsigned readPos = m_readPos.load(memory_order_acquire);
+    unsigned writePos = m_writePos.load(memory_order_acquire);
+    return writePos - readPos;
+}
+
+
+void AudioRingBuffer::reset()
+{
+    m_writePos.store(0, memory_order_relaxed);
+    m_readPos.store(0, memory_order_relaxed);
+}
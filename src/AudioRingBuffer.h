@@ -0,0 +1,63 @@
+﻿/*
+ *  Emu80 v. 4.x
+ *  © Viktor Pykhonin <pyk@mail.ru>, 2016-2019
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+// Lock-free single producer / single consumer ring buffer for audio samples
+
+#ifndef AUDIORINGBUFFER_H
+#define AUDIORINGBUFFER_H
+
+#include <atomic>
+
+#include "EmuTypes.h"
+
+
+// Samples are written by emulation (producer) and read by the audio output (consumer),
+// each side may run in its own thread without locking
+class AudioRingBuffer
+{
+    public:
+        // capacity is rounded up to a power of 2
+        AudioRingBuffer(int capacity);
+        ~AudioRingBuffer();
+
+        AudioRingBuffer(const AudioRingBuffer&) = delete;
+        AudioRingBuffer& operator=(const AudioRingBuffer&) = delete;
+
+        // producer side, returns number of samples written (excess samples are dropped if buffer is full)
+        int write(const int16_t* samples, int nSamples);
+
+        // consumer side, return number of samples read or skipped
+        int read(int16_t* samples, int nSamples);
+        int skip(int nSamples);
+
+        // number of samples queued, may be called from either side
+        int getOccupancy() const;
+        int getCapacity() const {return m_mask + 1;}
+
+        // should be called only while neither side is active
+        void reset();
+
+    private:
+        int16_t* m_buffer;
+        unsigned m_mask;
+
+        // free running positions, wrap around modulo 2^32
+        std::atomic<unsigned> m_writePos;
+        std::atomic<unsigned> m_readPos;
+};
+
+#endif // AUDIORINGBUFFER_H
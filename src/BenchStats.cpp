@@ -0,0 +1,116 @@
+﻿/*
+ *  Emu80 v. 4.x
+ *  © Viktor Pykhonin <pyk@mail.ru>, 2016-2019
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+
+#include "BenchStats.h"
+#include "Cpu.h"
+#include "CrtRenderer.h"
+#include "SoundMixer.h"
+
+using namespace std;
+
+
+BenchStats::BenchStats()
+{
+    reset();
+}
+
+
+void BenchStats::reset()
+{
+    m_curSection = BS_OTHER;
+    for (int i = 0; i < BS_COUNT; i++)
+        m_sectionTimes[i] = 0;
+    m_startTime = m_sectionStartTime = getHostTime();
+}
+
+
+BenchSection BenchStats::enterSection(BenchSection section)
+{
+    uint64_t time = getHostTime();
+    m_sectionTimes[m_curSection] += time - m_sectionStartTime;
+    m_sectionStartTime = time;
+
+    BenchSection prevSection = m_curSection;
+    m_curSection = section;
+    return prevSection;
+}
+
+
+BenchSection BenchStats::getDeviceSection(IActive* device)
+{
+    auto it = m_deviceSections.find(device);
+    if (it != m_deviceSections.end())
+        return it->second;
+
+    BenchSection section = BS_OTHER;
+    if (dynamic_cast<Cpu*>(device))
+        section = BS_CPU;
+    else if (dynamic_cast<CrtRenderer*>(device))
+        section = BS_RENDERER;
+    else if (dynamic_cast<SoundMixer*>(device))
+        section = BS_MIXER;
+
+    m_deviceSections[device] = section;
+    return section;
+}
+
+
+void BenchStats::removeDevice(IActive* device)
+{
+    m_deviceSections.erase(device);
+}
+
+
+uint64_t BenchStats::getSectionTime(BenchSection section)
+{
+    uint64_t time = m_sectionTimes[section];
+    if (section == m_curSection)
+        time += getHostTime() - m_sectionStartTime;
+    return time;
+}
+
+
+uint64_t BenchStats::getTotalTime()
+{
+    return getHostTime() - m_startTime;
+}
+
+
+const char* BenchStats::getSectionName(BenchSection section)
+{
+    switch (section) {
+    case BS_CPU:
+        return "cpu";
+    case BS_RENDERER:
+        return "renderer";
+    case BS_MIXER:
+        return "mixer";
+    case BS_REWIND:
+        return "rewind";
+    default:
+        return "other";
+    }
+}
+
+
+uint64_t BenchStats::getHostTime()
+{
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
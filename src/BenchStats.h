@@ -0,0 +1,92 @@
+﻿/*
+ *  Emu80 v. 4.x
+ *  © Viktor Pykhonin <pyk@mail.ru>, 2016-2019
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Host time accounting for benchmark mode
+
+#ifndef BENCHSTATS_H
+#define BENCHSTATS_H
+
+#include <unordered_map>
+
+#include "EmuTypes.h"
+
+class IActive;
+
+
+enum BenchSection {
+    BS_CPU,
+    BS_RENDERER,
+    BS_MIXER,
+    BS_REWIND,
+    BS_OTHER,
+    BS_COUNT
+};
+
+
+class BenchStats
+{
+    public:
+        BenchStats();
+
+        void reset();
+
+        // Switches to a new section and returns the previous one
+        BenchSection enterSection(BenchSection section);
+
+        // Section to which time spent in device's operate() is accounted
+        BenchSection getDeviceSection(IActive* device);
+        void removeDevice(IActive* device);
+
+        uint64_t getSectionTime(BenchSection section); // ns
+        uint64_t getTotalTime(); // ns
+
+        static const char* getSectionName(BenchSection section);
+
+        // Monotonic host time, ns
+        static uint64_t getHostTime();
+
+    private:
+        BenchSection m_curSection = BS_OTHER;
+        uint64_t m_startTime;
+        uint64_t m_sectionStartTime;
+        uint64_t m_sectionTimes[BS_COUNT];
+
+        std::unordered_map<IActive*, BenchSection> m_deviceSections;
+};
+
+
+// Accounts time to a section until goes out of scope, does nothing if stats is nullptr
+class BenchSectionGuard
+{
+    public:
+        BenchSectionGuard(BenchStats* stats, BenchSection section) : m_stats(stats) {
+            if (m_stats)
+                m_prevSection = m_stats->enterSection(section);
+        }
+
+        ~BenchSectionGuard() {
+            if (m_stats)
+                m_stats->enterSection(m_prevSection);
+        }
+
+    private:
+        BenchStats* m_stats;
+        BenchSection m_prevSection = BS_OTHER;
+};
+
+#endif // BENCHSTATS_H
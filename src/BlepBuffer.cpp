@@ -0,0 +1,148 @@
+﻿/*
+ *  Emu80 v. 4.x
+ *  © Viktor Pykhonin <pyk@mail.ru>, 2016-2019
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+#include "BlepBuffer.h"
+#include "SoundMixer.h"
+
+using namespace std;
+
+
+// Step position resolution within sample period
+static const int BLEP_PHASES = 64;
+
+// Fixed point precision of levels
+static const int BLEP_SHIFT = 15;
+
+static const int BLEP_TAPS = BLEP_HALF_WIDTH * 2 + 1;
+
+// Per sample differences of the band-limited step for each step position
+static int s_blepTable[BLEP_PHASES + 1][BLEP_TAPS];
+static bool s_blepTableReady = false;
+
+
+// Band-limited step is the integral of Blackman-windowed sinc with cutoff slightly below Nyquist frequency
+static void initBlepTable()
+{
+    const double cutoff = 0.9;
+    const int steps = 16; // integration steps per phase
+    const int nPoints = BLEP_HALF_WIDTH * 2 * BLEP_PHASES * steps;
+
+    // integral values at every phase point from -BLEP_HALF_WIDTH to BLEP_HALF_WIDTH
+    vector<double> integral(BLEP_HALF_WIDTH * 2 * BLEP_PHASES + 1);
+    double sum = 0;
+    integral[0] = 0;
+    for (int i = 0; i < nPoints; i++) {
+        double t = -BLEP_HALF_WIDTH + (i + 0.5) / (BLEP_PHASES * steps);
+        double x = M_PI * cutoff * t;
+        double sinc = x != 0 ? sin(x) / x : 1.0;
+        double w = 2 * M_PI * (t + BLEP_HALF_WIDTH) / (BLEP_HALF_WIDTH * 2);
+        double window = 0.42 - 0.5 * cos(w) + 0.08 * cos(2 * w);
+        sum += sinc * window;
+        if ((i + 1) % steps == 0)
+            integral[(i + 1) / steps] = sum;
+    }
+
+    // step value at x samples after the step (x is in 1/BLEP_PHASES units)
+    auto step = [&](int x) {
+        x += BLEP_HALF_WIDTH * BLEP_PHASES;
+        if (x <= 0)
+            return 0;
+        if (x >= BLEP_HALF_WIDTH * 2 * BLEP_PHASES)
+            return 1 << BLEP_SHIFT;
+        return int(integral[x] / sum * (1 << BLEP_SHIFT) + 0.5);
+    };
+
+    // step at position (phase / BLEP_PHASES) within sample period preceding tap 0,
+    // tap n is delayed by BLEP_HALF_WIDTH samples
+    for (int phase = 0; phase <= BLEP_PHASES; phase++)
+        for (int n = 0; n < BLEP_TAPS; n++) {
+            int x = (n + 1 - BLEP_HALF_WIDTH) * BLEP_PHASES - phase;
+            s_blepTable[phase][n] = step(x) - step(x - BLEP_PHASES);
+        }
+
+    s_blepTableReady = true;
+}
+
+
+BlepBuffer::BlepBuffer()
+{
+    if (!s_blepTableReady)
+        initBlepTable();
+
+    m_deltas.resize(SOUND_BLOCK_SIZE + BLEP_TAPS);
+}
+
+
+void BlepBuffer::setLevel(int level)
+{
+    m_accum = level << BLEP_SHIFT;
+}
+
+
+void BlepBuffer::addDelta(uint64_t clock, int delta)
+{
+    if (delta)
+        m_edges.push_back({clock, delta});
+}
+
+
+void BlepBuffer::render(int* buffer, const uint64_t* sampleClocks, int nSamples)
+{
+    if (!m_rendered) {
+        m_lastSampleClock = sampleClocks[0];
+        m_rendered = true;
+    }
+
+    uint64_t lastClock = sampleClocks[nSamples - 1];
+
+    unsigned nPending = 0;
+    for (unsigned i = 0; i < m_edges.size(); i++) {
+        Edge& edge = m_edges[i];
+        if (edge.clock > lastClock) {
+            // after this block
+            m_edges[nPending++] = edge;
+            continue;
+        }
+
+        // edge is within (sampleClocks[k - 1], sampleClocks[k]]
+        int k = lower_bound(sampleClocks, sampleClocks + nSamples, edge.clock) - sampleClocks;
+        uint64_t prevClock = k ? sampleClocks[k - 1] : m_lastSampleClock;
+        int phase = 0;
+        if (edge.clock > prevClock)
+            phase = (edge.clock - prevClock) * BLEP_PHASES / (sampleClocks[k] - prevClock);
+
+        const int* table = s_blepTable[phase];
+        int* deltas = m_deltas.data() + k;
+        for (int n = 0; n < BLEP_TAPS; n++)
+            deltas[n] += table[n] * edge.delta;
+    }
+    m_edges.resize(nPending);
+
+    for (int i = 0; i < nSamples; i++) {
+        m_accum += m_deltas[i];
+        buffer[i] += m_accum >> BLEP_SHIFT;
+    }
+
+    memmove(m_deltas.data(), m_deltas.data() + nSamples, BLEP_TAPS * sizeof(int));
+    memset(m_deltas.data() + BLEP_TAPS, 0, SOUND_BLOCK_SIZE * sizeof(int));
+
+    m_lastSampleClock = lastClock;
+}
@@ -0,0 +1,66 @@
+﻿/*
+ *  Emu80 v. 4.x
+ *  © Viktor Pykhonin <pyk@mail.ru>, 2016-2019
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+// Band-limited step synthesis buffer for sound sources
+
+#ifndef BLEPBUFFER_H
+#define BLEPBUFFER_H
+
+#include <vector>
+
+#include "EmuTypes.h"
+
+
+// Half width of the band-limited step in samples, output is delayed by this value
+const int BLEP_HALF_WIDTH = 8;
+
+
+// Level changes of a sound source are recorded with their clocks and rendered at block render time
+// as band-limited steps instead of averaging the level over the sample period
+class BlepBuffer
+{
+    public:
+        BlepBuffer();
+
+        // sets current level immediately, without step
+        void setLevel(int level);
+
+        // records level change by delta at given clock, the clock must be later than last rendered sample
+        void addDelta(uint64_t clock, int delta);
+
+        // adds rendered samples ending at sampleClocks to buffer, changes after the last sample are kept
+        void render(int* buffer, const uint64_t* sampleClocks, int nSamples);
+
+    private:
+        struct Edge {
+            uint64_t clock;
+            int delta;
+        };
+
+        std::vector<Edge> m_edges;
+
+        // per sample level differences (fixed point), include tails of already rendered steps
+        std::vector<int> m_deltas;
+
+        // current output level (fixed point)
+        int m_accum = 0;
+
+        uint64_t m_lastSampleClock = 0;
+        bool m_rendered = false;
+};
+
+#endif // BLEPBUFFER_H
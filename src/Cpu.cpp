@@ -23,6 +23,9 @@
 #include "Cpu.h"
 #include "CpuHook.h"
 #include "CpuWaits.h"
+#include "CpuProfiler.h"
+#include "CpuTrace.h"
+#include "Watchpoints.h"
 #include "Emulation.h"
 #include "PlatformCore.h"
 
@@ -48,6 +51,7 @@ Cpu::~Cpu()
 void Cpu::attachAddrSpace(AddressableDevice* as)
 {
     m_addrSpace = as;
+    AddressableDevice::invalidateDirectPages();
 }
 
 
@@ -146,7 +150,185 @@ std::string Cpu::getPropertyStringValue(const std::string& propertyName)
 
 Cpu8080Compatible::Cpu8080Compatible()
 {
-    memset(m_hookArray, 0, 65536 * sizeof(CpuHook*));
+    memset(m_hookBitmap, 0, sizeof(m_hookBitmap));
+    resetDirectPages();
+}
+
+
+Cpu8080Compatible::~Cpu8080Compatible()
+{
+    delete m_profiler;
+    delete m_tracer;
+    delete m_watchpoints;
+}
+
+
+bool Cpu8080Compatible::setProperty(const string& propertyName, const EmuValuesList& values)
+{
+    if (Cpu::setProperty(propertyName, values))
+        return true;
+
+    if (propertyName == "profiler") {
+        if (values[0].asString() == "yes" || values[0].asString() == "no") {
+            setProfiling(values[0].asString() == "yes");
+            return true;
+        }
+    } else if (propertyName == "profilerBankMapper") {
+        m_profilerBankMapper = static_cast<AddrSpaceMapper*>(g_emulation->findObject(values[0].asString()));
+        if (m_profiler)
+            m_profiler->attachBankMapper(m_profilerBankMapper);
+        return true;
+    } else if (propertyName == "profilerReport") {
+        return writeProfile(values[0].asString());
+    } else if (propertyName == "trace") {
+        if (values[0].asString() == "yes" || values[0].asString() == "no") {
+            setTracing(values[0].asString() == "yes");
+            return true;
+        }
+    } else if (propertyName == "traceSize" && values[0].isInt()) {
+        setTraceSize(values[0].asInt());
+        return true;
+    } else if (propertyName == "traceDump") {
+        return writeTrace(values[0].asString());
+    }
+
+    return false;
+}
+
+
+string Cpu8080Compatible::getPropertyStringValue(const string& propertyName)
+{
+    string res;
+
+    res = Cpu::getPropertyStringValue(propertyName);
+    if (res != "")
+        return res;
+
+    if (propertyName == "profiler")
+        return m_profiling ? "yes" : "no";
+    else if (propertyName == "trace")
+        return m_tracing ? "yes" : "no";
+
+    return "";
+}
+
+
+void Cpu8080Compatible::setProfiling(bool profiling)
+{
+    if (profiling && !m_profiling) {
+        if (!m_profiler) {
+            m_profiler = new CpuProfiler(this);
+            m_profiler->attachBankMapper(m_profilerBankMapper);
+        }
+        m_profiler->reset();
+    }
+    m_profiling = profiling;
+}
+
+
+bool Cpu8080Compatible::writeProfile(const string& fileName)
+{
+    return m_profiler && m_profiler->writeReport(fileName);
+}
+
+
+void Cpu8080Compatible::setTracing(bool tracing)
+{
+    if (tracing && !m_tracing) {
+        if (!m_tracer)
+            m_tracer = new CpuTracer(getType() == CPU_Z80, m_traceSize);
+        m_tracer->clear();
+    }
+    m_tracing = tracing;
+}
+
+
+void Cpu8080Compatible::setTraceSize(unsigned nRecords)
+{
+    m_traceSize = nRecords;
+    if (m_tracer)
+        m_tracer->setSize(nRecords);
+}
+
+
+bool Cpu8080Compatible::writeTrace(const string& fileName)
+{
+    return m_tracer && m_tracer->writeFile(fileName);
+}
+
+
+WatchpointSpace* Cpu8080Compatible::getWatchpoints()
+{
+    if (!m_watchpoints)
+        m_watchpoints = new WatchpointSpace(this);
+    return m_watchpoints;
+}
+
+
+void Cpu8080Compatible::attachWatchpoints(AddressableDevice* watchSpace)
+{
+    m_watchSpace = watchSpace;
+    AddressableDevice::invalidateDirectPages();
+}
+
+
+void Cpu8080Compatible::resetDirectPages()
+{
+    memset(m_directReadPages, 0, sizeof(m_directReadPages));
+    memset(m_directWritePages, 0, sizeof(m_directWritePages));
+    memset(m_readPageResolved, 0, sizeof(m_readPageResolved));
+    memset(m_writePageResolved, 0, sizeof(m_writePageResolved));
+    m_directPagesVersion = AddressableDevice::getDirectPagesVersion();
+}
+
+
+// Page pointers are requested from the address space on first access after mapping change
+uint8_t Cpu8080Compatible::readMemSlow(int addr)
+{
+    if (unsigned(addr) < 0x10000) {
+        if (m_directPagesVersion != AddressableDevice::getDirectPagesVersion())
+            resetDirectPages();
+        int page = addr >> 8;
+        if (!m_readPageResolved[page]) {
+            m_readPageResolved[page] = true;
+            m_directReadPages[page] = getMemSpace()->getDirectPagePtr(addr & 0xFF00, false);
+            if (m_directReadPages[page])
+                return m_directReadPages[page][addr & 0xFF];
+        }
+    }
+    return getMemSpace()->readByte(addr);
+}
+
+
+uint8_t Cpu8080Compatible::peekMemSlow(uint16_t addr)
+{
+    if (m_directPagesVersion != AddressableDevice::getDirectPagesVersion())
+        resetDirectPages();
+    int page = addr >> 8;
+    if (!m_readPageResolved[page]) {
+        m_readPageResolved[page] = true;
+        m_directReadPages[page] = getMemSpace()->getDirectPagePtr(addr & 0xFF00, false);
+    }
+    return m_directReadPages[page] ? m_directReadPages[page][addr & 0xFF] : 0xFF;
+}
+
+
+void Cpu8080Compatible::writeMemSlow(int addr, uint8_t value)
+{
+    if (unsigned(addr) < 0x10000) {
+        if (m_directPagesVersion != AddressableDevice::getDirectPagesVersion())
+            resetDirectPages();
+        int page = addr >> 8;
+        if (!m_writePageResolved[page]) {
+            m_writePageResolved[page] = true;
+            m_directWritePages[page] = getMemSpace()->getDirectPagePtr(addr & 0xFF00, true);
+            if (m_directWritePages[page]) {
+                m_directWritePages[page][addr & 0xFF] = value;
+                return;
+            }
+        }
+    }
+    getMemSpace()->writeByte(addr, value);
 }
 
 
@@ -154,9 +336,8 @@ void Cpu8080Compatible::addHook(CpuHook* hook)
 {
     Cpu::addHook(hook);
     uint16_t addr = hook->getHookAddr();
-    if (!m_hookArray[addr])
-        m_hookArray[addr] = new list<CpuHook*>;
-    m_hookArray[addr]->push_back(hook);
+    m_hookLists[addr].push_back(hook);
+    m_hookBitmap[addr >> 5] |= 1u << (addr & 31);
 }
 
 
@@ -164,12 +345,12 @@ void Cpu8080Compatible::removeHook(CpuHook* hook)
 {
     Cpu::removeHook(hook);
     uint16_t addr = hook->getHookAddr();
-    list<CpuHook*>* hookList = m_hookArray[addr];
-    if (hookList) {
-        hookList->remove(hook);
-        if (hookList->empty()) {
-            delete hookList;
-            m_hookArray[addr] = nullptr;
+    auto it = m_hookLists.find(addr);
+    if (it != m_hookLists.end()) {
+        it->second.remove(hook);
+        if (it->second.empty()) {
+            m_hookLists.erase(it);
+            m_hookBitmap[addr >> 5] &= ~(1u << (addr & 31));
         }
     }
 }
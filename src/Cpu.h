@@ -21,13 +21,20 @@
 
 //#include <vector>
 #include <list>
+#include <map>
+
+#include <string.h>
 
 #include "EmuObjects.h"
 
 
 class CpuHook;
 class CpuWaits;
+class CpuProfiler;
+class CpuTracer;
+class WatchpointSpace;
 class PlatformCore;
+class AddrSpaceMapper;
 
 
 class Cpu : public ActiveDevice
@@ -65,6 +72,8 @@ class Cpu : public ActiveDevice
 
         AddressableDevice* getAddrSpace() {return m_addrSpace;}
 
+        uint64_t getInstrCount() {return m_instrCount;}
+
     protected:
         AddressableDevice* m_addrSpace = nullptr;
         AddressableDevice* m_ioAddrSpace = nullptr;
@@ -80,6 +89,8 @@ class Cpu : public ActiveDevice
         bool m_debugOnHalt = false;
         bool m_debugOnIllegalCmd = false;
 
+        uint64_t m_instrCount = 0; // executed instructions counter
+
         CpuWaits* m_waits = nullptr;
 };
 
@@ -88,6 +99,10 @@ class Cpu8080Compatible : public Cpu
 {
     public:
         Cpu8080Compatible();
+        virtual ~Cpu8080Compatible();
+
+        bool setProperty(const std::string& propertyName, const EmuValuesList& values) override;
+        std::string getPropertyStringValue(const std::string& propertyName) override;
 
         void addHook(CpuHook* hook) override;
         void removeHook(CpuHook* hook) override;
@@ -124,11 +139,121 @@ class Cpu8080Compatible : public Cpu
         virtual bool getInte() = 0;
         virtual bool checkForStackOperation() = 0;
 
+        // enabling starts a new profile, the profile is kept after disabling until the next start
+        void setProfiling(bool profiling);
+        bool writeProfile(const std::string& fileName);
+
+        // enabling starts a new trace, the trace is kept after disabling until the next start
+        void setTracing(bool tracing);
+        void setTraceSize(unsigned nRecords);
+        bool writeTrace(const std::string& fileName);
+
+        // memory watchpoints shared by debugger and gdb stub, created on first call
+        WatchpointSpace* getWatchpoints();
+
+        // memory accesses without direct page pointers go through the watchpoint layer if attached
+        void attachWatchpoints(AddressableDevice* watchSpace);
+
     protected:
+        // checked once per operate() call, so profiling and tracing cost nothing while they're off
+        bool m_profiling = false;
+        CpuProfiler* m_profiler = nullptr;
+        bool m_tracing = false;
+        CpuTracer* m_tracer = nullptr;
+
         int io_input(int port);
         void io_output(int port, int value);
 
-        std::list<CpuHook*>* m_hookArray[65536];
+        // memory access with direct page pointers fast path
+        inline uint8_t readMem(int addr);
+        inline void writeMem(int addr, uint8_t value);
+
+        // memory read through direct pages only, 0xFF for memory with side effects
+        inline uint8_t peekMem(uint16_t addr);
+        inline void peekInstruction(uint16_t addr, uint8_t* buf); // 4 bytes
+
+        // returns hook list for address or nullptr if there are no hooks
+        inline std::list<CpuHook*>* getHooks(uint16_t addr);
+
+    private:
+        // hook registry: bitmap (8 KB) for fast check and hook lists by address
+        uint32_t m_hookBitmap[65536 / 32];
+        std::map<uint16_t, std::list<CpuHook*>> m_hookLists;
+
+        AddrSpaceMapper* m_profilerBankMapper = nullptr;
+        unsigned m_traceSize = 262144;
+
+        uint8_t* m_directReadPages[256];
+        uint8_t* m_directWritePages[256];
+        bool m_readPageResolved[256];
+        bool m_writePageResolved[256];
+        unsigned m_directPagesVersion;
+
+        WatchpointSpace* m_watchpoints = nullptr;
+        AddressableDevice* m_watchSpace = nullptr;
+        inline AddressableDevice* getMemSpace() {return m_watchSpace ? m_watchSpace : m_addrSpace;}
+
+        void resetDirectPages();
+        uint8_t readMemSlow(int addr);
+        uint8_t peekMemSlow(uint16_t addr);
+        void writeMemSlow(int addr, uint8_t value);
 };
 
+
+inline std::list<CpuHook*>* Cpu8080Compatible::getHooks(uint16_t addr)
+{
+    if (m_hookBitmap[addr >> 5] & (1u << (addr & 31)))
+        return &m_hookLists[addr];
+    return nullptr;
+}
+
+
+inline uint8_t Cpu8080Compatible::readMem(int addr)
+{
+    if (unsigned(addr) < 0x10000 && m_directPagesVersion == AddressableDevice::getDirectPagesVersion()) {
+        uint8_t* page = m_directReadPages[addr >> 8];
+        if (page)
+            return page[addr & 0xFF];
+    }
+    return readMemSlow(addr);
+}
+
+
+inline uint8_t Cpu8080Compatible::peekMem(uint16_t addr)
+{
+    if (m_directPagesVersion == AddressableDevice::getDirectPagesVersion()) {
+        uint8_t* page = m_directReadPages[addr >> 8];
+        if (page)
+            return page[addr & 0xFF];
+    }
+    return peekMemSlow(addr);
+}
+
+
+inline void Cpu8080Compatible::peekInstruction(uint16_t addr, uint8_t* buf)
+{
+    if ((addr & 0xFF) <= 0xFC && m_directPagesVersion == AddressableDevice::getDirectPagesVersion()) {
+        uint8_t* page = m_directReadPages[addr >> 8];
+        if (page) {
+            memcpy(buf, page + (addr & 0xFF), 4);
+            return;
+        }
+    }
+    for (int i = 0; i < 4; i++)
+        buf[i] = peekMem(uint16_t(addr + i));
+}
+
+
+inline void Cpu8080Compatible::writeMem(int addr, uint8_t value)
+{
+    if (unsigned(addr) < 0x10000 && m_directPagesVersion == AddressableDevice::getDirectPagesVersion()) {
+        uint8_t* page = m_directWritePages[addr >> 8];
+        if (page) {
+            page[addr & 0xFF] = value;
+            return;
+        }
+    }
+    writeMemSlow(addr, value);
+}
+
 #endif // CPU_H
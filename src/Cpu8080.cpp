@@ -23,18 +23,21 @@
 #include "Cpu8080.h"
 #include "CpuHook.h"
 #include "CpuWaits.h"
+#include "CpuProfiler.h"
+#include "CpuTrace.h"
 #include "Platform.h"
 #include "PlatformCore.h"
 #include "Emulation.h"
+#include "Snapshot.h"
 
 using namespace std;
 
 // Cpu8080 types and macroses
 
-#define RD_BYTE(addr) (m_addrSpace->readByte(addr))
+#define RD_BYTE(addr) (readMem(addr))
 #define RD_WORD(addr) ((RD_BYTE((addr+1) & 0xFFFF) << 8) | RD_BYTE(addr))
 
-#define WR_BYTE(addr, value) m_addrSpace->writeByte(addr, value)
+#define WR_BYTE(addr, value) writeMem(addr, value)
 #define WR_WORD(addr, value) WR_BYTE(addr, value & 0xff);WR_BYTE((addr + 1) & 0xFFFF, (value >> 8) & 0xff);
 
 #define FLAGS           cpu.f
@@ -1729,10 +1732,10 @@ Cpu8080::Cpu8080() {
 }*/
 
 
-void Cpu8080::operate() {
+inline void Cpu8080::operateOnce() {
     if (!m_hooksDisabled) {
         bool retFlag = false;
-        list<CpuHook*>* hookList = m_hookArray[PC];
+        list<CpuHook*>* hookList = getHooks(PC);
         if (hookList) {
             for (auto it = hookList->begin(); it != hookList->end(); it++)
                 retFlag = retFlag || (*it)->hookProc();
@@ -1748,6 +1751,7 @@ void Cpu8080::operate() {
         m_curClock += m_kDiv * (clocks + m_waits->getCpuWaitStates(tag, opcode, clocks));
     } else
         m_curClock += m_kDiv * i8080_execute(RD_BYTE(PC++));
+    m_instrCount++;
 
     if (m_stepReq) {
         m_stepReq = false;
@@ -1756,6 +1760,59 @@ void Cpu8080::operate() {
 }
 
 
+// Executes instructions until another device is due
+void Cpu8080::operate() {
+    if (m_profiling || m_tracing) {
+        operateInstrumented();
+        return;
+    }
+
+#ifndef CPU8080_REFERENCE_CORE
+    if (m_threadedCore) {
+        operateThreaded();
+        return;
+    }
+#endif
+
+    do
+        operateOnce();
+    while (g_emulation->continueBatch(this));
+}
+
+
+// Profiling and tracing use the reference core: instruction by instruction with state recording
+void Cpu8080::operateInstrumented() {
+    do {
+        uint16_t addr = PC;
+        uint64_t clock = m_curClock;
+        uint64_t instrCount = m_instrCount;
+        bool tracing = m_tracing;
+
+        if (tracing) {
+            i8080_store_flags();
+            CpuTraceRecord* rec = m_tracer->getNextRecord();
+            rec->clock = clock;
+            rec->pc = addr;
+            rec->af = AF;
+            rec->bc = BC;
+            rec->de = DE;
+            rec->hl = HL;
+            rec->sp = SP;
+            peekInstruction(addr, rec->opcode);
+        }
+
+        operateOnce();
+
+        if (m_instrCount != instrCount) { // not skipped by hook
+            if (m_profiling)
+                m_profiler->countInstruction(addr, (m_curClock - clock) / m_kDiv);
+            if (tracing)
+                m_tracer->commitRecord();
+        }
+    } while (g_emulation->continueBatch(this));
+}
+
+
 void Cpu8080::ret() {
     POP(PC);
 }
@@ -1767,7 +1824,7 @@ void Cpu8080::intRst(int vect) {
         m_core->inte(false);
         if (RD_BYTE(PC) == 0x76) {
             PC++;
-            m_curClock = g_emulation->getCurClock();
+            syncronize();
         }
         RST(vect * 8);
         m_statusWord = 0xA2;
@@ -1898,6 +1955,82 @@ void Cpu8080::setIFF(bool iff)
 }
 
 
+void Cpu8080::saveState(SnapshotWriter& writer)
+{
+    saveClockState(writer);
+    writer.write16(getAF());
+    writer.write16(BC);
+    writer.write16(DE);
+    writer.write16(HL);
+    writer.write16(SP);
+    writer.write16(PC);
+    writer.write16(IFF);
+    writer.write16(cpu.last_pc);
+    writer.write8(m_statusWord);
+    writer.writeInt(m_iffPendingCnt);
+}
+
+
+void Cpu8080::loadState(SnapshotReader& reader)
+{
+    loadClockState(reader);
+    setAF(reader.read16());
+    BC = reader.read16();
+    DE = reader.read16();
+    HL = reader.read16();
+    SP = reader.read16();
+    PC = reader.read16();
+    IFF = reader.read16();
+    cpu.last_pc = reader.read16();
+    m_statusWord = reader.read8();
+    m_iffPendingCnt = reader.readInt();
+}
+
+
+bool Cpu8080::setProperty(const string& propertyName, const EmuValuesList& values)
+{
+    if (Cpu8080Compatible::setProperty(propertyName, values))
+        return true;
+
+    if (propertyName == "dispatch") {
+        if (values[0].asString() == "switch") {
+#ifndef CPU8080_REFERENCE_CORE
+            m_threadedCore = false;
+#endif
+            return true;
+        }
+#ifndef CPU8080_REFERENCE_CORE
+        else if (values[0].asString() == "threaded") {
+            m_threadedCore = true;
+            return true;
+        }
+#endif
+    }
+
+    return false;
+}
+
+
+string Cpu8080::getPropertyStringValue(const string& propertyName)
+{
+    string res;
+
+    res = Cpu8080Compatible::getPropertyStringValue(propertyName);
+    if (res != "")
+        return res;
+
+    if (propertyName == "dispatch") {
+#ifndef CPU8080_REFERENCE_CORE
+        return m_threadedCore ? "threaded" : "switch";
+#else
+        return "switch";
+#endif
+    }
+
+    return "";
+}
+
+
 /*
 bool Cpu8080::setProperty(const string& propertyName, const EmuValuesList& values)
 {
@@ -24,6 +24,14 @@
 
 #include "Cpu.h"
 
+// Cpu8080 has two interchangeable cores: the switch-based reference core and the table-driven
+// threaded core (Cpu8080Threaded.cpp), which is used by default. Build-time options:
+//   CPU8080_REFERENCE_CORE    - build the reference core only
+//   CPU8080_NO_COMPUTED_GOTO  - threaded core uses function pointer table instead of computed goto
+#if !defined(CPU8080_REFERENCE_CORE) && !defined(CPU8080_NO_COMPUTED_GOTO) && defined(__GNUC__)
+    #define CPU8080_COMPUTED_GOTO
+#endif
+
 
 typedef union {
     struct {
@@ -83,6 +91,12 @@ class Cpu8080 : public Cpu8080Compatible
         void reset() override;
         void operate() override;
 
+        bool setProperty(const std::string& propertyName, const EmuValuesList& values) override;
+        std::string getPropertyStringValue(const std::string& propertyName) override;
+
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
+
         void intRst(int vect) override;
         void ret() override;
 
@@ -118,12 +132,26 @@ class Cpu8080 : public Cpu8080Compatible
         static EmuObject* create(const EmuValuesList&) {return new Cpu8080();}
 
 private:
-        struct i8080 cpu;
+        struct i8080 cpu = {};
 
         void i8080_store_flags();
         void i8080_retrieve_flags();
         int i8080_execute(int opcode);
 
+        void operateOnce();
+        void operateInstrumented();
+
+#ifndef CPU8080_REFERENCE_CORE
+        bool m_threadedCore = true;
+
+        void operateThreaded();
+
+    #ifndef CPU8080_COMPUTED_GOTO
+        typedef int (Cpu8080::*OpHandler)();
+        template <int opcode> int threadedOp();
+    #endif
+#endif
+
         uint8_t m_statusWord;
         int m_iffPendingCnt = 0;
 };
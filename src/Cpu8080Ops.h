@@ -0,0 +1,1495 @@
+﻿/*
+ *  Emu80 v. 4.x
+ *  © Viktor Pykhonin <pyk@mail.ru>, 2016-2019
+ *
+ *  Based on i8080 core object model code by:
+ *  Alexander Demin <alexander@demin.ws> (https://github.com/begoon/i8080-core)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// i8080 instruction handlers for the threaded core.
+// This file is included by Cpu8080Threaded.cpp only, OP/NEXT/END_OP macros
+// turn each handler either into a computed goto label or into a separate function.
+
+OP(0x00)            /* nop */
+    NEXT(4);
+END_OP
+
+OP(0x01)            /* lxi b, data16 */
+    BC = RD_WORD(PC);
+    PC += 2;
+    NEXT(10);
+END_OP
+
+OP(0x02)            /* stax b */
+    WR_BYTE(BC, A);
+    NEXT(7);
+END_OP
+
+OP(0x03)            /* inx b */
+    BC++;
+    NEXT(5);
+END_OP
+
+OP(0x04)            /* inr b */
+    INR(B);
+    NEXT(5);
+END_OP
+
+OP(0x05)            /* dcr b */
+    DCR(B);
+    NEXT(5);
+END_OP
+
+OP(0x06)            /* mvi b, data8 */
+    B = RD_BYTE(PC++);
+    NEXT(7);
+END_OP
+
+OP(0x07)            /* rlc */
+    F = (F & ~F_CARRY) | (A >> 7);
+    A = (A << 1) | (A >> 7);
+    NEXT(4);
+END_OP
+
+OP(0x08)            /* nop, undocumented */
+    if (m_debugOnIllegalCmd) {
+        PC--;
+        g_emulation->debugRequest(this);
+        NEXT(0);
+    }
+    NEXT(4);
+END_OP
+
+OP(0x09)            /* dad b */
+    DAD(BC);
+    NEXT(10);
+END_OP
+
+OP(0x0A)            /* ldax b */
+    A = RD_BYTE(BC);
+    NEXT(7);
+END_OP
+
+OP(0x0B)            /* dcx b */
+    BC--;
+    NEXT(5);
+END_OP
+
+OP(0x0C)            /* inr c */
+    INR(C);
+    NEXT(5);
+END_OP
+
+OP(0x0D)            /* dcr c */
+    DCR(C);
+    NEXT(5);
+END_OP
+
+OP(0x0E)            /* mvi c, data8 */
+    C = RD_BYTE(PC++);
+    NEXT(7);
+END_OP
+
+OP(0x0F)            /* rrc */
+    F = (F & ~F_CARRY) | (A & 0x01);
+    A = (A >> 1) | (A << 7);
+    NEXT(4);
+END_OP
+
+OP(0x10)            /* nop, undocumented */
+    if (m_debugOnIllegalCmd) {
+        PC--;
+        g_emulation->debugRequest(this);
+        NEXT(0);
+    }
+    NEXT(4);
+END_OP
+
+OP(0x11)            /* lxi d, data16 */
+    DE = RD_WORD(PC);
+    PC += 2;
+    NEXT(10);
+END_OP
+
+OP(0x12)            /* stax d */
+    WR_BYTE(DE, A);
+    NEXT(7);
+END_OP
+
+OP(0x13)            /* inx d */
+    DE++;
+    NEXT(5);
+END_OP
+
+OP(0x14)            /* inr d */
+    INR(D);
+    NEXT(5);
+END_OP
+
+OP(0x15)            /* dcr d */
+    DCR(D);
+    NEXT(5);
+END_OP
+
+OP(0x16)            /* mvi d, data8 */
+    D = RD_BYTE(PC++);
+    NEXT(7);
+END_OP
+
+OP(0x17)            /* ral */
+    uint8_t work8 = F & F_CARRY;
+    F = (F & ~F_CARRY) | (A >> 7);
+    A = (A << 1) | work8;
+    NEXT(4);
+END_OP
+
+OP(0x18)            /* nop, undocumented */
+    if (m_debugOnIllegalCmd) {
+        PC--;
+        g_emulation->debugRequest(this);
+        NEXT(0);
+    }
+    NEXT(4);
+END_OP
+
+OP(0x19)            /* dad d */
+    DAD(DE);
+    NEXT(10);
+END_OP
+
+OP(0x1A)            /* ldax d */
+    A = RD_BYTE(DE);
+    NEXT(7);
+END_OP
+
+OP(0x1B)            /* dcx d */
+    DE--;
+    NEXT(5);
+END_OP
+
+OP(0x1C)            /* inr e */
+    INR(E);
+    NEXT(5);
+END_OP
+
+OP(0x1D)            /* dcr e */
+    DCR(E);
+    NEXT(5);
+END_OP
+
+OP(0x1E)            /* mvi e, data8 */
+    E = RD_BYTE(PC++);
+    NEXT(7);
+END_OP
+
+OP(0x1F)            /* rar */
+    uint8_t work8 = F & F_CARRY;
+    F = (F & ~F_CARRY) | (A & 0x01);
+    A = (A >> 1) | (work8 << 7);
+    NEXT(4);
+END_OP
+
+OP(0x20)            /* nop, undocumented */
+    if (m_debugOnIllegalCmd) {
+        PC--;
+        g_emulation->debugRequest(this);
+        NEXT(0);
+    }
+    NEXT(4);
+END_OP
+
+OP(0x21)            /* lxi h, data16 */
+    HL = RD_WORD(PC);
+    PC += 2;
+    NEXT(10);
+END_OP
+
+OP(0x22)            /* shld addr */
+    WR_WORD(RD_WORD(PC), HL);
+    PC += 2;
+    NEXT(16);
+END_OP
+
+OP(0x23)            /* inx h */
+    HL++;
+    NEXT(5);
+END_OP
+
+OP(0x24)            /* inr h */
+    INR(H);
+    NEXT(5);
+END_OP
+
+OP(0x25)            /* dcr h */
+    DCR(H);
+    NEXT(5);
+END_OP
+
+OP(0x26)            /* mvi h, data8 */
+    H = RD_BYTE(PC++);
+    NEXT(7);
+END_OP
+
+OP(0x27)            /* daa */
+    uint8_t carry = F & F_CARRY;
+    uint8_t add = 0;
+    if ((F & F_HCARRY) || (A & 0x0f) > 9)
+        add = 0x06;
+    if ((F & F_CARRY) || (A >> 4) > 9 || ((A >> 4) >= 9 && (A & 0x0f) > 9)) {
+        add |= 0x60;
+        carry = F_CARRY;
+    }
+    ADD(add);
+    F = (F & ~F_CARRY) | carry;
+    NEXT(4);
+END_OP
+
+OP(0x28)            /* nop, undocumented */
+    if (m_debugOnIllegalCmd) {
+        PC--;
+        g_emulation->debugRequest(this);
+        NEXT(0);
+    }
+    NEXT(4);
+END_OP
+
+OP(0x29)            /* dad hl */
+    DAD(HL);
+    NEXT(10);
+END_OP
+
+OP(0x2A)            /* ldhl addr */
+    HL = RD_WORD(RD_WORD(PC));
+    PC += 2;
+    NEXT(16);
+END_OP
+
+OP(0x2B)            /* dcx h */
+    HL--;
+    NEXT(5);
+END_OP
+
+OP(0x2C)            /* inr l */
+    INR(L);
+    NEXT(5);
+END_OP
+
+OP(0x2D)            /* dcr l */
+    DCR(L);
+    NEXT(5);
+END_OP
+
+OP(0x2E)            /* mvi l, data8 */
+    L = RD_BYTE(PC++);
+    NEXT(7);
+END_OP
+
+OP(0x2F)            /* cma */
+    A ^= 0xff;
+    NEXT(4);
+END_OP
+
+OP(0x30)            /* nop, undocumented */
+    if (m_debugOnIllegalCmd) {
+        PC--;
+        g_emulation->debugRequest(this);
+        NEXT(0);
+    }
+    NEXT(4);
+END_OP
+
+OP(0x31)            /* lxi sp, data16 */
+    SP = RD_WORD(PC);
+    PC += 2;
+    NEXT(10);
+END_OP
+
+OP(0x32)            /* sta addr */
+    WR_BYTE(RD_WORD(PC), A);
+    PC += 2;
+    NEXT(13);
+END_OP
+
+OP(0x33)            /* inx sp */
+    SP++;
+    NEXT(5);
+END_OP
+
+OP(0x34)            /* inr m */
+    uint8_t work8 = RD_BYTE(HL);
+    INR(work8);
+    WR_BYTE(HL, work8);
+    NEXT(10);
+END_OP
+
+OP(0x35)            /* dcr m */
+    uint8_t work8 = RD_BYTE(HL);
+    DCR(work8);
+    WR_BYTE(HL, work8);
+    NEXT(10);
+END_OP
+
+OP(0x36)            /* mvi m, data8 */
+    WR_BYTE(HL, RD_BYTE(PC++));
+    NEXT(10);
+END_OP
+
+OP(0x37)            /* stc */
+    F |= F_CARRY;
+    NEXT(4);
+END_OP
+
+OP(0x38)            /* nop, undocumented */
+    if (m_debugOnIllegalCmd) {
+        PC--;
+        g_emulation->debugRequest(this);
+        NEXT(0);
+    }
+    NEXT(4);
+END_OP
+
+OP(0x39)            /* dad sp */
+    DAD(SP);
+    NEXT(10);
+END_OP
+
+OP(0x3A)            /* lda addr */
+    A = RD_BYTE(RD_WORD(PC));
+    PC += 2;
+    NEXT(13);
+END_OP
+
+OP(0x3B)            /* dcx sp */
+    SP--;
+    NEXT(5);
+END_OP
+
+OP(0x3C)            /* inr a */
+    INR(A);
+    NEXT(5);
+END_OP
+
+OP(0x3D)            /* dcr a */
+    DCR(A);
+    NEXT(5);
+END_OP
+
+OP(0x3E)            /* mvi a, data8 */
+    A = RD_BYTE(PC++);
+    NEXT(7);
+END_OP
+
+OP(0x3F)            /* cmc */
+    F ^= F_CARRY;
+    NEXT(4);
+END_OP
+
+OP(0x40)            /* mov b, b */
+    NEXT(4);
+END_OP
+
+OP(0x41)            /* mov b, c */
+    B = C;
+    NEXT(5);
+END_OP
+
+OP(0x42)            /* mov b, d */
+    B = D;
+    NEXT(5);
+END_OP
+
+OP(0x43)            /* mov b, e */
+    B = E;
+    NEXT(5);
+END_OP
+
+OP(0x44)            /* mov b, h */
+    B = H;
+    NEXT(5);
+END_OP
+
+OP(0x45)            /* mov b, l */
+    B = L;
+    NEXT(5);
+END_OP
+
+OP(0x46)            /* mov b, m */
+    B = RD_BYTE(HL);
+    NEXT(7);
+END_OP
+
+OP(0x47)            /* mov b, a */
+    B = A;
+    NEXT(5);
+END_OP
+
+OP(0x48)            /* mov c, b */
+    C = B;
+    NEXT(5);
+END_OP
+
+OP(0x49)            /* mov c, c */
+    NEXT(5);
+END_OP
+
+OP(0x4A)            /* mov c, d */
+    C = D;
+    NEXT(5);
+END_OP
+
+OP(0x4B)            /* mov c, e */
+    C = E;
+    NEXT(5);
+END_OP
+
+OP(0x4C)            /* mov c, h */
+    C = H;
+    NEXT(5);
+END_OP
+
+OP(0x4D)            /* mov c, l */
+    C = L;
+    NEXT(5);
+END_OP
+
+OP(0x4E)            /* mov c, m */
+    C = RD_BYTE(HL);
+    NEXT(7);
+END_OP
+
+OP(0x4F)            /* mov c, a */
+    C = A;
+    NEXT(5);
+END_OP
+
+OP(0x50)            /* mov d, b */
+    D = B;
+    NEXT(5);
+END_OP
+
+OP(0x51)            /* mov d, c */
+    D = C;
+    NEXT(5);
+END_OP
+
+OP(0x52)            /* mov d, d */
+    NEXT(5);
+END_OP
+
+OP(0x53)            /* mov d, e */
+    D = E;
+    NEXT(5);
+END_OP
+
+OP(0x54)            /* mov d, h */
+    D = H;
+    NEXT(5);
+END_OP
+
+OP(0x55)            /* mov d, l */
+    D = L;
+    NEXT(5);
+END_OP
+
+OP(0x56)            /* mov d, m */
+    D = RD_BYTE(HL);
+    NEXT(7);
+END_OP
+
+OP(0x57)            /* mov d, a */
+    D = A;
+    NEXT(5);
+END_OP
+
+OP(0x58)            /* mov e, b */
+    E = B;
+    NEXT(5);
+END_OP
+
+OP(0x59)            /* mov e, c */
+    E = C;
+    NEXT(5);
+END_OP
+
+OP(0x5A)            /* mov e, d */
+    E = D;
+    NEXT(5);
+END_OP
+
+OP(0x5B)            /* mov e, e */
+    NEXT(5);
+END_OP
+
+OP(0x5C)            /* mov c, h */
+    E = H;
+    NEXT(5);
+END_OP
+
+OP(0x5D)            /* mov c, l */
+    E = L;
+    NEXT(5);
+END_OP
+
+OP(0x5E)            /* mov c, m */
+    E = RD_BYTE(HL);
+    NEXT(7);
+END_OP
+
+OP(0x5F)            /* mov c, a */
+    E = A;
+    NEXT(5);
+END_OP
+
+OP(0x60)            /* mov h, b */
+    H = B;
+    NEXT(5);
+END_OP
+
+OP(0x61)            /* mov h, c */
+    H = C;
+    NEXT(5);
+END_OP
+
+OP(0x62)            /* mov h, d */
+    H = D;
+    NEXT(5);
+END_OP
+
+OP(0x63)            /* mov h, e */
+    H = E;
+    NEXT(5);
+END_OP
+
+OP(0x64)            /* mov h, h */
+    NEXT(5);
+END_OP
+
+OP(0x65)            /* mov h, l */
+    H = L;
+    NEXT(5);
+END_OP
+
+OP(0x66)            /* mov h, m */
+    H = RD_BYTE(HL);
+    NEXT(7);
+END_OP
+
+OP(0x67)            /* mov h, a */
+    H = A;
+    NEXT(5);
+END_OP
+
+OP(0x68)            /* mov l, b */
+    L = B;
+    NEXT(5);
+END_OP
+
+OP(0x69)            /* mov l, c */
+    L = C;
+    NEXT(5);
+END_OP
+
+OP(0x6A)            /* mov l, d */
+    L = D;
+    NEXT(5);
+END_OP
+
+OP(0x6B)            /* mov l, e */
+    L = E;
+    NEXT(5);
+END_OP
+
+OP(0x6C)            /* mov l, h */
+    L = H;
+    NEXT(5);
+END_OP
+
+OP(0x6D)            /* mov l, l */
+    NEXT(5);
+END_OP
+
+OP(0x6E)            /* mov l, m */
+    L = RD_BYTE(HL);
+    NEXT(7);
+END_OP
+
+OP(0x6F)            /* mov l, a */
+    L = A;
+    NEXT(5);
+END_OP
+
+OP(0x70)            /* mov m, b */
+    WR_BYTE(HL, B);
+    NEXT(7);
+END_OP
+
+OP(0x71)            /* mov m, c */
+    WR_BYTE(HL, C);
+    NEXT(7);
+END_OP
+
+OP(0x72)            /* mov m, d */
+    WR_BYTE(HL, D);
+    NEXT(7);
+END_OP
+
+OP(0x73)            /* mov m, e */
+    WR_BYTE(HL, E);
+    NEXT(7);
+END_OP
+
+OP(0x74)            /* mov m, h */
+    WR_BYTE(HL, H);
+    NEXT(7);
+END_OP
+
+OP(0x75)            /* mov m, l */
+    WR_BYTE(HL, L);
+    NEXT(7);
+END_OP
+
+OP(0x76)            /* hlt */
+    PC--;
+    if (m_debugOnHalt)
+        g_emulation->debugRequest(this);
+    NEXT(4);
+END_OP
+
+OP(0x77)            /* mov m, a */
+    WR_BYTE(HL, A);
+    NEXT(7);
+END_OP
+
+OP(0x78)            /* mov a, b */
+    A = B;
+    NEXT(5);
+END_OP
+
+OP(0x79)            /* mov a, c */
+    A = C;
+    NEXT(5);
+END_OP
+
+OP(0x7A)            /* mov a, d */
+    A = D;
+    NEXT(5);
+END_OP
+
+OP(0x7B)            /* mov a, e */
+    A = E;
+    NEXT(5);
+END_OP
+
+OP(0x7C)            /* mov a, h */
+    A = H;
+    NEXT(5);
+END_OP
+
+OP(0x7D)            /* mov a, l */
+    A = L;
+    NEXT(5);
+END_OP
+
+OP(0x7E)            /* mov a, m */
+    A = RD_BYTE(HL);
+    NEXT(7);
+END_OP
+
+OP(0x7F)            /* mov a, a */
+    NEXT(5);
+END_OP
+
+OP(0x80)            /* add b */
+    ADD(B);
+    NEXT(4);
+END_OP
+
+OP(0x81)            /* add c */
+    ADD(C);
+    NEXT(4);
+END_OP
+
+OP(0x82)            /* add d */
+    ADD(D);
+    NEXT(4);
+END_OP
+
+OP(0x83)            /* add e */
+    ADD(E);
+    NEXT(4);
+END_OP
+
+OP(0x84)            /* add h */
+    ADD(H);
+    NEXT(4);
+END_OP
+
+OP(0x85)            /* add l */
+    ADD(L);
+    NEXT(4);
+END_OP
+
+OP(0x86)            /* add m */
+    uint8_t work8 = RD_BYTE(HL);
+    ADD(work8);
+    NEXT(7);
+END_OP
+
+OP(0x87)            /* add a */
+    ADD(A);
+    NEXT(4);
+END_OP
+
+OP(0x88)            /* adc b */
+    ADC(B);
+    NEXT(4);
+END_OP
+
+OP(0x89)            /* adc c */
+    ADC(C);
+    NEXT(4);
+END_OP
+
+OP(0x8A)            /* adc d */
+    ADC(D);
+    NEXT(4);
+END_OP
+
+OP(0x8B)            /* adc e */
+    ADC(E);
+    NEXT(4);
+END_OP
+
+OP(0x8C)            /* adc h */
+    ADC(H);
+    NEXT(4);
+END_OP
+
+OP(0x8D)            /* adc l */
+    ADC(L);
+    NEXT(4);
+END_OP
+
+OP(0x8E)            /* adc m */
+    uint8_t work8 = RD_BYTE(HL);
+    ADC(work8);
+    NEXT(7);
+END_OP
+
+OP(0x8F)            /* adc a */
+    ADC(A);
+    NEXT(4);
+END_OP
+
+OP(0x90)            /* sub b */
+    SUB(B);
+    NEXT(4);
+END_OP
+
+OP(0x91)            /* sub c */
+    SUB(C);
+    NEXT(4);
+END_OP
+
+OP(0x92)            /* sub d */
+    SUB(D);
+    NEXT(4);
+END_OP
+
+OP(0x93)            /* sub e */
+    SUB(E);
+    NEXT(4);
+END_OP
+
+OP(0x94)            /* sub h */
+    SUB(H);
+    NEXT(4);
+END_OP
+
+OP(0x95)            /* sub l */
+    SUB(L);
+    NEXT(4);
+END_OP
+
+OP(0x96)            /* sub m */
+    uint8_t work8 = RD_BYTE(HL);
+    SUB(work8);
+    NEXT(7);
+END_OP
+
+OP(0x97)            /* sub a */
+    SUB(A);
+    NEXT(4);
+END_OP
+
+OP(0x98)            /* sbb b */
+    SBB(B);
+    NEXT(4);
+END_OP
+
+OP(0x99)            /* sbb c */
+    SBB(C);
+    NEXT(4);
+END_OP
+
+OP(0x9A)            /* sbb d */
+    SBB(D);
+    NEXT(4);
+END_OP
+
+OP(0x9B)            /* sbb e */
+    SBB(E);
+    NEXT(4);
+END_OP
+
+OP(0x9C)            /* sbb h */
+    SBB(H);
+    NEXT(4);
+END_OP
+
+OP(0x9D)            /* sbb l */
+    SBB(L);
+    NEXT(4);
+END_OP
+
+OP(0x9E)            /* sbb m */
+    uint8_t work8 = RD_BYTE(HL);
+    SBB(work8);
+    NEXT(7);
+END_OP
+
+OP(0x9F)            /* sbb a */
+    SBB(A);
+    NEXT(4);
+END_OP
+
+OP(0xA0)            /* ana b */
+    ANA(B);
+    NEXT(4);
+END_OP
+
+OP(0xA1)            /* ana c */
+    ANA(C);
+    NEXT(4);
+END_OP
+
+OP(0xA2)            /* ana d */
+    ANA(D);
+    NEXT(4);
+END_OP
+
+OP(0xA3)            /* ana e */
+    ANA(E);
+    NEXT(4);
+END_OP
+
+OP(0xA4)            /* ana h */
+    ANA(H);
+    NEXT(4);
+END_OP
+
+OP(0xA5)            /* ana l */
+    ANA(L);
+    NEXT(4);
+END_OP
+
+OP(0xA6)            /* ana m */
+    uint8_t work8 = RD_BYTE(HL);
+    ANA(work8);
+    NEXT(7);
+END_OP
+
+OP(0xA7)            /* ana a */
+    ANA(A);
+    NEXT(4);
+END_OP
+
+OP(0xA8)            /* xra b */
+    XRA(B);
+    NEXT(4);
+END_OP
+
+OP(0xA9)            /* xra c */
+    XRA(C);
+    NEXT(4);
+END_OP
+
+OP(0xAA)            /* xra d */
+    XRA(D);
+    NEXT(4);
+END_OP
+
+OP(0xAB)            /* xra e */
+    XRA(E);
+    NEXT(4);
+END_OP
+
+OP(0xAC)            /* xra h */
+    XRA(H);
+    NEXT(4);
+END_OP
+
+OP(0xAD)            /* xra l */
+    XRA(L);
+    NEXT(4);
+END_OP
+
+OP(0xAE)            /* xra m */
+    uint8_t work8 = RD_BYTE(HL);
+    XRA(work8);
+    NEXT(7);
+END_OP
+
+OP(0xAF)            /* xra a */
+    XRA(A);
+    NEXT(4);
+END_OP
+
+OP(0xB0)            /* ora b */
+    ORA(B);
+    NEXT(4);
+END_OP
+
+OP(0xB1)            /* ora c */
+    ORA(C);
+    NEXT(4);
+END_OP
+
+OP(0xB2)            /* ora d */
+    ORA(D);
+    NEXT(4);
+END_OP
+
+OP(0xB3)            /* ora e */
+    ORA(E);
+    NEXT(4);
+END_OP
+
+OP(0xB4)            /* ora h */
+    ORA(H);
+    NEXT(4);
+END_OP
+
+OP(0xB5)            /* ora l */
+    ORA(L);
+    NEXT(4);
+END_OP
+
+OP(0xB6)            /* ora m */
+    uint8_t work8 = RD_BYTE(HL);
+    ORA(work8);
+    NEXT(7);
+END_OP
+
+OP(0xB7)            /* ora a */
+    ORA(A);
+    NEXT(4);
+END_OP
+
+OP(0xB8)            /* cmp b */
+    CMP(B);
+    NEXT(4);
+END_OP
+
+OP(0xB9)            /* cmp c */
+    CMP(C);
+    NEXT(4);
+END_OP
+
+OP(0xBA)            /* cmp d */
+    CMP(D);
+    NEXT(4);
+END_OP
+
+OP(0xBB)            /* cmp e */
+    CMP(E);
+    NEXT(4);
+END_OP
+
+OP(0xBC)            /* cmp h */
+    CMP(H);
+    NEXT(4);
+END_OP
+
+OP(0xBD)            /* cmp l */
+    CMP(L);
+    NEXT(4);
+END_OP
+
+OP(0xBE)            /* cmp m */
+    uint8_t work8 = RD_BYTE(HL);
+    CMP(work8);
+    NEXT(7);
+END_OP
+
+OP(0xBF)            /* cmp a */
+    CMP(A);
+    NEXT(4);
+END_OP
+
+OP(0xC0)            /* rnz */
+    if (!TST(F_ZERO)) {
+        POP(PC);
+        NEXT(11);
+    }
+    NEXT(5);
+END_OP
+
+OP(0xC1)            /* pop b */
+    POP(BC);
+    NEXT(10);
+END_OP
+
+OP(0xC2)            /* jnz addr */
+    if (!TST(F_ZERO)) {
+        PC = RD_WORD(PC);
+    }
+    else {
+        PC += 2;
+    }
+    NEXT(10);
+END_OP
+
+OP(0xC3)            /* jmp addr */
+    PC = RD_WORD(PC);
+    NEXT(10);
+END_OP
+
+OP(0xC4)            /* cnz addr */
+    if (!TST(F_ZERO)) {
+        CALL;
+        NEXT(17);
+    }
+    PC += 2;
+    NEXT(11);
+END_OP
+
+OP(0xC5)            /* push b */
+    PUSH(BC);
+    NEXT(11);
+END_OP
+
+OP(0xC6)            /* adi data8 */
+    uint8_t work8 = RD_BYTE(PC++);
+    ADD(work8);
+    NEXT(7);
+END_OP
+
+OP(0xC7)            /* rst 0 */
+    RST(0x0000);
+    NEXT(11);
+END_OP
+
+OP(0xC8)            /* rz */
+    if (TST(F_ZERO)) {
+        POP(PC);
+        NEXT(11);
+    }
+    NEXT(5);
+END_OP
+
+OP(0xC9)            /* ret */
+    POP(PC);
+    NEXT(10);
+END_OP
+
+OP(0xCA)            /* jz addr */
+    if (TST(F_ZERO)) {
+        PC = RD_WORD(PC);
+    } else {
+        PC += 2;
+    }
+    NEXT(10);
+END_OP
+
+OP(0xCB)            /* jmp addr, undocumented */
+    if (m_debugOnIllegalCmd) {
+        PC--;
+        g_emulation->debugRequest(this);
+        NEXT(0);
+    }
+    PC = RD_WORD(PC);
+    NEXT(10);
+END_OP
+
+OP(0xCC)            /* cz addr */
+    if (TST(F_ZERO)) {
+        CALL;
+        NEXT(17);
+    }
+    PC += 2;
+    NEXT(11);
+END_OP
+
+OP(0xCD)            /* call addr */
+    CALL;
+    NEXT(17);
+END_OP
+
+OP(0xCE)            /* aci data8 */
+    uint8_t work8 = RD_BYTE(PC++);
+    ADC(work8);
+    NEXT(7);
+END_OP
+
+OP(0xCF)            /* rst 1 */
+    RST(0x0008);
+    NEXT(11);
+END_OP
+
+OP(0xD0)            /* rnc */
+    if (!TST(F_CARRY)) {
+        POP(PC);
+        NEXT(11);
+    }
+    NEXT(5);
+END_OP
+
+OP(0xD1)            /* pop d */
+    POP(DE);
+    NEXT(10);
+END_OP
+
+OP(0xD2)            /* jnc addr */
+    if (!TST(F_CARRY)) {
+        PC = RD_WORD(PC);
+    } else {
+        PC += 2;
+    }
+    NEXT(10);
+END_OP
+
+OP(0xD3)            /* out port8 */
+    io_output(RD_BYTE(PC++), A);
+    NEXT(10);
+END_OP
+
+OP(0xD4)            /* cnc addr */
+    if (!TST(F_CARRY)) {
+        CALL;
+        NEXT(17);
+    }
+    PC += 2;
+    NEXT(11);
+END_OP
+
+OP(0xD5)            /* push d */
+    PUSH(DE);
+    NEXT(11);
+END_OP
+
+OP(0xD6)            /* sui data8 */
+    uint8_t work8 = RD_BYTE(PC++);
+    SUB(work8);
+    NEXT(7);
+END_OP
+
+OP(0xD7)            /* rst 2 */
+    RST(0x0010);
+    NEXT(11);
+END_OP
+
+OP(0xD8)            /* rc */
+    if (TST(F_CARRY)) {
+        POP(PC);
+        NEXT(11);
+    }
+    NEXT(5);
+END_OP
+
+OP(0xD9)            /* ret, undocumented */
+    if (m_debugOnIllegalCmd) {
+        PC--;
+        g_emulation->debugRequest(this);
+        NEXT(0);
+    }
+    POP(PC);
+    NEXT(10);
+END_OP
+
+OP(0xDA)            /* jc addr */
+    if (TST(F_CARRY)) {
+        PC = RD_WORD(PC);
+    } else {
+        PC += 2;
+    }
+    NEXT(10);
+END_OP
+
+OP(0xDB)            /* in port8 */
+    m_statusWord = 0x42;
+    A = io_input(RD_BYTE(PC++));
+    NEXT(10);
+END_OP
+
+OP(0xDC)            /* cc addr */
+    if (TST(F_CARRY)) {
+        CALL;
+        NEXT(17);
+    }
+    PC += 2;
+    NEXT(11);
+END_OP
+
+OP(0xDD)            /* call, undocumented */
+    if (m_debugOnIllegalCmd) {
+        PC--;
+        g_emulation->debugRequest(this);
+        NEXT(0);
+    }
+    CALL;
+    NEXT(17);
+END_OP
+
+OP(0xDE)            /* sbi data8 */
+    uint8_t work8 = RD_BYTE(PC++);
+    SBB(work8);
+    NEXT(7);
+END_OP
+
+OP(0xDF)            /* rst 3 */
+    RST(0x0018);
+    NEXT(11);
+END_OP
+
+OP(0xE0)            /* rpo */
+    if (!TST(F_PARITY)) {
+        POP(PC);
+        NEXT(11);
+    }
+    NEXT(5);
+END_OP
+
+OP(0xE1)            /* pop h */
+    POP(HL);
+    NEXT(10);
+END_OP
+
+OP(0xE2)            /* jpo addr */
+    if (!TST(F_PARITY)) {
+        PC = RD_WORD(PC);
+    }
+    else {
+        PC += 2;
+    }
+    NEXT(10);
+END_OP
+
+OP(0xE3)            /* xthl */
+    m_statusWord = 0x86;
+    uint16_t work16 = RD_WORD(SP);
+    m_statusWord = 0x84;
+    WR_WORD(SP, HL);
+    HL = work16;
+    NEXT(18);
+END_OP
+
+OP(0xE4)            /* cpo addr */
+    if (!TST(F_PARITY)) {
+        CALL;
+        NEXT(17);
+    }
+    PC += 2;
+    NEXT(11);
+END_OP
+
+OP(0xE5)            /* push h */
+    PUSH(HL);
+    NEXT(11);
+END_OP
+
+OP(0xE6)            /* ani data8 */
+    uint8_t work8 = RD_BYTE(PC++);
+    ANA(work8);
+    NEXT(7);
+END_OP
+
+OP(0xE7)            /* rst 4 */
+    RST(0x0020);
+    NEXT(11);
+END_OP
+
+OP(0xE8)            /* rpe */
+    if (TST(F_PARITY)) {
+        POP(PC);
+        NEXT(11);
+    }
+    NEXT(5);
+END_OP
+
+OP(0xE9)            /* pchl */
+    PC = HL;
+    NEXT(5);
+END_OP
+
+OP(0xEA)            /* jpe addr */
+    if (TST(F_PARITY)) {
+        PC = RD_WORD(PC);
+    } else {
+        PC += 2;
+    }
+    NEXT(10);
+END_OP
+
+OP(0xEB)            /* xchg */
+    uint16_t work16 = DE;
+    DE = HL;
+    HL = work16;
+    NEXT(4);
+END_OP
+
+OP(0xEC)            /* cpe addr */
+    if (TST(F_PARITY)) {
+        CALL;
+        NEXT(17);
+    }
+    PC += 2;
+    NEXT(11);
+END_OP
+
+OP(0xED)            /* call, undocumented */
+    if (m_debugOnIllegalCmd) {
+        PC--;
+        g_emulation->debugRequest(this);
+        NEXT(0);
+    }
+    CALL;
+    NEXT(17);
+END_OP
+
+OP(0xEE)            /* xri data8 */
+    uint8_t work8 = RD_BYTE(PC++);
+    XRA(work8);
+    NEXT(7);
+END_OP
+
+OP(0xEF)            /* rst 5 */
+    RST(0x0028);
+    NEXT(11);
+END_OP
+
+OP(0xF0)            /* rp */
+    if (!TST(F_NEG)) {
+        POP(PC);
+        NEXT(11);
+    }
+    NEXT(5);
+END_OP
+
+OP(0xF1)            /* pop psw */
+    POP(AF);
+    F = (F & ~(F_UN3 | F_UN5)) | F_UN1;
+    NEXT(10);
+END_OP
+
+OP(0xF2)            /* jp addr */
+    if (!TST(F_NEG)) {
+        PC = RD_WORD(PC);
+    } else {
+        PC += 2;
+    }
+    NEXT(10);
+END_OP
+
+OP(0xF3)            /* di */
+    IFF = 0;
+    m_core->inte(false);
+    NEXT(4);
+END_OP
+
+OP(0xF4)            /* cp addr */
+    if (!TST(F_NEG)) {
+        CALL;
+        NEXT(17);
+    }
+    PC += 2;
+    NEXT(11);
+END_OP
+
+OP(0xF5)            /* push psw */
+    PUSH(AF);
+    NEXT(11);
+END_OP
+
+OP(0xF6)            /* ori data8 */
+    uint8_t work8 = RD_BYTE(PC++);
+    ORA(work8);
+    NEXT(7);
+END_OP
+
+OP(0xF7)            /* rst 6 */
+    RST(0x0030);
+    NEXT(11);
+END_OP
+
+OP(0xF8)            /* rm */
+    if (TST(F_NEG)) {
+        POP(PC);
+        NEXT(11);
+    }
+    NEXT(5);
+END_OP
+
+OP(0xF9)            /* sphl */
+    SP = HL;
+    NEXT(5);
+END_OP
+
+OP(0xFA)            /* jm addr */
+    if (TST(F_NEG)) {
+        PC = RD_WORD(PC);
+    } else {
+        PC += 2;
+    }
+    NEXT(10);
+END_OP
+
+OP(0xFB)            /* ei */
+    m_iffPendingCnt = 2;
+    IFF = 0;             // interrupts are disabled internally during the EI instruction
+    m_core->inte(true);  // whereas INTE is already active
+    NEXT(4);
+END_OP
+
+OP(0xFC)            /* cm addr */
+    if (TST(F_NEG)) {
+        CALL;
+        NEXT(17);
+    }
+    PC += 2;
+    NEXT(11);
+END_OP
+
+OP(0xFD)            /* call, undocumented */
+    if (m_debugOnIllegalCmd) {
+        PC--;
+        g_emulation->debugRequest(this);
+        NEXT(0);
+    }
+    CALL;
+    NEXT(17);
+END_OP
+
+OP(0xFE)            /* cpi data8 */
+    uint8_t work8 = RD_BYTE(PC++);
+    CMP(work8);
+    NEXT(7);
+END_OP
+
+OP(0xFF)            /* rst 7 */
+    RST(0x0038);
+    NEXT(11);
+END_OP
@@ -0,0 +1,294 @@
+﻿/*
+ *  Emu80 v. 4.x
+ *  © Viktor Pykhonin <pyk@mail.ru>, 2016-2019
+ *
+ *  Based on i8080 core object model code by:
+ *  Alexander Demin <alexander@demin.ws> (https://github.com/begoon/i8080-core)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Table-driven threaded i8080 core.
+// The reference switch-based core is Cpu8080::i8080_execute, this core must behave identically.
+// While the threaded core is running, flags are kept in F register rather than in cpu.f,
+// so cpu.f is synchronized before anything outside the core may access it (hooks, debugger).
+
+#include "Cpu8080.h"
+
+#ifndef CPU8080_REFERENCE_CORE
+
+#include "Cpu.h"
+#include "CpuHook.h"
+#include "CpuWaits.h"
+#include "PlatformCore.h"
+#include "Emulation.h"
+
+using namespace std;
+
+// Cpu8080 threaded core types and macroses
+
+#define RD_BYTE(addr) (readMem(addr))
+#define RD_WORD(addr) ((RD_BYTE((addr+1) & 0xFFFF) << 8) | RD_BYTE(addr))
+
+#define WR_BYTE(addr, value) writeMem(addr, value)
+#define WR_WORD(addr, value) WR_BYTE(addr, value & 0xff);WR_BYTE((addr + 1) & 0xFFFF, (value >> 8) & 0xff);
+
+#define AF              cpu.af.w
+#define BC              cpu.bc.w
+#define DE              cpu.de.w
+#define HL              cpu.hl.w
+#define SP              cpu.sp.w
+#define PC              cpu.pc.w
+#define A               cpu.af.b.h
+#define F               cpu.af.b.l
+#define B               cpu.bc.b.h
+#define C               cpu.bc.b.l
+#define D               cpu.de.b.h
+#define E               cpu.de.b.l
+#define H               cpu.hl.b.h
+#define L               cpu.hl.b.l
+#define IFF             cpu.iff
+
+#define F_CARRY         0x01
+#define F_UN1           0x02
+#define F_PARITY        0x04
+#define F_UN3           0x08
+#define F_HCARRY        0x10
+#define F_UN5           0x20
+#define F_ZERO          0x40
+#define F_NEG           0x80
+
+#define TST(flag)       (F & (flag))
+
+#define POP(reg)        { m_statusWord = 0x86; (reg) = RD_WORD(SP); SP += 2; }
+#define PUSH(reg)       { m_statusWord = 0x84; SP -= 2; WR_WORD(SP, (reg)); }
+
+// half carry index is built from bit 3 of the operand, the argument and the result
+#define HC_INDEX(op, val, res) ((((op) & 0x88) >> 1) | (((val) & 0x88) >> 2) | (((res) & 0x88) >> 3)) & 0x7
+
+#define INR(reg) \
+{                                               \
+    ++(reg);                                    \
+    F = (F & F_CARRY) | inr_flags[(reg)];       \
+}
+
+#define DCR(reg) \
+{                                               \
+    --(reg);                                    \
+    F = (F & F_CARRY) | dcr_flags[(reg)];       \
+}
+
+#define ADD(val) \
+{                                               \
+    uint16_t res = (uint16_t)A + (val);         \
+    F = szp_flags[res & 0xff] |                 \
+        add_half_carry_flags[HC_INDEX(A, (val), res)] | \
+        (res >> 8);                             \
+    A = res & 0xff;                             \
+}
+
+#define ADC(val) \
+{                                               \
+    uint16_t res = (uint16_t)A + (val) + (F & F_CARRY); \
+    F = szp_flags[res & 0xff] |                 \
+        add_half_carry_flags[HC_INDEX(A, (val), res)] | \
+        (res >> 8);                             \
+    A = res & 0xff;                             \
+}
+
+#define SUB(val) \
+{                                               \
+    uint16_t res = (uint16_t)A - (val);         \
+    F = szp_flags[res & 0xff] |                 \
+        sub_half_carry_flags[HC_INDEX(A, (val), res)] | \
+        ((res >> 8) & F_CARRY);                 \
+    A = res & 0xff;                             \
+}
+
+#define SBB(val) \
+{                                               \
+    uint16_t res = (uint16_t)A - (val) - (F & F_CARRY); \
+    F = szp_flags[res & 0xff] |                 \
+        sub_half_carry_flags[HC_INDEX(A, (val), res)] | \
+        ((res >> 8) & F_CARRY);                 \
+    A = res & 0xff;                             \
+}
+
+#define CMP(val) \
+{                                               \
+    uint16_t res = (uint16_t)A - (val);         \
+    F = szp_flags[res & 0xff] |                 \
+        sub_half_carry_flags[HC_INDEX(A, (val), res)] | \
+        ((res >> 8) & F_CARRY);                 \
+}
+
+#define ANA(val) \
+{                                               \
+    uint8_t hc = ((A | (val)) & 0x08) << 1;     \
+    A &= (val);                                 \
+    F = szp_flags[A] | hc;                      \
+}
+
+#define XRA(val) \
+{                                               \
+    A ^= (val);                                 \
+    F = szp_flags[A];                           \
+}
+
+#define ORA(val) \
+{                                               \
+    A |= (val);                                 \
+    F = szp_flags[A];                           \
+}
+
+#define DAD(reg) \
+{                                               \
+    uint32_t res = (uint32_t)HL + (reg);        \
+    HL = res & 0xffff;                          \
+    F = (F & ~F_CARRY) | (res >> 16);           \
+}
+
+#define CALL \
+{                                               \
+    PUSH(PC + 2);                               \
+    PC = RD_WORD(PC);                           \
+}
+
+#define RST(addr) \
+{                                               \
+    PUSH(PC);                                   \
+    PC = (addr);                                \
+}
+
+
+// Flag lookup tables: F register values for 8-bit results (bit 1 is always set)
+
+static uint8_t szp_flags[256]; // sign, zero and parity
+static uint8_t inr_flags[256]; // sign, zero, parity and half carry after increment
+static uint8_t dcr_flags[256]; // sign, zero, parity and half carry after decrement
+
+// half carry by HC_INDEX
+static const uint8_t add_half_carry_flags[] = { 0, 0, F_HCARRY, 0, F_HCARRY, 0, F_HCARRY, F_HCARRY };
+static const uint8_t sub_half_carry_flags[] = { F_HCARRY, 0, 0, 0, F_HCARRY, F_HCARRY, F_HCARRY, 0 };
+
+static bool initFlagTables()
+{
+    for (int i = 0; i < 256; i++) {
+        szp_flags[i] = (i & F_NEG) | (i == 0 ? F_ZERO : 0) | (parity_table[i] ? F_PARITY : 0) | F_UN1;
+        inr_flags[i] = szp_flags[i] | ((i & 0x0f) == 0 ? F_HCARRY : 0);
+        dcr_flags[i] = szp_flags[i] | ((i & 0x0f) != 0x0f ? F_HCARRY : 0);
+    }
+    return true;
+}
+
+static bool flagTablesInitialized = initFlagTables();
+
+
+// Handler wrappers
+
+#ifdef CPU8080_COMPUTED_GOTO
+
+#define OP(opcode)      op_##opcode: {
+#define NEXT(cycles)    { clocks = (cycles); goto opDone; }
+#define END_OP          }
+
+#define OP_ADDR(opcode) &&op_##opcode
+
+#else
+
+#define OP(opcode)      template<> int Cpu8080::threadedOp<opcode>() {
+#define NEXT(cycles)    return (cycles)
+#define END_OP          }
+
+#define OP_ADDR(opcode) &Cpu8080::threadedOp<opcode>
+
+#include "Cpu8080Ops.h"
+
+#endif // CPU8080_COMPUTED_GOTO
+
+#define OP_ROW(h) OP_ADDR(h##0), OP_ADDR(h##1), OP_ADDR(h##2), OP_ADDR(h##3), \
+                  OP_ADDR(h##4), OP_ADDR(h##5), OP_ADDR(h##6), OP_ADDR(h##7), \
+                  OP_ADDR(h##8), OP_ADDR(h##9), OP_ADDR(h##A), OP_ADDR(h##B), \
+                  OP_ADDR(h##C), OP_ADDR(h##D), OP_ADDR(h##E), OP_ADDR(h##F)
+
+#define OP_TABLE OP_ROW(0x0), OP_ROW(0x1), OP_ROW(0x2), OP_ROW(0x3), \
+                 OP_ROW(0x4), OP_ROW(0x5), OP_ROW(0x6), OP_ROW(0x7), \
+                 OP_ROW(0x8), OP_ROW(0x9), OP_ROW(0xA), OP_ROW(0xB), \
+                 OP_ROW(0xC), OP_ROW(0xD), OP_ROW(0xE), OP_ROW(0xF)
+
+
+// Executes instructions until another device is due, same as operateOnce() loop in reference core
+void Cpu8080::operateThreaded()
+{
+#ifdef CPU8080_COMPUTED_GOTO
+    static void* const dispatchTable[256] = { OP_TABLE };
+#else
+    static const OpHandler dispatchTable[256] = { OP_TABLE };
+#endif
+
+    i8080_store_flags();
+
+    do {
+        if (!m_hooksDisabled) {
+            list<CpuHook*>* hookList = getHooks(PC);
+            if (hookList) {
+                bool retFlag = false;
+                i8080_retrieve_flags();
+                for (auto it = hookList->begin(); it != hookList->end(); it++)
+                    retFlag = retFlag || (*it)->hookProc();
+                i8080_store_flags();
+                if (retFlag)
+                    continue;
+            }
+        }
+
+        int tag = 0;
+        int opcode = m_waits ? m_addrSpace->readByteEx(PC++, tag) : RD_BYTE(PC++);
+        int clocks;
+
+        m_statusWord = 0x82;
+
+#ifdef CPU8080_COMPUTED_GOTO
+        goto *dispatchTable[opcode];
+
+#include "Cpu8080Ops.h"
+
+opDone:
+#else
+        clocks = (this->*dispatchTable[opcode])();
+#endif
+
+        if (m_iffPendingCnt)
+            if (!--m_iffPendingCnt) {
+                IFF = 1;
+                m_core->inte(true);
+            }
+
+        m_statusWord = 0xA2;
+
+        if (m_waits)
+            clocks += m_waits->getCpuWaitStates(tag, opcode, clocks);
+        m_curClock += m_kDiv * clocks;
+        m_instrCount++;
+
+        if (m_stepReq) {
+            m_stepReq = false;
+            g_emulation->debugRequest(this);
+        }
+    } while (g_emulation->continueBatch(this));
+
+    i8080_retrieve_flags();
+}
+
+#endif // !CPU8080_REFERENCE_CORE
@@ -0,0 +1,126 @@
+﻿/*
+ *  Emu80 v. 4.x
+ *  © Viktor Pykhonin <pyk@mail.ru>, 2016-2019
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <algorithm>
+
+#include "CpuProfiler.h"
+#include "Cpu.h"
+#include "Cpu8080dasm.h"
+#include "CpuZ80dasm.h"
+#include "Emulation.h"
+
+using namespace std;
+
+
+CpuProfiler::CpuProfiler(Cpu8080Compatible* cpu)
+{
+    m_cpu = cpu;
+}
+
+
+void CpuProfiler::reset()
+{
+    m_banks.clear();
+}
+
+
+vector<CpuProfiler::PcStats>& CpuProfiler::allocBank(unsigned bank)
+{
+    if (bank >= m_banks.size())
+        m_banks.resize(bank + 1);
+    m_banks[bank].assign(0x10000, PcStats());
+    return m_banks[bank];
+}
+
+
+// Memory is read without side effects only, so code in I/O areas is shown as "?"
+string CpuProfiler::getInstructionMnemonic(uint16_t addr)
+{
+    AddressableDevice* as = m_cpu->getAddrSpace();
+
+    uint8_t buf[4];
+    for (int i = 0; i < 4; i++) {
+        uint16_t byteAddr = addr + i;
+        uint8_t* page = as->getDirectPagePtr(byteAddr & 0xFF00, false);
+        if (!page)
+            return "?";
+        buf[i] = page[byteAddr & 0xFF];
+    }
+
+    const DebuggerOptions& options = g_emulation->getDebuggerOptions();
+    string mnemo;
+    if (m_cpu->getType() == Cpu::CPU_8080) {
+        mnemo = i8080GetInstructionMnemonic(buf);
+        if (!options.mnemo8080UpperCase)
+            transform(mnemo.begin(), mnemo.end(), mnemo.begin(), ::tolower);
+    } else {
+        unsigned length;
+        STEP_FLAG flag;
+        mnemo = cpu_disassemble_z80(addr, buf, length, flag);
+        if (options.mnemoZ80UpperCase)
+            transform(mnemo.begin(), mnemo.end(), mnemo.begin(), ::toupper);
+    }
+    return mnemo;
+}
+
+
+bool CpuProfiler::writeReport(const string& fileName)
+{
+    struct HotSpot {
+        unsigned bank;
+        uint16_t addr;
+        PcStats stats;
+    };
+
+    vector<HotSpot> hotSpots;
+    uint64_t totalClocks = 0;
+    uint64_t totalCount = 0;
+
+    for (unsigned bank = 0; bank < m_banks.size(); bank++)
+        for (unsigned addr = 0; addr < m_banks[bank].size(); addr++) {
+            const PcStats& stats = m_banks[bank][addr];
+            if (!stats.count)
+                continue;
+            hotSpots.push_back({bank, uint16_t(addr), stats});
+            totalClocks += stats.clocks;
+            totalCount += stats.count;
+        }
+
+    stable_sort(hotSpots.begin(), hotSpots.end(), [](const HotSpot& a, const HotSpot& b) {return a.stats.clocks > b.stats.clocks;});
+
+    FILE* file = fopen(fileName.c_str(), "w");
+    if (!file)
+        return false;
+
+    fprintf(file, "; total: %llu clocks, %llu instructions\n", (unsigned long long)totalClocks, (unsigned long long)totalCount);
+    if (m_mapper)
+        fprintf(file, "; disassembly is shown for the current memory mapping\n");
+    fprintf(file, "%saddr%13s%7s%13s  %s\n", m_mapper ? "bank:" : "", "clocks", "%", "count", "mnemonic");
+
+    for (auto it = hotSpots.begin(); it != hotSpots.end(); it++) {
+        if (m_mapper)
+            fprintf(file, "%04X:", it->bank);
+        fprintf(file, "%04X %12llu %6.2f %12llu  %s\n", it->addr, (unsigned long long)it->stats.clocks,
+                totalClocks ? double(it->stats.clocks) * 100 / totalClocks : 0.,
+                (unsigned long long)it->stats.count, getInstructionMnemonic(it->addr).c_str());
+    }
+
+    fclose(file);
+    return true;
+}
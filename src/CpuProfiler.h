@@ -0,0 +1,73 @@
+﻿/*
+ *  Emu80 v. 4.x
+ *  © Viktor Pykhonin <pyk@mail.ru>, 2016-2019
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+// Sampling profiler for emulated code
+
+#ifndef CPUPROFILER_H
+#define CPUPROFILER_H
+
+#include <string>
+#include <vector>
+
+#include "AddrSpace.h"
+
+
+class Cpu8080Compatible;
+
+
+// Accumulates clocks and executed instruction counts per PC. If a bank mapper is attached,
+// separate counters are kept for each of its pages.
+class CpuProfiler
+{
+    public:
+        CpuProfiler(Cpu8080Compatible* cpu);
+
+        void attachBankMapper(AddrSpaceMapper* mapper) {m_mapper = mapper;}
+        void reset();
+
+        inline void countInstruction(uint16_t pc, int clocks);
+
+        // writes hot spot report sorted by clocks, returns false on file error
+        bool writeReport(const std::string& fileName);
+
+    private:
+        struct PcStats {
+            uint64_t clocks;
+            uint64_t count;
+        };
+
+        Cpu8080Compatible* m_cpu;
+        AddrSpaceMapper* m_mapper = nullptr;
+
+        // 64K counters per bank, allocated on first use
+        std::vector<std::vector<PcStats>> m_banks;
+
+        std::vector<PcStats>& allocBank(unsigned bank);
+        std::string getInstructionMnemonic(uint16_t addr);
+};
+
+
+inline void CpuProfiler::countInstruction(uint16_t pc, int clocks)
+{
+    unsigned bank = m_mapper ? m_mapper->getCurPage() : 0;
+    PcStats& stats = (bank < m_banks.size() && !m_banks[bank].empty() ? m_banks[bank] : allocBank(bank))[pc];
+    stats.clocks += clocks;
+    stats.count++;
+}
+
+
+#endif // CPUPROFILER_H
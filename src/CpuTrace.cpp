@@ -0,0 +1,202 @@
+﻿/*
+ *  Emu80 v. 4.x
+ *  © Viktor Pykhonin <pyk@mail.ru>, 2016-2019
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "CpuTrace.h"
+#include "Cpu8080dasm.h"
+#include "CpuZ80dasm.h"
+
+using namespace std;
+
+
+// File format: header (signature, version, CPU type, number of records) followed by records,
+// all values are little endian
+static const char c_traceSignature[8] = {'E', 'M', 'U', '8', '0', 'T', 'R', 'C'};
+static const uint32_t c_traceVersion = 1;
+static const int c_traceHeaderSize = 20;
+static const int c_traceRecordSize = 24;
+
+
+static void put16(uint8_t*& ptr, uint16_t value)
+{
+    *ptr++ = value & 0xFF;
+    *ptr++ = value >> 8;
+}
+
+
+static void put32(uint8_t*& ptr, uint32_t value)
+{
+    put16(ptr, value & 0xFFFF);
+    put16(ptr, value >> 16);
+}
+
+
+static void put64(uint8_t*& ptr, uint64_t value)
+{
+    put32(ptr, value & 0xFFFFFFFF);
+    put32(ptr, value >> 32);
+}
+
+
+static uint16_t get16(const uint8_t*& ptr)
+{
+    uint16_t value = ptr[0] | (ptr[1] << 8);
+    ptr += 2;
+    return value;
+}
+
+
+static uint32_t get32(const uint8_t*& ptr)
+{
+    uint32_t value = get16(ptr);
+    return value | (uint32_t(get16(ptr)) << 16);
+}
+
+
+static uint64_t get64(const uint8_t*& ptr)
+{
+    uint64_t value = get32(ptr);
+    return value | (uint64_t(get32(ptr)) << 32);
+}
+
+
+CpuTracer::CpuTracer(bool z80, unsigned nRecords)
+{
+    m_z80 = z80;
+    setSize(nRecords);
+}
+
+
+void CpuTracer::clear()
+{
+    m_pos = 0;
+    m_isFull = false;
+}
+
+
+void CpuTracer::setSize(unsigned nRecords)
+{
+    m_records.resize(nRecords ? nRecords : 1);
+    clear();
+}
+
+
+bool CpuTracer::writeFile(const string& fileName)
+{
+    FILE* file = fopen(fileName.c_str(), "wb");
+    if (!file)
+        return false;
+
+    unsigned nRecords = m_isFull ? m_records.size() : m_pos;
+    unsigned first = m_isFull ? m_pos : 0;
+
+    uint8_t header[c_traceHeaderSize];
+    uint8_t* ptr = header;
+    memcpy(ptr, c_traceSignature, sizeof(c_traceSignature));
+    ptr += sizeof(c_traceSignature);
+    put32(ptr, c_traceVersion);
+    put32(ptr, m_z80 ? 1 : 0);
+    put32(ptr, nRecords);
+    bool ok = fwrite(header, c_traceHeaderSize, 1, file) == 1;
+
+    vector<uint8_t> buf(c_traceRecordSize * 4096);
+    for (unsigned i = 0; i < nRecords && ok; ) {
+        ptr = buf.data();
+        unsigned n = 0;
+        for (; n < 4096 && i < nRecords; n++, i++) {
+            const CpuTraceRecord& rec = m_records[(first + i) % m_records.size()];
+            put64(ptr, rec.clock);
+            put16(ptr, rec.pc);
+            put16(ptr, rec.af);
+            put16(ptr, rec.bc);
+            put16(ptr, rec.de);
+            put16(ptr, rec.hl);
+            put16(ptr, rec.sp);
+            memcpy(ptr, rec.opcode, 4);
+            ptr += 4;
+        }
+        ok = fwrite(buf.data(), c_traceRecordSize, n, file) == n;
+    }
+
+    fclose(file);
+    return ok;
+}
+
+
+bool decodeTraceFile(const string& fileName, FILE* out)
+{
+    FILE* file = fopen(fileName.c_str(), "rb");
+    if (!file)
+        return false;
+
+    uint8_t header[c_traceHeaderSize];
+    const uint8_t* ptr = header;
+    if (fread(header, c_traceHeaderSize, 1, file) != 1 || memcmp(header, c_traceSignature, sizeof(c_traceSignature))) {
+        fclose(file);
+        return false;
+    }
+    ptr += sizeof(c_traceSignature);
+    uint32_t version = get32(ptr);
+    bool z80 = get32(ptr) != 0;
+    uint32_t nRecords = get32(ptr);
+    if (version != c_traceVersion) {
+        fclose(file);
+        return false;
+    }
+
+    fprintf(out, "; %s trace, %u records\n", z80 ? "Z80" : "i8080", nRecords);
+
+    uint8_t buf[c_traceRecordSize];
+    for (uint32_t i = 0; i < nRecords; i++) {
+        if (fread(buf, c_traceRecordSize, 1, file) != 1) {
+            fclose(file);
+            return false;
+        }
+        ptr = buf;
+        CpuTraceRecord rec;
+        rec.clock = get64(ptr);
+        rec.pc = get16(ptr);
+        rec.af = get16(ptr);
+        rec.bc = get16(ptr);
+        rec.de = get16(ptr);
+        rec.hl = get16(ptr);
+        rec.sp = get16(ptr);
+        memcpy(rec.opcode, ptr, 4);
+
+        string mnemo;
+        unsigned length;
+        if (!z80) {
+            mnemo = i8080GetInstructionMnemonic(rec.opcode);
+            length = i8080GetInstructionLength(rec.opcode);
+        } else {
+            STEP_FLAG flag;
+            mnemo = cpu_disassemble_z80(rec.pc, rec.opcode, length, flag);
+        }
+
+        char bytes[12] = "";
+        for (unsigned j = 0; j < length && j < 4; j++)
+            sprintf(bytes + j * 3, "%02X ", rec.opcode[j]);
+
+        fprintf(out, "%12llu %04X: %-12s%-20s AF=%04X BC=%04X DE=%04X HL=%04X SP=%04X\n", (unsigned long long)rec.clock,
+                rec.pc, bytes, mnemo.c_str(), rec.af, rec.bc, rec.de, rec.hl, rec.sp);
+    }
+
+    fclose(file);
+    return true;
+}
@@ -0,0 +1,81 @@
+﻿/*
+ *  Emu80 v. 4.x
+ *  © Viktor Pykhonin <pyk@mail.ru>, 2016-2019
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+// Execution trace recorder
+
+#ifndef CPUTRACE_H
+#define CPUTRACE_H
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "EmuTypes.h"
+
+
+// CPU state before instruction execution
+struct CpuTraceRecord {
+    uint64_t clock;
+    uint16_t pc;
+    uint16_t af;
+    uint16_t bc;
+    uint16_t de;
+    uint16_t hl;
+    uint16_t sp;
+    uint8_t opcode[4];
+};
+
+
+// Fixed size ring of trace records, the oldest records are overwritten
+class CpuTracer
+{
+    public:
+        CpuTracer(bool z80, unsigned nRecords);
+
+        void clear();
+        void setSize(unsigned nRecords);
+
+        // record is filled in place and added to the trace by commitRecord()
+        inline CpuTraceRecord* getNextRecord() {return &m_records[m_pos];}
+        inline void commitRecord();
+
+        // writes records in chronological order, returns false on file error
+        bool writeFile(const std::string& fileName);
+
+    private:
+        bool m_z80;
+        std::vector<CpuTraceRecord> m_records;
+        unsigned m_pos = 0;
+        bool m_isFull = false;
+};
+
+
+inline void CpuTracer::commitRecord()
+{
+    if (++m_pos == m_records.size()) {
+        m_pos = 0;
+        m_isFull = true;
+    }
+}
+
+
+// Decodes trace file written by CpuTracer to text, returns false on file error
+bool decodeTraceFile(const std::string& fileName, FILE* out);
+
+
+#endif // CPUTRACE_H
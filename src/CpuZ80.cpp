@@ -23,15 +23,18 @@
 #include "CpuZ80.h"
 #include "CpuHook.h"
 #include "CpuWaits.h"
+#include "CpuProfiler.h"
+#include "CpuTrace.h"
 #include "Emulation.h"
 #include "PlatformCore.h"
+#include "Snapshot.h"
 
 using namespace std;
 
-#define GetBYTE(addr) (m_addrSpace->readByte(addr))
+#define GetBYTE(addr) (readMem(addr))
 #define GetWORD(addr) ((GetBYTE((addr+1) & 0xFFFF) << 8) | GetBYTE(addr))
 
-#define PutBYTE(addr, value) m_addrSpace->writeByte(addr, value)
+#define PutBYTE(addr, value) writeMem(addr, value)
 #define PutWORD(addr, value) PutBYTE(addr, value & 0xff);PutBYTE((addr + 1) & 0xFFFF, (value >> 8) & 0xff);
 
 #define PC pc
@@ -2543,11 +2546,11 @@ CpuZ80::CpuZ80()
 }*/
 
 
-void CpuZ80::operate()
+inline void CpuZ80::operateOnce()
 {
     if (!m_hooksDisabled) {
         bool retFlag = false;
-        list<CpuHook*>* hookList = m_hookArray[PC];
+        list<CpuHook*>* hookList = getHooks(PC);
         if (hookList) {
             for (auto it = hookList->begin(); it != hookList->end(); it++)
                 retFlag = retFlag || (*it)->hookProc();
@@ -2563,6 +2566,7 @@ void CpuZ80::operate()
         m_curClock += m_kDiv * (clocks + m_waits->getCpuWaitStates(tag, opcode, clocks));
     } else
         m_curClock += m_kDiv * simz80();
+    m_instrCount++;
 
     if (m_stepReq) {
         m_stepReq = false;
@@ -2571,6 +2575,53 @@ void CpuZ80::operate()
 }
 
 
+// Executes instructions until another device is due
+void CpuZ80::operate()
+{
+    if (m_profiling || m_tracing) {
+        operateInstrumented();
+        return;
+    }
+
+    do
+        operateOnce();
+    while (g_emulation->continueBatch(this));
+}
+
+
+// Profiling and tracing: instruction by instruction with state recording
+void CpuZ80::operateInstrumented()
+{
+    do {
+        uint16_t addr = PC;
+        uint64_t clock = m_curClock;
+        uint64_t instrCount = m_instrCount;
+        bool tracing = m_tracing;
+
+        if (tracing) {
+            CpuTraceRecord* rec = m_tracer->getNextRecord();
+            rec->clock = clock;
+            rec->pc = addr;
+            rec->af = AF;
+            rec->bc = BC;
+            rec->de = DE;
+            rec->hl = HL;
+            rec->sp = SP;
+            peekInstruction(addr, rec->opcode);
+        }
+
+        operateOnce();
+
+        if (m_instrCount != instrCount) { // not skipped by hook
+            if (m_profiling)
+                m_profiler->countInstruction(addr, (m_curClock - clock) / m_kDiv);
+            if (tracing)
+                m_tracer->commitRecord();
+        }
+    } while (g_emulation->continueBatch(this));
+}
+
+
 void CpuZ80::reset() {
     af_sel = 0;
     regs_sel = 0;
@@ -2604,7 +2655,7 @@ void CpuZ80::intRst(int vect)
         m_core->inte(false);
         if (GetBYTE(PC) == 0x76) {
             PC++;
-            m_curClock = g_emulation->getCurClock();
+            syncronize();
         }
         PUSH(PC); PC = vect * 8;
         m_stackOperation = false;
@@ -2729,6 +2780,11 @@ uint8_t CpuZ80::getR() {
 }
 
 
+uint16_t CpuZ80::getIR() {
+    return ir;
+}
+
+
 uint8_t CpuZ80::getIFF() {
     return IFF;
 }
@@ -2770,7 +2826,59 @@ void CpuZ80::setIY(uint16_t value)
 }
 
 
+void CpuZ80::setIR(uint16_t value)
+{
+    ir = value;
+}
+
+
 void CpuZ80::setIFF(bool iff)
 {
     IFF = iff ? 3 : 0;
 }
+
+
+void CpuZ80::saveState(SnapshotWriter& writer)
+{
+    saveClockState(writer);
+    for (int i = 0; i < 2; i++) {
+        writer.write16(af[i]);
+        writer.write16(regs[i].bc);
+        writer.write16(regs[i].de);
+        writer.write16(regs[i].hl);
+    }
+    writer.writeInt(af_sel);
+    writer.writeInt(regs_sel);
+    writer.write16(ir);
+    writer.write16(ix);
+    writer.write16(iy);
+    writer.write16(sp);
+    writer.write16(pc);
+    writer.write16(IFF);
+    writer.write16(IM);
+    writer.writeInt(m_iffPendingCnt);
+    writer.writeBool(m_stackOperation);
+}
+
+
+void CpuZ80::loadState(SnapshotReader& reader)
+{
+    loadClockState(reader);
+    for (int i = 0; i < 2; i++) {
+        af[i] = reader.read16();
+        regs[i].bc = reader.read16();
+        regs[i].de = reader.read16();
+        regs[i].hl = reader.read16();
+    }
+    af_sel = reader.readInt();
+    regs_sel = reader.readInt();
+    ir = reader.read16();
+    ix = reader.read16();
+    iy = reader.read16();
+    sp = reader.read16();
+    pc = reader.read16();
+    IFF = reader.read16();
+    IM = reader.read16();
+    m_iffPendingCnt = reader.readInt();
+    m_stackOperation = reader.readBool();
+}
@@ -81,13 +81,18 @@ class CpuZ80 : public Cpu8080Compatible
         void setHL2(uint16_t value);
         void setIX(uint16_t value);
         void setIY(uint16_t value);
+        void setIR(uint16_t value);
 
         uint8_t  getIM();
         uint8_t  getR();
+        uint16_t getIR();
         uint8_t  getIFF();
 
         bool checkForStackOperation() override {return m_stackOperation;}
 
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
+
         static EmuObject* create(const EmuValuesList&) {return new CpuZ80();}
 
     private:
@@ -112,6 +117,9 @@ class CpuZ80 : public Cpu8080Compatible
         unsigned cb_prefix(unsigned adr);
         unsigned dfd_prefix(uint16_t& IXY);
         unsigned simz80();
+
+        void operateOnce();
+        void operateInstrumented();
 };
 
 #endif // CPUZ80_H
@@ -29,6 +29,7 @@
 #include "Platform.h"
 #include "PlatformCore.h"
 #include "Emulation.h"
+#include "Snapshot.h"
 
 using namespace std;
 
@@ -488,6 +489,9 @@ void Crt8275::operate()
         return;
     }
 
+    if (m_curBurstPos == 0 && m_burstCount > 1 && burstTransfer())
+        return;
+
     m_isBurst = m_curBurstPos == 0;
 
     if (m_dma->dmaRequest(m_dmaChannel, byte, m_isBurst ? m_curClock : 0)) {
@@ -507,6 +511,42 @@ void Crt8275::operate()
 }
 
 
+// Fetches the whole DMA burst at once if DMA controller is able to provide it. Timing is the same
+// as with separate requests except that CPU is held for the whole burst as real 8257 does.
+bool Crt8275::burstTransfer()
+{
+    uint8_t buf[8];
+    if (m_dma->getBlock(m_dmaChannel, m_burstCount, buf) != m_burstCount)
+        return false;
+
+    uint64_t burstClock = m_curClock;
+    int nBytes = 0;
+    while (nBytes < m_burstCount) {
+        m_isBurst = m_curBurstPos == 0;
+        putCharToBuffer(buf[nBytes++]);
+        if (!m_isPaused) {
+            m_curClock += (m_isBurst ? 8 : 4) * m_cpuKDiv;
+            if ((m_curBurstPos == m_burstCount - 1) && (m_curClock % m_kDiv != 0))
+                m_curClock = m_curClock + m_kDiv - m_curClock % m_kDiv;
+        }
+        m_curBurstPos = (m_curBurstPos + 1) % m_burstCount;
+        if (m_curBurstPos == 0 && m_burstSpaceCount != 0)
+            m_isBurstSpace = true;
+        if (m_isPaused)
+            break;
+    }
+
+    m_dma->completeBlock(m_dmaChannel, nBytes, burstClock);
+
+    if (m_isBurstSpace && !m_isPaused) {
+        m_isBurstSpace = false;
+        m_curClock += (m_burstSpaceCount * m_kDiv);
+    }
+
+    return true;
+}
+
+
 void Crt8275::putCharToBuffer(uint8_t byte)
 {
     if (m_needExtraByte) {
@@ -731,6 +771,7 @@ void Crt8275Raster::operate()
                     m_crt->m_statusReg |= 0x20; // actually should be at the beginning of the last display row
                 m_isVrtcActive = true;
                 m_crt->m_wasVsync = true;
+                BenchSectionGuard guard(g_emulation->getBenchStats(), BS_RENDERER); // frame is rendered on VRTC
                 m_core->vrtc(true);
             } else if (m_curScanRow >= m_crt->m_nRows + m_crt->m_nVrRows) {
                 // frame complete
@@ -767,3 +808,131 @@ bool Crt8275::setProperty(const string& propertyName, const EmuValuesList& value
     return false;
 }
 
+
+void Crt8275::saveState(SnapshotWriter& writer)
+{
+    saveClockState(writer);
+
+    writer.writeInt(m_nRows);
+    writer.writeInt(m_nLines);
+    writer.writeBool(m_isSpacedRows);
+    writer.writeInt(m_nCharsPerRow);
+    writer.writeInt(m_undLine);
+    writer.writeBool(m_isOffsetLine);
+    writer.writeBool(m_isTransparentAttr);
+    writer.writeInt(m_nVrRows);
+    writer.writeInt(m_nHrChars);
+    writer.writeInt(m_burstCount);
+    writer.writeInt(m_burstSpaceCount);
+    writer.writeInt(m_cursorPos);
+    writer.writeInt(m_cursorRow);
+    writer.writeBool(m_isIntsEnabled);
+    writer.writeBool(m_cursorBlinking);
+    writer.writeBool(m_cursorUnderline);
+    writer.write8(m_statusReg);
+    writer.write8(m_cmdReg);
+    writer.writeBuf(m_resetParam, sizeof(m_resetParam));
+    writer.writeBuf(m_rowBuf, sizeof(m_rowBuf));
+    writer.writeBuf(m_fifo, sizeof(m_fifo));
+    writer.writeInt(m_crtCmd);
+    writer.writeInt(m_parameterNum);
+    writer.writeBool(m_isCompleteCommand);
+    writer.writeBool(m_isDisplayStarted);
+    writer.writeBool(m_isRasterStarted);
+    writer.writeInt(m_curRow);
+    writer.writeInt(m_curBufPos);
+    writer.writeBool(m_isNextCharToFifo);
+    writer.writeInt(m_curFifoPos);
+    writer.writeInt(m_curBurstPos);
+    writer.writeBool(m_isBurstSpace);
+    writer.writeBool(m_isBurst);
+    writer.writeBool(m_isDmaStoppedForRow);
+    writer.writeBool(m_isDmaStoppedForFrame);
+    writer.writeBool(m_needExtraByte);
+    writer.writeBool(m_wasVsync);
+    writer.writeBool(m_wasDmaUnderrun);
+    writer.writeBool(m_curUnderline);
+    writer.writeBool(m_curReverse);
+    writer.writeBool(m_curBlink);
+    writer.writeBool(m_curHighlight);
+    writer.writeBool(m_curGpa1);
+    writer.writeBool(m_curGpa0);
+    writer.writeInt(m_frameCount);
+    writer.writeBool(m_isBlankedToTheEndOfScreen);
+
+    // frame symbols are not saved, they are refilled during the next frame
+    writer.writeInt(m_frame.nRows);
+    writer.writeInt(m_frame.nCharsPerRow);
+    writer.writeInt(m_frame.nLines);
+    writer.writeBool(m_frame.isOffsetLineMode);
+
+    m_raster->saveClockState(writer);
+    writer.writeBool(m_raster->m_isHrtcActive);
+    writer.writeBool(m_raster->m_isVrtcActive);
+    writer.writeInt(m_raster->m_curScanRow);
+    writer.writeInt(m_raster->m_curScanLine);
+}
+
+
+void Crt8275::loadState(SnapshotReader& reader)
+{
+    loadClockState(reader);
+
+    m_nRows = reader.readInt();
+    m_nLines = reader.readInt();
+    m_isSpacedRows = reader.readBool();
+    m_nCharsPerRow = reader.readInt();
+    m_undLine = reader.readInt();
+    m_isOffsetLine = reader.readBool();
+    m_isTransparentAttr = reader.readBool();
+    m_nVrRows = reader.readInt();
+    m_nHrChars = reader.readInt();
+    m_burstCount = reader.readInt();
+    m_burstSpaceCount = reader.readInt();
+    m_cursorPos = reader.readInt();
+    m_cursorRow = reader.readInt();
+    m_isIntsEnabled = reader.readBool();
+    m_cursorBlinking = reader.readBool();
+    m_cursorUnderline = reader.readBool();
+    m_statusReg = reader.read8();
+    m_cmdReg = reader.read8();
+    reader.readBuf(m_resetParam, sizeof(m_resetParam));
+    reader.readBuf(m_rowBuf, sizeof(m_rowBuf));
+    reader.readBuf(m_fifo, sizeof(m_fifo));
+    m_crtCmd = CrtCommand(reader.readInt());
+    m_parameterNum = reader.readInt();
+    m_isCompleteCommand = reader.readBool();
+    m_isDisplayStarted = reader.readBool();
+    m_isRasterStarted = reader.readBool();
+    m_curRow = reader.readInt();
+    m_curBufPos = reader.readInt();
+    m_isNextCharToFifo = reader.readBool();
+    m_curFifoPos = reader.readInt();
+    m_curBurstPos = reader.readInt();
+    m_isBurstSpace = reader.readBool();
+    m_isBurst = reader.readBool();
+    m_isDmaStoppedForRow = reader.readBool();
+    m_isDmaStoppedForFrame = reader.readBool();
+    m_needExtraByte = reader.readBool();
+    m_wasVsync = reader.readBool();
+    m_wasDmaUnderrun = reader.readBool();
+    m_curUnderline = reader.readBool();
+    m_curReverse = reader.readBool();
+    m_curBlink = reader.readBool();
+    m_curHighlight = reader.readBool();
+    m_curGpa1 = reader.readBool();
+    m_curGpa0 = reader.readBool();
+    m_frameCount = reader.readInt();
+    m_isBlankedToTheEndOfScreen = reader.readBool();
+
+    m_frame.nRows = reader.readInt();
+    m_frame.nCharsPerRow = reader.readInt();
+    m_frame.nLines = reader.readInt();
+    m_frame.isOffsetLineMode = reader.readBool();
+
+    m_raster->loadClockState(reader);
+    m_raster->m_isHrtcActive = reader.readBool();
+    m_raster->m_isVrtcActive = reader.readBool();
+    m_raster->m_curScanRow = reader.readInt();
+    m_raster->m_curScanLine = reader.readInt();
+}
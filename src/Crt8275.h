@@ -121,6 +121,9 @@ class Crt8275 : public AddressableDevice, public IActive
         // derived from ActiveDevice
         void operate() override;
 
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
+
         // Crt8275 own methods
         void attachCore(PlatformCore* core);
         void attachDMA(Dma8257* dma, int channel);
@@ -201,6 +204,7 @@ class Crt8275 : public AddressableDevice, public IActive
         //int m_dmaUnderrunAtRow;
 
 
+        bool burstTransfer();
         void putCharToBuffer(uint8_t byte);
         void dmaUnderrun();
         void nextRow();
@@ -250,10 +254,10 @@ class Crt8275Raster : public ActiveDevice
         Crt8275* m_crt;              // Master CRT device
         PlatformCore* m_core;        // Linked platform core
         //bool _isStarted;
-        bool m_isHrtcActive;
-        bool m_isVrtcActive;
-        int m_curScanRow;
-        int m_curScanLine;
+        bool m_isHrtcActive = false;
+        bool m_isVrtcActive = false;
+        int m_curScanRow = 0;
+        int m_curScanLine = 0;
 
         void startRaster();
         void stopRaster();
@@ -142,6 +142,150 @@ void Crt8275Renderer::trimImage(int charWidth, int charHeight)
 }
 
 
+void Crt8275Renderer::updateRenderCache(const Frame* frame)
+{
+    int params[8] = {frame->nRows, frame->nLines, frame->nCharsPerRow, frame->isOffsetLineMode,
+                     m_fntCharWidth, m_fntCharHeight, int(m_fntLcMask), m_useRvv};
+
+    const uint8_t* fontPtrs[8];
+    uint32_t fgColors[8];
+    uint32_t bgColors[8];
+    for (int i = 0; i < 8; i++) {
+        fontPtrs[i] = getCurFontPtr(i & 1, i & 2, i & 4);
+        fgColors[i] = getCurFgColor(i & 1, i & 2, i & 4);
+        bgColors[i] = getCurBgColor(i & 1, i & 2, i & 4);
+    }
+
+    if (m_isCacheValid && !memcmp(params, m_cacheParams, sizeof(params)) && !memcmp(fontPtrs, m_attrFontPtrs, sizeof(fontPtrs)) &&
+            !memcmp(fgColors, m_attrFgColors, sizeof(fgColors)) && !memcmp(bgColors, m_attrBgColors, sizeof(bgColors)))
+        return;
+
+    memcpy(m_cacheParams, params, sizeof(params));
+    memcpy(m_attrFontPtrs, fontPtrs, sizeof(fontPtrs));
+    memcpy(m_attrFgColors, fgColors, sizeof(fgColors));
+    memcpy(m_attrBgColors, bgColors, sizeof(bgColors));
+
+    int nSymbols = frame->nRows * frame->nCharsPerRow;
+    m_frameImage.resize(nSymbols * frame->nLines * m_fntCharWidth);
+    m_symbolKeys.assign(nSymbols, ~uint64_t(0)); // never matches real key
+    m_glyphCache.resize(16 * 128 * 16 * 8);
+    m_glyphCached.assign(16 * 128, false);
+
+    m_isCacheValid = true;
+}
+
+
+// Key bits: 0-6 - char, 7-9 - gpa0, gpa1, hglt, 10 - reverse, 16-31 - vsp per line, 32-47 - lten per line
+uint64_t Crt8275Renderer::getSymbolKey(const Frame* frame, int row, int chr)
+{
+    const Symbol& symbol = frame->symbols[row][chr];
+    int nChars = frame->nCharsPerRow;
+    const Symbol& nextSymbol = (chr == nChars - 1) ? symbol : frame->symbols[row][chr + 1];
+
+    const SymbolAttributes& hgltAttrs = m_hgltOffset ? nextSymbol.symbolAttributes : symbol.symbolAttributes;
+    const SymbolAttributes& gpaAttrs = m_gpaOffset ? nextSymbol.symbolAttributes : symbol.symbolAttributes;
+    const SymbolAttributes& rvvAttrs = m_rvvOffset ? nextSymbol.symbolAttributes : symbol.symbolAttributes;
+    const Symbol& ltenSymbol = m_ltenOffset ? nextSymbol : symbol;
+
+    uint64_t key = symbol.chr & 0x7F;
+    key |= (gpaAttrs.gpa0 ? 0x80 : 0) | (gpaAttrs.gpa1 ? 0x100 : 0) | (hgltAttrs.hglt ? 0x200 : 0);
+    key |= (rvvAttrs.rvv && m_useRvv) ? 0x400 : 0;
+
+    for (int ln = 0; ln < frame->nLines; ln++) {
+        if (symbol.symbolLineAttributes[ln].vsp)
+            key |= uint64_t(1) << (16 + ln);
+        if (ltenSymbol.symbolLineAttributes[ln].lten)
+            key |= uint64_t(1) << (32 + ln);
+    }
+
+    return key;
+}
+
+
+// Returns nLines x 8 pixels of glyph for lower 11 bits of symbol key
+const uint32_t* Crt8275Renderer::getGlyph(unsigned key, int nLines)
+{
+    uint32_t* glyph = m_glyphCache.data() + key * 16 * 8;
+    if (m_glyphCached[key])
+        return glyph;
+
+    int attrs = (key >> 7) & 7;
+    bool rvv = key & 0x400;
+    const uint8_t* fntPtr = m_attrFontPtrs[attrs] + (key & 0x7F) * m_fntCharHeight;
+    uint32_t fgColor = rvv ? m_attrBgColors[attrs] : m_attrFgColors[attrs];
+    uint32_t bgColor = rvv ? m_attrFgColors[attrs] : m_attrBgColors[attrs];
+
+    for (int lc = 0; lc < nLines; lc++) {
+        uint8_t fntLine = fntPtr[lc & m_fntLcMask] << (8 - m_fntCharWidth);
+        for (int pt = 0; pt < m_fntCharWidth; pt++) {
+            glyph[lc * 8 + pt] = (fntLine & 0x80) ? bgColor : fgColor;
+            fntLine <<= 1;
+        }
+    }
+
+    m_glyphCached[key] = true;
+    return glyph;
+}
+
+
+void Crt8275Renderer::renderCachedFrame(const Frame* frame)
+{
+    updateRenderCache(frame);
+
+    int nRows = frame->nRows;
+    int nLines = frame->nLines;
+    int nChars = frame->nCharsPerRow;
+    int lineSize = nChars * m_fntCharWidth;
+
+    uint64_t rowKeys[128];
+
+    for (int row = 0; row < nRows; row++) {
+        uint64_t* prevRowKeys = m_symbolKeys.data() + row * nChars;
+
+        for (int chr = 0; chr < nChars; chr++)
+            rowKeys[chr] = getSymbolKey(frame, row, chr);
+
+        if (!memcmp(rowKeys, prevRowKeys, nChars * sizeof(uint64_t)))
+            continue; // row is not changed
+
+        memcpy(prevRowKeys, rowKeys, nChars * sizeof(uint64_t));
+
+        uint32_t* chrPtr = m_frameImage.data() + row * nLines * lineSize;
+        for (int chr = 0; chr < nChars; chr++) {
+            uint64_t key = rowKeys[chr];
+            const uint32_t* glyph = getGlyph(key & 0x7FF, nLines);
+
+            int attrs = (key >> 7) & 7;
+            bool rvv = key & 0x400;
+            uint32_t fgColor = rvv ? m_attrBgColors[attrs] : m_attrFgColors[attrs];
+            uint32_t bgColor = rvv ? m_attrFgColors[attrs] : m_attrBgColors[attrs];
+
+            uint32_t* linePtr = chrPtr;
+            for (int ln = 0; ln < nLines; ln++) {
+                if (key & (uint64_t(1) << (32 + ln))) {
+                    // lten
+                    for (int pt = 0; pt < m_fntCharWidth; pt++)
+                        linePtr[pt] = fgColor;
+                } else if (key & (uint64_t(1) << (16 + ln))) {
+                    // vsp
+                    for (int pt = 0; pt < m_fntCharWidth; pt++)
+                        linePtr[pt] = bgColor;
+                } else {
+                    int lc;
+                    if (!frame->isOffsetLineMode)
+                        lc = ln;
+                    else
+                        lc = ln != 0 ? ln - 1 : nLines - 1;
+                    memcpy(linePtr, glyph + lc * 8, m_fntCharWidth * sizeof(uint32_t));
+                }
+                linePtr += lineSize;
+            }
+            chrPtr += m_fntCharWidth;
+        }
+    }
+}
+
+
 void Crt8275Renderer::primaryRenderFrame()
 {
     calcAspectRatio(m_fntCharWidth);
@@ -163,6 +307,13 @@ void Crt8275Renderer::primaryRenderFrame()
         m_bufSize = m_dataSize;
     }
 
+    if (!m_customDraw) {
+        renderCachedFrame(frame);
+        memcpy(m_pixelData, m_frameImage.data(), m_dataSize * sizeof(uint32_t));
+        trimImage(m_fntCharWidth, nLines);
+        return;
+    }
+
     memset(m_pixelData, 0, m_dataSize * sizeof(uint32_t));
     uint32_t* rowPtr = m_pixelData;
 
@@ -194,11 +345,6 @@ void Crt8275Renderer::primaryRenderFrame()
             else
                 rvv = frame->symbols[row][chr+1].symbolAttributes.rvv;
 
-            const uint8_t* fntPtr = getCurFontPtr(gpa0, gpa1, hglt);
-            uint32_t fgColor = getCurFgColor(gpa0, gpa1, hglt);
-            uint32_t bgColor = getCurBgColor(gpa0, gpa1, hglt);
-
-
             for (int ln = 0; ln < nLines; ln++) {
                 int lc;
                 if (!frame->isOffsetLineMode)
@@ -214,19 +360,7 @@ void Crt8275Renderer::primaryRenderFrame()
                 else
                     lten = frame->symbols[row][chr+1].symbolLineAttributes[ln].lten;
 
-                if (!m_customDraw) {
-                    uint8_t fntLine = fntPtr[symbol.chr * m_fntCharHeight + (lc & m_fntLcMask)] << (8 - m_fntCharWidth);
-
-                    for (int pt = 0; pt < m_fntCharWidth; pt++) {
-                        //bool v = lten || !vsp && (fntLine & 0x80);
-                        bool v = lten || !(vsp || (fntLine & 0x80));
-                        if (rvv && m_useRvv)
-                            v = !v;
-                        linePtr[pt] = v ? fgColor : bgColor;
-                        fntLine <<= 1;
-                    }
-                } else
-                    customDrawSymbolLine(linePtr, symbol.chr, lc, lten, vsp, rvv, gpa0, gpa1, hglt);
+                customDrawSymbolLine(linePtr, symbol.chr, lc, lten, vsp, rvv, gpa0, gpa1, hglt);
                 linePtr += nChars * m_fntCharWidth;
             }
             chrPtr += m_fntCharWidth;
@@ -21,9 +21,12 @@
 #ifndef CRT8275RENDERER_H
 #define CRT8275RENDERER_H
 
+#include <vector>
+
 #include "CrtRenderer.h"
 
 class Crt8275;
+struct Frame;
 
 
 class Crt8275Renderer : public TextCrtRenderer
@@ -76,9 +79,27 @@ class Crt8275Renderer : public TextCrtRenderer
         double m_frameRate;
         bool m_cropping = false;
 
+        // Primary renderer cache. Each symbol is reduced to a key containing everything its image
+        // depends on, rows with unchanged keys are not rendered again. Glyph lines are expanded
+        // to pixels once per (attributes, reverse, char) combination.
+        std::vector<uint32_t> m_frameImage;  // rendered frame
+        std::vector<uint64_t> m_symbolKeys;  // symbol keys of rendered frame
+        std::vector<uint32_t> m_glyphCache;  // expanded glyphs, 16 lines x 8 pixels each
+        std::vector<bool> m_glyphCached;
+        const uint8_t* m_attrFontPtrs[8];    // indexed by gpa0 | gpa1 << 1 | hglt << 2
+        uint32_t m_attrFgColors[8];
+        uint32_t m_attrBgColors[8];
+        int m_cacheParams[8];
+        bool m_isCacheValid = false;
+
         std::string getCrtMode();
         void calcAspectRatio(int charWidth);
         void trimImage(int charWidth, int charHeight);
+
+        void updateRenderCache(const Frame* frame);
+        uint64_t getSymbolKey(const Frame* frame, int row, int chr);
+        const uint32_t* getGlyph(unsigned key, int nLines);
+        void renderCachedFrame(const Frame* frame);
 };
 
 
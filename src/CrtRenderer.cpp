@@ -62,6 +62,16 @@ EmuPixelData CrtRenderer::getPixelData()
 
     pd.frameNo = m_frameNo;
 
+    if (m_changedWidth >= 0 && m_sizeX == m_prevSizeX && m_sizeY == m_prevSizeY) {
+        pd.changedX = m_changedX;
+        pd.changedY = m_changedY;
+        pd.changedWidth = m_changedWidth;
+        pd.changedHeight = m_changedHeight;
+    } else {
+        pd.changedWidth = m_sizeX;
+        pd.changedHeight = m_sizeY;
+    }
+
     return pd;
 }
 
@@ -86,10 +96,22 @@ void CrtRenderer::swapBuffers()
     m_pixelData = buf;
     m_bufSize = bs;
 
+    m_changedX = m_changedY = 0;
+    m_changedWidth = m_changedHeight = -1;
+
     ++m_frameNo;
 }
 
 
+void CrtRenderer::setChangedRect(int x, int y, int width, int height)
+{
+    m_changedX = x;
+    m_changedY = y;
+    m_changedWidth = width;
+    m_changedHeight = height;
+}
+
+
 bool CrtRenderer::setProperty(const string& propertyName, const EmuValuesList& values)
 {
     if (EmuObject::setProperty(propertyName, values))
@@ -60,8 +60,15 @@ class CrtRenderer : public EmuObject
         int m_prevBufSize = 0;
         double m_prevAspectRatio = 1.0;
 
+        // Changed area of the current frame, reset to "unknown" by swapBuffers()
+        int m_changedX = 0;
+        int m_changedY = 0;
+        int m_changedWidth = -1;
+        int m_changedHeight = -1;
+
         virtual bool isRasterPresent() {return true;}
         void swapBuffers();
+        void setChangedRect(int x, int y, int width, int height);
 
     private:
         unsigned m_frameNo = 0;
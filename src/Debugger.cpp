@@ -30,6 +30,7 @@
 #include "CpuZ80.h"
 #include "Cpu8080dasm.h"
 #include "CpuZ80dasm.h"
+#include "Watchpoints.h"
 
 using namespace std;
 
@@ -218,6 +219,15 @@ void DebugWindow::startDebug()
         m_tempBp = nullptr;
     }
 
+    // при срабатывании точки наблюдения переходим в дампе на адрес обращения
+    WatchpointSpace* watchSpace = m_cpu->getWatchpoints();
+    if (watchSpace->getHitWatchpoint()) {
+        uint16_t addr = watchSpace->getHitAddr();
+        m_dumpCurStartAddr = uint16_t((addr & 0xFFF0) - uint16_t((m_dumpCurAddr & 0xFFF0) - m_dumpCurStartAddr));
+        m_dumpCurAddr = addr;
+        watchSpace->clearHit();
+    }
+
     m_stateNum = 1 - m_stateNum;
     fillCpuStatus();
     codeGotoPc();
@@ -861,6 +871,8 @@ void DebugWindow::drawHintBar()
         case AM_DUMP:
             //s = "C/D/R/B,Tab,Esc-Section A-Addr F2-Edit";
             s = "C/D/R/F/B,Tab,Esc-Section A-Addr Enter/F2-Edit";
+            s += m_swapF5F9 ? " F9-W/p" : " F5-W/p";
+            s += " V-Value L-Len";
             break;
         case AM_REGS:
             //s = "C/D/R/B,Tab,Esc-Section F2-Edit";
@@ -872,7 +884,7 @@ void DebugWindow::drawHintBar()
             break;
         case AM_BPOINTS:
             //s = "C/D/R/B,Tab,Esc-Section F2-Edit Enter-Goto";
-            s = "C/D/R/F/B,Tab,Esc-Section Enter-Goto";
+            s = "C/D/R/F/B,Tab,Esc-Section Enter-Goto Del-Delete";
             break;
         case AM_INPUT:
             s = "Enter-Enter Esc-Cancel";
@@ -941,6 +953,8 @@ void DebugWindow::processKey(PalKeyCode keyCode, bool isPressed)
                         run();
                     } else if (m_mode == AM_CODE)
                         codeKbdProc(keyCode);
+                    else if (m_mode == AM_DUMP)
+                        watchpoint();
                     break;
                 case PK_F9:
                     if (!m_swapF5F9) {
@@ -948,6 +962,8 @@ void DebugWindow::processKey(PalKeyCode keyCode, bool isPressed)
                         run();
                     } else if (m_mode == AM_CODE)
                         codeKbdProc(keyCode);
+                    else if (m_mode == AM_DUMP)
+                        watchpoint();
                     break;
                 default:
                     switch (m_mode) {
@@ -1154,16 +1170,14 @@ void DebugWindow::breakpoint()
     BreakpointInfo bpInfo;
     list<BreakpointInfo>::iterator it;
     for (it = m_bpList.begin(); it != m_bpList.end(); it++)
-        if ((*it).addr == pc) {
+        if ((*it).type == BT_EXEC && (*it).addr == pc) {
             found = true;
-            bpInfo = *it;
             break;
         }
 
     if (found) {
         // нашли, удаляем
-        delete bpInfo.codeBp;
-        m_bpList.erase(it);
+        removeBreakpoint(it);
     } else {
         // не нашли
         if (m_bpList.size() >=6) // ограничение на количество точек останова
@@ -1187,6 +1201,63 @@ void DebugWindow::checkForCurBreakpoint()
             (*it).codeBp->setSkipCount(1);
 }
 
+
+// точка наблюдения на текущем адресе дампа: запись -> чтение -> чтение/запись -> снята
+void DebugWindow::watchpoint()
+{
+    auto it = findWatchpoint(m_dumpCurAddr);
+
+    if (it == m_bpList.end()) {
+        if (m_bpList.size() >=6) // ограничение на количество точек останова
+            return;
+        BreakpointInfo bpInfo;
+        bpInfo.addr = m_dumpCurAddr;
+        bpInfo.type = BT_WRITE;
+        m_bpList.push_back(bpInfo);
+        applyWatchpoint(m_bpList.back());
+    } else if ((*it).type == BT_ACSESS)
+        removeBreakpoint(it);
+    else {
+        (*it).type = (*it).type == BT_WRITE ? BT_READ : BT_ACSESS;
+        applyWatchpoint(*it);
+    }
+}
+
+
+list<BreakpointInfo>::iterator DebugWindow::findWatchpoint(uint16_t addr)
+{
+    for (auto it = m_bpList.begin(); it != m_bpList.end(); it++)
+        if ((*it).type != BT_EXEC && (*it).addr == addr)
+            return it;
+    return m_bpList.end();
+}
+
+
+void DebugWindow::applyWatchpoint(BreakpointInfo& bpInfo)
+{
+    WatchpointSpace* watchSpace = m_cpu->getWatchpoints();
+
+    if (bpInfo.watchId)
+        watchSpace->removeWatchpoint(bpInfo.watchId);
+
+    int type = bpInfo.type == BT_WRITE ? WT_WRITE : (bpInfo.type == BT_READ ? WT_READ : WT_ACCESS);
+    bpInfo.watchId = watchSpace->addWatchpoint(bpInfo.addr, bpInfo.size, type, bpInfo.value);
+}
+
+
+void DebugWindow::removeBreakpoint(list<BreakpointInfo>::iterator it)
+{
+    if ((*it).type == BT_EXEC)
+        delete (*it).codeBp;
+    else
+        m_cpu->getWatchpoints()->removeWatchpoint((*it).watchId);
+
+    m_bpList.erase(it);
+
+    if (m_curBpoint >= m_bpList.size())
+        m_curBpoint = m_bpList.empty() ? 0 : m_bpList.size() - 1;
+}
+
 // ######## INPUT mode methods ########
 
 void DebugWindow::inputInit()
@@ -1617,19 +1688,44 @@ void DebugWindow::dumpKbdProc(PalKeyCode keyCode)
             m_dumpCurStartAddr += 0x80;
             break;
         case PK_A:
-            m_dumpInputAddr = true;
+            m_dumpInputType = DIT_ADDR;
             inputStart(m_mode, m_curLayout->dump.left + 3, m_curLayout->dump.top + 1 + uint16_t(m_dumpCurAddr - m_dumpCurStartAddr) / 16, 4, true, m_dumpCurAddr & 0xFFF0);
             break;
         case PK_ENTER:
         case PK_KP_ENTER:
         case PK_F2: {
-            m_dumpInputAddr = false;
+            m_dumpInputType = DIT_VALUE;
+            int ofs = (m_dumpCurAddr - m_dumpCurStartAddr) & 0xffff;
+            int line = ofs / 16;
+            int bt = ofs % 16;
+            inputStart(m_mode, m_curLayout->dump.left + 8 + bt * 3 + 1, m_curLayout->dump.top + 1 + line, 2, true, memByte(m_dumpCurAddr));
+            break;
+        }
+        case PK_V: {
+            auto it = findWatchpoint(m_dumpCurAddr);
+            if (it == m_bpList.end())
+                break;
+            if ((*it).value >= 0) {
+                // повторное нажатие снимает условие
+                (*it).value = -1;
+                applyWatchpoint(*it);
+                break;
+            }
+            m_dumpInputType = DIT_WATCH_VALUE;
             int ofs = (m_dumpCurAddr - m_dumpCurStartAddr) & 0xffff;
             int line = ofs / 16;
             int bt = ofs % 16;
             inputStart(m_mode, m_curLayout->dump.left + 8 + bt * 3 + 1, m_curLayout->dump.top + 1 + line, 2, true, memByte(m_dumpCurAddr));
             break;
         }
+        case PK_L: {
+            auto it = findWatchpoint(m_dumpCurAddr);
+            if (it == m_bpList.end())
+                break;
+            m_dumpInputType = DIT_WATCH_SIZE;
+            inputStart(m_mode, m_curLayout->dump.left + 3, m_curLayout->dump.top + 1 + uint16_t(m_dumpCurAddr - m_dumpCurStartAddr) / 16, 4, true, (*it).size & 0xFFFF);
+            break;
+        }
         default:
             break;
     }
@@ -1643,14 +1739,23 @@ void DebugWindow::dumpKbdProc(PalKeyCode keyCode)
 void DebugWindow::dumpProcessInput()
 {
     m_inputFromMode = AM_NONE;
-    if (m_dumpInputAddr) {
+    if (m_dumpInputType == DIT_ADDR) {
         m_dumpCurStartAddr = uint16_t((m_inputReturnValue & 0xFFF0) - uint16_t((m_dumpCurAddr & 0xFFF0) - m_dumpCurStartAddr));
         m_dumpCurAddr = m_inputReturnValue;
-    } else {
+    } else if (m_dumpInputType == DIT_VALUE) {
         writeByte(m_dumpCurAddr, m_inputReturnValue);
         dumpKbdProc(PK_RIGHT); // переходим к редактированию следующего байта
         m_inputFromMode = AM_DUMP;
         dumpKbdProc(PK_F2);
+    } else {
+        auto it = findWatchpoint(m_dumpCurAddr);
+        if (it == m_bpList.end())
+            return;
+        if (m_dumpInputType == DIT_WATCH_VALUE)
+            (*it).value = m_inputReturnValue;
+        else
+            (*it).size = m_inputReturnValue ? m_inputReturnValue : 1;
+        applyWatchpoint(*it);
     }
 }
 
@@ -2001,7 +2106,11 @@ void DebugWindow::bpointsDraw()
             setColors(12, 1);
             putString(m_curLayout->bpts.left + 2 , i + m_curLayout->bpts.top, int2Hex((*it).addr, 4));
             setColors(7, 1);
-            putString(m_curLayout->bpts.left + 1, i + m_curLayout->bpts.top, "x");
+            // x - исполнение, w - запись, r - чтение, a - чтение/запись
+            putString(m_curLayout->bpts.left + 1, i + m_curLayout->bpts.top, string(1, "xwra"[(*it).type]));
+            // + - диапазон, = - условие на значение, * - оба
+            if ((*it).size > 1 || (*it).value >= 0)
+                putString(m_curLayout->bpts.left + 6, i + m_curLayout->bpts.top, (*it).value < 0 ? "+" : ((*it).size > 1 ? "*" : "="));
         }
     }
 
@@ -2032,9 +2141,22 @@ void DebugWindow::bpointsKbdProc(PalKeyCode keyCode)
         case PK_KP_ENTER: {
             auto it = m_bpList.begin();
             advance(it, m_curBpoint);
-            codeGotoAddr((*it).addr);
-            codeGotoAddr((*it).addr);
-            m_mode = AM_CODE;
+            if ((*it).type == BT_EXEC) {
+                codeGotoAddr((*it).addr);
+                codeGotoAddr((*it).addr);
+                m_mode = AM_CODE;
+            } else {
+                m_dumpCurStartAddr = uint16_t(((*it).addr & 0xFFF0) - uint16_t((m_dumpCurAddr & 0xFFF0) - m_dumpCurStartAddr));
+                m_dumpCurAddr = (*it).addr;
+                m_mode = AM_DUMP;
+            }
+            break; }
+        case PK_DEL: {
+            auto it = m_bpList.begin();
+            advance(it, m_curBpoint);
+            removeBreakpoint(it);
+            if (m_bpList.empty())
+                m_mode = AM_CODE;
             break; }
         default:
             break;
@@ -84,6 +84,9 @@ struct BreakpointInfo {
     uint16_t addr;
     BreakpointType type;
     CodeBreakpoint* codeBp = nullptr;
+    unsigned size = 1;  // размер диапазона точки наблюдения
+    int value = -1;     // значение для срабатывания точки наблюдения, -1 - любое
+    int watchId = 0;
 };
 
 class DebugWindow : private EmuWindow
@@ -286,10 +289,14 @@ class DebugWindow : private EmuWindow
         void here();
         void run();
         void breakpoint();
+        void watchpoint();                      // установка/смена типа/снятие точки наблюдения на текущем адресе дампа
 
         bool m_isRunning = true;
         CodeBreakpoint* m_tempBp = nullptr;
         std::list<BreakpointInfo> m_bpList;
+        std::list<BreakpointInfo>::iterator findWatchpoint(uint16_t addr);
+        void applyWatchpoint(BreakpointInfo& bpInfo); // (пере)устанавливает точку наблюдения после изменения параметров
+        void removeBreakpoint(std::list<BreakpointInfo>::iterator it);
         void checkForCurBreakpoint();           // проверяет перед выполнением, не установлена ли точка останова на текущий PC
 
         // code section fields and methods
@@ -310,7 +317,13 @@ class DebugWindow : private EmuWindow
         // dump section fields and methods
         uint16_t m_dumpCurStartAddr;            // текущий начальный адрес дампа
         uint16_t m_dumpCurAddr;                 // текущий адрес в дампе
-        bool m_dumpInputAddr;                   // true, если вводится адрес и false, если значение ячейки
+        enum DumpInputType {
+            DIT_VALUE,      // значение ячейки
+            DIT_ADDR,       // адрес
+            DIT_WATCH_VALUE,// значение для срабатывания точки наблюдения
+            DIT_WATCH_SIZE  // размер диапазона точки наблюдения
+        };
+        DumpInputType m_dumpInputType;          // что вводится в секции дампа
         void dumpInit();                        // инициализация секции дампа
         void dumpDraw();                        // отрисовка дампа
         void dumpKbdProc(PalKeyCode keyCode);   // клавиатурный обработчик секции дампа
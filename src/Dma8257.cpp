@@ -22,10 +22,12 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "Dma8257.h"
 #include "Cpu.h"
 #include "Emulation.h"
+#include "Snapshot.h"
 
 using namespace std;
 
@@ -168,6 +170,78 @@ bool Dma8257::dmaRequest(int channel, uint8_t &value, uint64_t clock)
             // TC Stop
             m_modeReg &= ~(1 << channel);
     }
+    holdCpu(1, clock);
+    return true;
+}
+
+
+
+int Dma8257::getBlock(int channel, int len, uint8_t* buf)
+{
+    if (!(m_modeReg & (1 << channel)) || !m_addrSpace)
+        return 0;
+
+    uint16_t addr = m_addr[channel];
+    uint16_t count = m_count[channel];
+    if ((channel == 2) && (m_modeReg & 0x80) && ((count & 0x3fff) == 0x3fff)) {
+        // Autoload before new cycle after TC
+        addr = m_addr[3];
+        count = m_count[3];
+    }
+
+    if ((count & 0xc000) != 0x4000)
+        // read cycles only
+        return 0;
+
+    // don't go beyond TC
+    if (len > (count & 0x3fff) + 1)
+        len = (count & 0x3fff) + 1;
+
+    // memory without side effects only
+    int n = 0;
+    while (n < len) {
+        uint8_t* page = m_addrSpace->getDirectPagePtr(addr & 0xff00, false);
+        if (!page)
+            break;
+        int chunk = 0x100 - (addr & 0xff);
+        if (chunk > len - n)
+            chunk = len - n;
+        memcpy(buf + n, page + (addr & 0xff), chunk);
+        n += chunk;
+        addr += chunk;
+    }
+
+    return n;
+}
+
+
+
+void Dma8257::completeBlock(int channel, int nBytes, uint64_t clock)
+{
+    if (nBytes <= 0)
+        return;
+
+    if ((channel == 2) && (m_modeReg & 0x80) && ((m_count[channel] & 0x3fff) == 0x3fff)) {
+        // Autoload before new cycle after TC
+        m_addr[2] = m_addr[3];
+        m_count[2] = m_count[3];
+    }
+    m_count[channel] = (m_count[channel] & 0xc000) | (((m_count[channel] & 0x3fff) - nBytes) & 0x3fff);
+    m_addr[channel] += nBytes;
+    if ((m_count[channel] & 0x3fff) == 0x3fff) {
+        // End of block transfer
+        m_statusReg |= (1 << channel);
+        if ((m_modeReg & 0x40) && !((channel == 2) && (m_modeReg & 0x80)))
+            // TC Stop
+            m_modeReg &= ~(1 << channel);
+    }
+    holdCpu(nBytes, clock);
+}
+
+
+
+void Dma8257::holdCpu(int nCycles, uint64_t clock)
+{
     if (m_cpu) {
         int offs = 0;
         if (clock) {
@@ -182,9 +256,8 @@ bool Dma8257::dmaRequest(int channel, uint8_t &value, uint64_t clock)
               else
                   offs = 0;*/
         }
-        m_cpu->hrq(4 * m_kDiv + offs);
+        m_cpu->hrq(4 * m_kDiv * nCycles + offs);
     }
-    return true;
 }
 
 
@@ -197,6 +270,32 @@ uint8_t Dma8257::getMR()
 
 
 
+void Dma8257::saveState(SnapshotWriter& writer)
+{
+    for (int ch = 0; ch < 4; ch++) {
+        writer.write16(m_addr[ch]);
+        writer.write16(m_count[ch]);
+    }
+    writer.write8(m_modeReg);
+    writer.write8(m_statusReg);
+    writer.writeBool(m_isLoByte);
+}
+
+
+
+void Dma8257::loadState(SnapshotReader& reader)
+{
+    for (int ch = 0; ch < 4; ch++) {
+        m_addr[ch] = reader.read16();
+        m_count[ch] = reader.read16();
+    }
+    m_modeReg = reader.read8();
+    m_statusReg = reader.read8();
+    m_isLoByte = reader.readBool();
+}
+
+
+
 bool Dma8257::setProperty(const string& propertyName, const EmuValuesList& values)
 {
     if (EmuObject::setProperty(propertyName, values))
@@ -55,12 +55,18 @@ class Dma8257 : public AddressableDevice
         bool isVerifyAvailable(int channel);
         bool dmaRequest(int channel, uint8_t &value, uint64_t clock = 0);
 
+        // Burst transfer: getBlock reads up to len bytes the channel would transfer in the following
+        // read cycles without changing DMA state and returns number of bytes read, completeBlock
+        // then performs nBytes cycles as dmaRequest would do but holds CPU once for all of them
+        int getBlock(int channel, int len, uint8_t* buf);
+        void completeBlock(int channel, int nBytes, uint64_t clock = 0);
+
         uint8_t getMR();
+
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
         static EmuObject* create(const EmuValuesList&) {return new Dma8257();}
 
-/*
-        void getBlock(int channel, int len, uint8_t* buf);
-*/
     private:
         AddressableDevice* m_addrSpace = nullptr;
         Cpu* m_cpu = nullptr;
@@ -70,6 +76,8 @@ class Dma8257 : public AddressableDevice
         uint8_t m_statusReg;
         bool m_isLoByte;
         //int m_kDiv = 1;
+
+        void holdCpu(int nCycles, uint64_t clock);
 };
 
 #endif // DMA8257_H
@@ -37,12 +37,18 @@ SOURCES += \
     AddrSpace.cpp \
     Apogey.cpp \
     AtaDrive.cpp \
+    AudioRingBuffer.cpp \
+    BenchStats.cpp \
+    BlepBuffer.cpp \
     CloseFileHook.cpp \
     ConfigReader.cpp \
     Cpu.cpp \
     Cpu8080.cpp \
     Cpu8080dasm.cpp \
+    Cpu8080Threaded.cpp \
     CpuHook.cpp \
+    CpuProfiler.cpp \
+    CpuTrace.cpp \
     CpuZ80.cpp \
     CpuZ80dasm.cpp \
     Crt8275.cpp \
@@ -59,7 +65,9 @@ SOURCES += \
     Fdc1793.cpp \
     FdImage.cpp \
     FileLoader.cpp \
+    GdbStub.cpp \
     GenericModules.cpp \
+    InputMovie.cpp \
     KbdLayout.cpp \
     Memory.cpp \
     Mikro80.cpp \
@@ -79,6 +87,7 @@ SOURCES += \
     PpiAtaAdapter.cpp \
     Psg3910.cpp \
     RamDisk.cpp \
+    RewindBuffer.cpp \
     Rk86.cpp \
     RkFdd.cpp \
     RkKeyboard.cpp \
@@ -86,12 +95,15 @@ SOURCES += \
     RkRomDisk.cpp \
     RkSdController.cpp \
     RkTapeHooks.cpp \
+    Scheduler.cpp \
     Shortcuts.cpp \
+    Snapshot.cpp \
     SoundMixer.cpp \
     Specialist.cpp \
     TapeRedirector.cpp \
     Ut88.cpp \
     Vector.cpp \
+    Watchpoints.cpp \
     WavReader.cpp \
     WavWriter.cpp \
     qt/qtAboutDialog.cpp \
@@ -111,12 +123,18 @@ HEADERS  += \
     AddrSpace.h \
     Apogey.h \
     AtaDrive.h \
+    AudioRingBuffer.h \
+    BenchStats.h \
+    BlepBuffer.h \
     CloseFileHook.h \
     ConfigReader.h \
     Cpu.h \
     Cpu8080.h \
     Cpu8080dasm.h \
+    Cpu8080Ops.h \
     CpuHook.h \
+    CpuProfiler.h \
+    CpuTrace.h \
     CpuWaits.h \
     CpuZ80.h \
     CpuZ80dasm.h \
@@ -135,8 +153,10 @@ HEADERS  += \
     Fdc1793.h \
     FdImage.h \
     FileLoader.h \
+    GdbStub.h \
     GenericModules.h \
     Globals.h \
+    InputMovie.h \
     KbdLayout.h \
     Keyboard.h \
     Memory.h \
@@ -161,6 +181,7 @@ HEADERS  += \
     PpiAtaAdapter.h \
     Psg3910.h \
     RamDisk.h \
+    RewindBuffer.h \
     Rk86.h \
     RkFdd.h \
     RkKeyboard.h \
@@ -168,13 +189,16 @@ HEADERS  += \
     RkRomDisk.h \
     RkSdController.h \
     RkTapeHooks.h \
+    Scheduler.h \
     Shortcuts.h \
+    Snapshot.h \
     SoundMixer.h \
     Specialist.h \
     TapeRedirector.h \
     Ut88.h \
     Vector.h \
     Version.h \
+    Watchpoints.h \
     WavReader.h \
     WavWriter.h \
     qt/qtAboutDialog.h \
@@ -205,6 +229,7 @@ FORMS += \
     qt/qtHelpDialog.ui
 
 win32:RC_FILE = qt/emu80.rc
+win32:LIBS += -lws2_32
 
 BUILDDIR = build
 OBJECTS_DIR = $${BUILDDIR}/obj
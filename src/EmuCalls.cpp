@@ -22,6 +22,7 @@
 #include "Emulation.h"
 #include "EmuWindow.h"
 #include "EmuConfig.h"
+#include "InputMovie.h"
 
 using namespace std;
 
@@ -107,3 +108,67 @@ unsigned emuGetEmulationSpeedFactor()
 {
     return g_emulation->getPausedState() ? 0 : g_emulation->getSpeedUpFactor();
 }
+
+
+// Starts collecting benchmark statistics for the active platform
+void emuStartBenchmark()
+{
+    g_emulation->startBenchmark();
+}
+
+
+// Returns benchmark statistics collected since emuStartBenchmark() call
+bool emuGetBenchmarkResult(EmuBenchResult& result)
+{
+    return g_emulation->getBenchmarkResult(result);
+}
+
+
+// Saves state of the current platform to file
+bool emuSaveSnapshot(const string& fileName)
+{
+    return g_emulation->saveSnapshot(fileName);
+}
+
+
+// Loads state of the current platform from file
+bool emuLoadSnapshot(const string& fileName)
+{
+    return g_emulation->loadSnapshot(fileName);
+}
+
+
+// Returns hashes of the current platform state sections
+bool emuGetStateHashes(vector<pair<string, uint64_t> >& hashes)
+{
+    return g_emulation->getStateHashes(hashes);
+}
+
+
+// Starts recording input of the current platform to movie file
+bool emuStartMovieRecording(const string& fileName)
+{
+    return g_emulation->startMovieRecording(fileName);
+}
+
+
+// Starts playback of movie file on the current platform
+bool emuStartMoviePlayback(const string& fileName)
+{
+    return g_emulation->startMoviePlayback(fileName);
+}
+
+
+// Stops recording (and writes movie file) or playback
+bool emuStopMovie()
+{
+    return g_emulation->stopMovie();
+}
+
+
+// Returns true if movie playback has reached the end of recorded run
+bool emuIsMovieFinished()
+{
+    InputMovie* movie = g_emulation->getMovie();
+    return movie && movie->isFinished();
+}
@@ -33,5 +33,14 @@ std::string emuGetPropertyValue(const std::string& objName, const std::string& p
 const std::vector<PlatformInfo>* emuGetPlatforms();
 void emuSelectPlatform(const std::string& platform);
 unsigned emuGetEmulationSpeedFactor();
+void emuStartBenchmark();
+bool emuGetBenchmarkResult(EmuBenchResult& result);
+bool emuSaveSnapshot(const std::string& fileName);
+bool emuLoadSnapshot(const std::string& fileName);
+bool emuGetStateHashes(std::vector<std::pair<std::string, uint64_t> >& hashes);
+bool emuStartMovieRecording(const std::string& fileName);
+bool emuStartMoviePlayback(const std::string& fileName);
+bool emuStopMovie();
+bool emuIsMovieFinished();
 
 #endif // EMUCALLS_H
@@ -20,6 +20,7 @@
 
 #include "EmuObjects.h"
 #include "Emulation.h"
+#include "Snapshot.h"
 
 using namespace std;
 
@@ -99,6 +100,42 @@ IActive::~IActive()
 void IActive::syncronize()
 {
     m_curClock = g_emulation->getCurClock();
+    updateSchedule();
+}
+
+
+void IActive::saveClockState(SnapshotWriter& writer)
+{
+    writer.writeBool(m_isPaused);
+    writer.writeClock(m_curClock);
+}
+
+
+void IActive::loadClockState(SnapshotReader& reader)
+{
+    m_isPaused = reader.readBool();
+    m_curClock = reader.readClock();
+    updateSchedule();
+}
+
+
+void IActive::syncronize(uint64_t curClock)
+{
+    m_curClock = curClock;
+    updateSchedule();
+}
+
+
+void IActive::resume()
+{
+    m_isPaused = false;
+    updateSchedule();
+}
+
+
+void IActive::updateSchedule()
+{
+    g_emulation->getScheduler()->update(this);
 }
 
 
@@ -108,6 +145,7 @@ void IActive::syncronize()
 //}
 
 int AddressableDevice::m_lastTag;
+unsigned AddressableDevice::m_directPagesVersion = 0;
 
 uint8_t AddressableDevice::readByteEx(int addr, int& tag)
 {
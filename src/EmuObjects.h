@@ -28,6 +28,8 @@
 
 
 class Platform;
+class SnapshotWriter;
+class SnapshotReader;
 
 class EmuObject
 {
@@ -51,6 +53,10 @@ class EmuObject
 
         virtual std::string getDebugInfo() {return "";}
 
+        // Snapshot support: objects having internal state save and restore it
+        virtual void saveState(SnapshotWriter&) {}
+        virtual void loadState(SnapshotReader&) {}
+
     protected:
         int m_kDiv = 1;
         Platform* m_platform = nullptr;
@@ -74,7 +80,18 @@ class AddressableDevice : public EmuObject
 
         uint8_t readByteEx(int addr, int& tag);
 
-        void setAddrMask(int mask) {m_addrMask = mask;}
+        void setAddrMask(int mask) {m_addrMask = mask; invalidateDirectPages();}
+
+        // Direct memory access: returns host pointer to 256 bytes starting at addr
+        // (addr is 256-byte aligned in the caller's address space) if they may be accessed
+        // without side effects, nullptr otherwise
+        virtual uint8_t* getDirectPagePtr(int, bool /*write*/) {return nullptr;}
+
+        // Pointers obtained by getDirectPagePtr are valid until version changes
+        static unsigned getDirectPagesVersion() {return m_directPagesVersion;}
+
+        // Must be called on any change of memory mapping
+        static void invalidateDirectPages() {m_directPagesVersion++;}
 
     protected:
         int m_addrMask = 0;
@@ -83,6 +100,9 @@ class AddressableDevice : public EmuObject
         int m_tag = 0;
         static int m_lastTag;
 
+    private:
+        static unsigned m_directPagesVersion;
+
     private:
 };
 
@@ -95,16 +115,33 @@ class IActive
         uint64_t getClock() {return m_curClock;}
         //void setClock(uint64_t clock) {m_curClock = clock;}
         void pause() {m_isPaused = true; m_curClock = -1;}
-        void resume() {m_isPaused = false;}
-        void syncronize(uint64_t curClock) {m_curClock = curClock;}
+        void resume();
+        void syncronize(uint64_t curClock);
         void syncronize();
         inline bool isPaused() {return m_isPaused;}
         virtual void operate() = 0;
 
+        // Saves and restores device clock and paused state
+        void saveClockState(SnapshotWriter& writer);
+        void loadClockState(SnapshotReader& reader);
+
     protected:
         //int m_kDiv = 1;
         uint64_t m_curClock = 0;
         bool m_isPaused = false;
+
+        // Must be called after m_curClock has been decreased other than by syncronize() or resume()
+        void updateSchedule();
+
+    private:
+        friend class Scheduler;
+
+        // scheduler heap data
+        int m_schedPos = -1;
+        unsigned m_schedSeqNo = 0;
+        uint64_t m_schedClock = 0;
+
+        inline uint64_t getEffectiveClock() {return m_isPaused ? -1 : m_curClock;}
 };
 
 
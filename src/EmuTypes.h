@@ -35,6 +35,12 @@ struct EmuPixelData
     double prevAspectRatio;
 
     unsigned frameNo = 0;
+
+    // Area changed since the previous frame, whole frame if unknown (changedWidth < 0)
+    int changedX = 0;
+    int changedY = 0;
+    int changedWidth = -1;
+    int changedHeight = -1;
 };
 
 
@@ -78,7 +84,10 @@ enum SysReq
     SR_SCREENSHOT,
     SR_MUTE,
     SR_LOADRAMDISK,
-    SR_SAVERAMDISK
+    SR_SAVERAMDISK,
+    SR_SAVESTATE,
+    SR_LOADSTATE,
+    SR_REWIND
 };
 
 
@@ -97,6 +106,22 @@ struct PlatformInfo
 };
 
 
+// Benchmark results for the active platform
+struct EmuBenchResult
+{
+    std::string platformName;
+    uint64_t hostTime;          // ns
+    uint64_t cpuTime;           // ns
+    uint64_t rendererTime;      // ns
+    uint64_t mixerTime;         // ns
+    uint64_t rewindTime;        // ns
+    uint64_t otherTime;         // ns
+    double emulatedTime;        // s
+    uint64_t cpuClocks;
+    uint64_t instructions;
+};
+
+
 struct SelectItem
 {
     std::string value;
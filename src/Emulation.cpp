@@ -25,12 +25,16 @@
 #include "EmuObjects.h"
 #include "Emulation.h"
 #include "ConfigReader.h"
+#include "Cpu.h"
 #include "Platform.h"
 #include "EmuWindow.h"
 #include "EmuConfig.h"
 #include "SoundMixer.h"
 #include "WavReader.h"
 #include "FileLoader.h"
+#include "Snapshot.h"
+#include "GdbStub.h"
+#include "InputMovie.h"
 
 using namespace std;
 
@@ -86,10 +90,15 @@ Emulation::Emulation(int argc, char** argv)
 
 Emulation::~Emulation()
 {
+    delete m_gdbStub; // до удаления платформ, снимает точки останова
+    stopMovie();
+
     // Удяляем платформы с дочерними объектами
     for (auto it = m_platformList.begin(); it != m_platformList.end(); it++)
         delete (*it);
 
+    delete m_benchStats;
+
     delete m_config;
     delete m_wavReader; // перед m_mixer!
     delete m_mixer;
@@ -202,19 +211,15 @@ void Emulation::newPlatform(const string& platformName)
 
 void Emulation::registerActiveDevice(IActive* device)
 {
-    m_activeDevVector.push_back(device);
-    nDevices++;
-    m_activeDevices = m_activeDevVector.data();
-    inCycle = false;
+    m_scheduler.addDevice(device);
 }
 
 
 void Emulation::unregisterActiveDevice(IActive* device)
 {
-    m_activeDevVector.erase(remove(m_activeDevVector.begin(), m_activeDevVector.end(), device));
-    nDevices--;
-    m_activeDevices = m_activeDevVector.data();
-    inCycle = false;
+    m_scheduler.removeDevice(device);
+    if (m_benchStats)
+        m_benchStats->removeDevice(device);
 }
 
 
@@ -251,33 +256,45 @@ void Emulation::exec(uint64_t ticks)
     if (m_isPaused)
         return;
 
-    uint64_t toTime = m_curClock + ticks - m_clockOffset;
+    // nested call from device's operate() (file loading from input movie) runs exactly
+    // the given number of ticks and doesn't affect the main loop timing
+    bool isNested = m_isInExec;
+    uint64_t prevExecToTime = m_execToTime;
+
+    uint64_t toTime = m_curClock + ticks - (isNested ? 0 : m_clockOffset);
+    m_execToTime = toTime;
+    m_isInExec = true;
 
     while (m_curClock < toTime && !m_debugReqCpu) {
-        uint64_t time = -1;
-        IActive* curDev = nullptr;
-
-        inCycle = true;
-        IActive* device;
-        uint64_t tm;
-        for (int i = 0; i < nDevices && inCycle; i++) {
-            device = m_activeDevices[i];
-            if (!device->isPaused()) {
-                tm = device->getClock();
-                if (tm < time) {
-                    time = tm;
-                    curDev = device;
-                }
-            }
+        IActive* curDev = m_scheduler.getNextDevice();
+        if (!curDev) {
+            // nothing to run
+            m_curClock = toTime;
+            break;
         }
 
-        m_curClock = time;
-        curDev->operate();
+        m_curClock = curDev->getClock();
+        if (!m_benchStats)
+            curDev->operate();
+        else {
+            BenchSectionGuard guard(m_benchStats, m_benchStats->getDeviceSection(curDev));
+            curDev->operate();
+        }
+    }
+    m_isInExec = isNested;
+
+    if (isNested) {
+        m_execToTime = prevExecToTime;
+        return;
     }
+
     m_clockOffset = m_curClock - toTime;
 
     if (m_debugReqCpu) {
         m_clockOffset = 0;
+        // stops are reported to gdb if it's connected
+        if (m_gdbStub && m_gdbStub->cpuStopped(m_debugReqCpu))
+            return;
         // show debugger
         for (auto it = m_platformList.begin(); it != m_platformList.end(); it++)
         if ((*it)->getCpu() == m_debugReqCpu) {
@@ -291,6 +308,8 @@ void Emulation::exec(uint64_t ticks)
 
 void Emulation::draw()
 {
+    BenchSectionGuard guard(m_benchStats, BS_RENDERER);
+
     for (auto it = m_platformList.begin(); it != m_platformList.end(); it++) {
         (*it)->draw();
     }
@@ -301,7 +320,9 @@ void Emulation::processKey(EmuWindow* wnd, PalKeyCode keyCode, bool isPressed, u
 {
     // нужно отправлять клавишу только активной платформе
     Platform* platform = platformByWindow(wnd);
-    if (platform)
+    if (platform && m_movie && platform == m_movie->getPlatform())
+        m_movie->keyEvent(keyCode, isPressed, unicodeKey);
+    else if (platform)
         platform->processKey(keyCode, isPressed, unicodeKey);
     else if (keyCode != PK_NONE)
         wnd->processKey(keyCode, isPressed);
@@ -311,7 +332,9 @@ void Emulation::processKey(EmuWindow* wnd, PalKeyCode keyCode, bool isPressed, u
 void Emulation::resetKeys(EmuWindow* wnd)
 {
     Platform* platform = platformByWindow(wnd);
-    if (platform)
+    if (platform && m_movie && platform == m_movie->getPlatform())
+        m_movie->resetKeysEvent();
+    else if (platform)
         platform->resetKeys();
 }
 
@@ -324,6 +347,9 @@ void Emulation::sysReq(EmuWindow* wnd, SysReq sr)
     if (sr == SR_DEBUG)
         m_isPaused = false;
 
+    if (movieSysReq(platform, sr))
+        return;
+
     switch(sr) {
         case SR_EXIT:
             //for (auto it = m_platformList.begin(); it != m_platformList.end(); it++)
@@ -426,7 +452,28 @@ void Emulation::mainLoopCycle()
         dt = palGetCounterFreq() / 10;
     uint64_t ticks = m_frequency * m_speedUpFactor * dt / palGetCounterFreq();
     m_prevSysClock = m_sysClock;
+
+    // Audio output and system counter clocks drift apart, so emulation speed is slightly
+    // adjusted (by 0.5% max) to keep the audio queue near the target latency
+    int audioLatency = palGetAudioLatency();
+    if (audioLatency > 0 && m_speedUpFactor == 1) {
+        int correction = (audioLatency - palGetAudioQueueSize()) * 1000 / audioLatency; // in 1/1000
+        if (correction > 5)
+            correction = 5;
+        else if (correction < -5)
+            correction = -5;
+        ticks += (int64_t)ticks * correction / 1000;
+    }
+
+    if (m_gdbStub)
+        m_gdbStub->poll(m_platformList.empty() ? nullptr : m_platformList.front()->getCpu());
+
     exec(ticks);
+
+    // rewind states are captured between emulation cycles only
+    BenchSectionGuard guard(m_benchStats, BS_REWIND);
+    for (auto it = m_platformList.begin(); it != m_platformList.end(); it++)
+        (*it)->captureRewindState();
 }
 
 
@@ -481,7 +528,9 @@ void Emulation::restoreFocus()
 void Emulation::dropFile(EmuWindow* wnd, const string& fileName)
 {
     Platform* platform = platformByWindow(wnd);
-    if (platform)
+    if (platform && m_movie && platform == m_movie->getPlatform())
+        m_movie->loadFileEvent(fileName, true);
+    else if (platform)
         platform->loadFile(fileName);
 }
 
@@ -493,6 +542,73 @@ void Emulation::setSpeedUpFactor(unsigned speed)
 }
 
 
+void Emulation::setRewindOptions(unsigned depth, unsigned memoryLimit)
+{
+    m_rewindDepth = depth;
+    m_rewindMemoryLimit = memoryLimit;
+    for (auto it = m_platformList.begin(); it != m_platformList.end(); it++)
+        (*it)->updateRewindOptions();
+}
+
+
+void Emulation::setGdbPort(int port)
+{
+    if (m_gdbStub && m_gdbStub->getPort() == port)
+        return;
+
+    delete m_gdbStub;
+    m_gdbStub = port > 0 ? new GdbStub(port) : nullptr;
+}
+
+
+// Requests changing state of the movie platform are recorded to be applied by the movie
+// or ignored during playback, returns true if request is handled
+bool Emulation::movieSysReq(Platform* platform, SysReq sr)
+{
+    // wav reader is common for all platforms
+    if (!m_movie || (platform != m_movie->getPlatform() && sr != SR_LOADWAV))
+        return false;
+
+    bool isRecording = m_movie->isRecording();
+
+    switch (sr) {
+        case SR_RESET:
+        case SR_QUERTY:
+        case SR_JCUKEN:
+        case SR_SMART:
+            m_movie->sysReqEvent(sr);
+            break;
+        case SR_LOAD:
+        case SR_LOADRUN:
+            if (isRecording && platform->getLoader()) {
+                string fileName = platform->getLoader()->chooseFile();
+                if (fileName != "")
+                    m_movie->loadFileEvent(fileName, sr == SR_LOADRUN);
+            }
+            break;
+        case SR_LOADWAV:
+            if (!isRecording)
+                break;
+            if (m_wavReader->isPlaying())
+                m_movie->wavFileEvent("");
+            else {
+                string fileName = m_wavReader->chooseFile();
+                if (fileName != "")
+                    m_movie->wavFileEvent(fileName);
+            }
+            break;
+        case SR_LOADSTATE:
+        case SR_REWIND:
+            // not allowed during recording or playback
+            break;
+        default:
+            return false;
+    }
+
+    return true;
+}
+
+
 Platform* Emulation::platformByWindow(EmuWindow* window)
 {
     if (!window)
@@ -529,6 +645,15 @@ bool Emulation::setProperty(const string& propertyName, const EmuValuesList& val
     } else if (propertyName == "volume" && values[0].isInt()) {
         m_mixer->setVolume(values[0].asInt());
         return true;
+    } else if (propertyName == "rewindDepth" && values[0].isInt()) {
+        setRewindOptions(values[0].asInt(), m_rewindMemoryLimit);
+        return true;
+    } else if (propertyName == "rewindMemory" && values[0].isInt()) {
+        setRewindOptions(m_rewindDepth, values[0].asInt());
+        return true;
+    } else if (propertyName == "gdbPort" && values[0].isInt()) {
+        setGdbPort(values[0].asInt());
+        return true;
     } else if (propertyName == "runPlatform") {
         if (!m_platformCreatedFromCmdLine) // если уже было создано окно из командной строки, больше не создаем
             runPlatform(values[0].asString());
@@ -569,6 +694,18 @@ string Emulation::getPropertyStringValue(const string& propertyName)
         stringstream stringStream;
         stringStream << m_mixer->getVolume();
         stringStream >> res;
+    } else if (propertyName == "rewindDepth") {
+        stringstream stringStream;
+        stringStream << m_rewindDepth;
+        stringStream >> res;
+    } else if (propertyName == "rewindMemory") {
+        stringstream stringStream;
+        stringStream << m_rewindMemoryLimit;
+        stringStream >> res;
+    } else if (propertyName == "gdbPort") {
+        stringstream stringStream;
+        stringStream << (m_gdbStub ? m_gdbStub->getPort() : 0);
+        stringStream >> res;
     } else if (propertyName == "debug8080MnemoUpperCase")
         res = m_debuggerOptions.mnemo8080UpperCase ? "yes" : "no";
     else if (propertyName == "debugZ80MnemoUpperCase")
@@ -586,3 +723,129 @@ string Emulation::getPropertyStringValue(const string& propertyName)
     }*/
     return res;
 }
+
+
+void Emulation::startBenchmark()
+{
+    if (!m_benchStats)
+        m_benchStats = new BenchStats;
+    m_benchStats->reset();
+
+    m_benchStartClock = m_curClock;
+    m_benchStartInstrCount = 0;
+    if (!m_platformList.empty() && m_platformList.front()->getCpu())
+        m_benchStartInstrCount = m_platformList.front()->getCpu()->getInstrCount();
+}
+
+
+bool Emulation::getBenchmarkResult(EmuBenchResult& result)
+{
+    if (!m_benchStats || m_platformList.empty())
+        return false;
+
+    Platform* platform = m_platformList.front();
+    Cpu* cpu = platform->getCpu();
+    if (!cpu)
+        return false;
+
+    result.platformName = platform->getName();
+    result.hostTime = m_benchStats->getTotalTime();
+    result.cpuTime = m_benchStats->getSectionTime(BS_CPU);
+    result.rendererTime = m_benchStats->getSectionTime(BS_RENDERER);
+    result.mixerTime = m_benchStats->getSectionTime(BS_MIXER);
+    result.rewindTime = m_benchStats->getSectionTime(BS_REWIND);
+    result.otherTime = m_benchStats->getSectionTime(BS_OTHER);
+    result.emulatedTime = double(m_curClock - m_benchStartClock) / m_frequency;
+    result.cpuClocks = (m_curClock - m_benchStartClock) / cpu->getKDiv();
+    result.instructions = cpu->getInstrCount() - m_benchStartInstrCount;
+
+    return true;
+}
+
+
+bool Emulation::saveSnapshot(const string& fileName)
+{
+    if (m_platformList.empty())
+        return false;
+    return m_platformList.front()->saveSnapshot(fileName);
+}
+
+
+bool Emulation::loadSnapshot(const string& fileName)
+{
+    if (m_platformList.empty())
+        return false;
+    return m_platformList.front()->loadSnapshot(fileName);
+}
+
+
+
+bool Emulation::getStateHashes(vector<pair<string, uint64_t> >& hashes)
+{
+    hashes.clear();
+    if (m_platformList.empty())
+        return false;
+
+    SnapshotWriter writer(m_curClock);
+    m_platformList.front()->saveState(writer);
+
+    SnapshotReader reader(writer.getData().data(), writer.getData().size());
+    reader.readString();
+    while (reader.isValid() && !reader.isEnd()) {
+        string name;
+        SnapshotReader sectionReader(nullptr, 0);
+        if (!reader.readSection(name, sectionReader))
+            return false;
+
+        // FNV-1a
+        uint64_t hash = 0xcbf29ce484222325;
+        const uint8_t* data = sectionReader.getData();
+        for (unsigned i = 0; i < sectionReader.getSize(); i++)
+            hash = (hash ^ data[i]) * 0x100000001b3;
+        hashes.push_back(make_pair(name, hash));
+    }
+
+    return true;
+}
+
+
+bool Emulation::startMovieRecording(const string& fileName)
+{
+    stopMovie();
+    if (m_platformList.empty())
+        return false;
+
+    m_movie = new InputMovie(m_platformList.front());
+    if (!m_movie->startRecording(fileName)) {
+        stopMovie();
+        return false;
+    }
+    return true;
+}
+
+
+bool Emulation::startMoviePlayback(const string& fileName)
+{
+    stopMovie();
+    if (m_platformList.empty())
+        return false;
+
+    m_movie = new InputMovie(m_platformList.front());
+    if (!m_movie->startPlayback(fileName)) {
+        stopMovie();
+        return false;
+    }
+    return true;
+}
+
+
+bool Emulation::stopMovie()
+{
+    if (!m_movie)
+        return true;
+
+    bool res = m_movie->stop();
+    delete m_movie;
+    m_movie = nullptr;
+    return res;
+}
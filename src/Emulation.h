@@ -26,6 +26,8 @@
 #include "PalKeys.h"
 #include "EmuTypes.h"
 #include "EmuObjects.h"
+#include "Scheduler.h"
+#include "BenchStats.h"
 
 class Cpu;
 class EmuWindow;
@@ -33,15 +35,10 @@ class SoundMixer;
 class EmuConfig;
 class WavReader;
 class Platform;
+class GdbStub;
+class InputMovie;
 
 
-/*struct DevListItem
-{
-    uint64_t clock;
-    ActiveDevice* device;
-    DevListItem* next;
-};*/
-
 struct DebuggerOptions {
     bool mnemo8080UpperCase = true;
     bool mnemoZ80UpperCase = false;
@@ -82,8 +79,13 @@ class Emulation : public ParentObject
         void mainLoopCycle();
         void exec(uint64_t ticks);
 
+        // Called by a device from its operate() to check if it may run the next step
+        // without returning to the scheduler; updates current clock if so
+        inline bool continueBatch(IActive* device);
+
         //inline Platform* getPlatform() {return m_platform;} //!!!
         inline uint64_t getCurClock() {return m_curClock;}
+        inline Scheduler* getScheduler() {return &m_scheduler;}
         inline SoundMixer* getSoundMixer() {return m_mixer;}
         inline EmuConfig* getConfig() {return m_config;}
         inline WavReader* getWavReader() {return m_wavReader;}
@@ -96,6 +98,11 @@ class Emulation : public ParentObject
         void setVsync(bool vsync);                      // установка vsync
         bool getVsync() {return m_vsync;}
         void setSpeedUpFactor(unsigned speed);
+        void setRewindOptions(unsigned depth, unsigned memoryLimit);
+        unsigned getRewindDepth() {return m_rewindDepth;}              // s, 0 - rewind disabled
+        unsigned getRewindMemoryLimit() {return m_rewindMemoryLimit;}  // MB per platform
+        void setGdbPort(int port);                      // 0 - gdb stub disabled
+        GdbStub* getGdbStub() {return m_gdbStub;}
 
         unsigned getSpeedUpFactor() {return m_speedUpFactor;}
         bool getPausedState() {return m_isPaused;}
@@ -104,15 +111,38 @@ class Emulation : public ParentObject
 
         const DebuggerOptions& getDebuggerOptions() {return m_debuggerOptions;}
 
+        // Benchmark mode, stats are collected only after startBenchmark() call
+        void startBenchmark();
+        bool getBenchmarkResult(EmuBenchResult& result);
+        inline BenchStats* getBenchStats() {return m_benchStats;}
+
+        // Save states of the first platform
+        bool saveSnapshot(const std::string& fileName);
+        bool loadSnapshot(const std::string& fileName);
+
+        // Hashes of the first platform state sections, used to compare runs
+        bool getStateHashes(std::vector<std::pair<std::string, uint64_t> >& hashes);
+
+        // Input movie of the first platform, stopMovie() writes recorded movie file
+        bool startMovieRecording(const std::string& fileName);
+        bool startMoviePlayback(const std::string& fileName);
+        bool stopMovie();
+        InputMovie* getMovie() {return m_movie;}
+
     private:
-        std::vector<IActive*> m_activeDevVector;
-        IActive** m_activeDevices = nullptr;
-        int nDevices = 0;
-        bool inCycle;
+        Scheduler m_scheduler;
         uint64_t m_clockOffset = 0;
+        uint64_t m_execToTime = 0;
         uint64_t m_sysClock;
         uint64_t m_prevSysClock = 0;
         Cpu* m_debugReqCpu = nullptr;
+        GdbStub* m_gdbStub = nullptr;
+        InputMovie* m_movie = nullptr;
+        bool m_isInExec = false;
+
+        BenchStats* m_benchStats = nullptr;
+        uint64_t m_benchStartClock = 0;
+        uint64_t m_benchStartInstrCount = 0;
 
         bool m_isPaused = false;
         unsigned m_speedUpFactor = 1;
@@ -121,6 +151,8 @@ class Emulation : public ParentObject
         unsigned m_frameRate;
         bool m_vsync;
         unsigned m_sampleRate;
+        unsigned m_rewindDepth = 0;
+        unsigned m_rewindMemoryLimit = 64;
 
         std::list<EmuObject*> m_objectList;
         std::list<Platform*> m_platformList;
@@ -134,6 +166,7 @@ class Emulation : public ParentObject
         Platform* m_lastActivePlatform = nullptr;
 
         Platform* platformByWindow(EmuWindow* window);
+        bool movieSysReq(Platform* platform, SysReq sr);
 
         void checkPlatforms();
 
@@ -148,5 +181,16 @@ class Emulation : public ParentObject
 };
 
 
+inline bool Emulation::continueBatch(IActive* device)
+{
+    uint64_t clock = device->getClock();
+    if (clock >= m_execToTime || m_debugReqCpu || !m_scheduler.isNextDevice(device))
+        return false;
+
+    m_curClock = clock;
+    return true;
+}
+
+
 #endif  // EMULATION_H
 
@@ -18,6 +18,8 @@
 
 #include <string.h>
 
+#include <algorithm>
+
 #include "Eureka.h"
 #include "Emulation.h"
 #include "SoundMixer.h"
@@ -132,33 +134,68 @@ void EurekaRenderer::renderFrame()
         m_aspectRatio = 576.0 * 9 / 704 / 8;
     }
 
-    int offset = offsetY * m_sizeX + offsetX;
-
-    if (m_colorMode) {
-        // color mode
-        for (int row = 0; row < 256; row++)
-            for (int col = 0; col < 48; col++) {
-                int addr = col * 256 + row;
-                uint8_t bt = m_videoRam[addr];
-                for (int pt = 0; pt < 4; pt++, bt <<= 2) {
-                    uint32_t color = eurekaPalette[(bt & 0xC0) >> 6];
-                    m_pixelData[offset + row * m_sizeX + col * 8 + pt * 2] = color;
-                    m_pixelData[offset + row * m_sizeX + col * 8 + pt * 2 + 1] = color;
-                }
-            }
-    } else {
-        // b&w mode
-        for (int row = 0; row < 256; row++)
-            for (int col = 0; col < 48; col++) {
-                int addr = col * 256 + row;
-                uint8_t bt = m_videoRam[addr];
-                for (int pt = 0; pt < 8; pt++, bt <<= 1)
-                    m_pixelData[offset + row * m_sizeX + col * 8 + pt] = (bt & 0x80) ? 0xC0C0C0 : 0x000000;
+    bool fullUpdate = !m_isImageValid || m_colorMode != m_imageColorMode;
+    if (fullUpdate) {
+        m_imageColorMode = m_colorMode;
+        m_frameImage.resize(384 * 256);
+        m_isImageValid = true;
+    }
+
+    const int blockSize = 1 << Ram::DIRTY_BLOCK_SHIFT;
+    int minCol = 48, maxCol = -1, minRow = 256, maxRow = -1;
+
+    for (int col = 0; col < 48; col++)
+        for (int row = 0; row < 256; row += blockSize) {
+            if (!fullUpdate && !m_videoRamObj->isBlockDirty(col * 256 + row))
+                continue;
+            renderBlock(col, row, blockSize);
+            minCol = min(minCol, col);
+            maxCol = col;
+            minRow = min(minRow, row);
+            maxRow = max(maxRow, row + blockSize - 1);
+        }
+
+    m_videoRamObj->clearDirtyBlocks();
+
+    for (int row = 0; row < 256; row++)
+        memcpy(m_pixelData + (row + offsetY) * m_sizeX + offsetX, m_frameImage.data() + row * 384, 384 * sizeof(uint32_t));
+
+    if (maxCol >= 0)
+        setChangedRect(offsetX + minCol * 8, offsetY + minRow, (maxCol - minCol + 1) * 8, maxRow - minRow + 1);
+    else
+        setChangedRect(0, 0, 0, 0);
+}
+
+
+void EurekaRenderer::renderBlock(int col, int row, int nRows)
+{
+    for (; nRows > 0; row++, nRows--) {
+        uint8_t bt = m_videoRam[col * 256 + row];
+        uint32_t* ptr = m_frameImage.data() + row * 384 + col * 8;
+        if (m_colorMode) {
+            // color mode
+            for (int pt = 0; pt < 4; pt++, bt <<= 2) {
+                uint32_t color = eurekaPalette[(bt & 0xC0) >> 6];
+                ptr[pt * 2] = color;
+                ptr[pt * 2 + 1] = color;
             }
+        } else {
+            // b&w mode
+            for (int pt = 0; pt < 8; pt++, bt <<= 1)
+                ptr[pt] = (bt & 0x80) ? 0xC0C0C0 : 0x000000;
+        }
     }
 }
 
 
+void EurekaRenderer::attachVideoRam(Ram* videoRam)
+{
+    m_videoRamObj = videoRam;
+    m_videoRam = videoRam->getDataPtr();
+    videoRam->setWriteTracking(0, videoRam->getSize());
+}
+
+
 void EurekaRenderer::toggleCropping()
 {
     m_showBorder = !m_showBorder;
@@ -55,15 +55,23 @@ class EurekaRenderer : public CrtRenderer
         bool setProperty(const std::string& propertyName, const EmuValuesList& values) override;
         std::string getPropertyStringValue(const std::string& propertyName) override;
 
-        inline void attachVideoRam(Ram* videoRam) {m_videoRam = videoRam->getDataPtr();}
+        void attachVideoRam(Ram* videoRam);
         inline void setColorMode(bool colorMode) {m_colorMode = colorMode;}
 
         static EmuObject* create(const EmuValuesList&) {return new EurekaRenderer();}
 
     private:
+        Ram* m_videoRamObj = nullptr;
         const uint8_t* m_videoRam = nullptr;
         bool m_colorMode = false;
         bool m_showBorder = false;
+
+        // 384x256 image updated for the written video memory blocks only
+        std::vector<uint32_t> m_frameImage;
+        bool m_imageColorMode = false;
+        bool m_isImageValid = false;
+
+        void renderBlock(int col, int row, int nRows);
 };
 
 
@@ -21,6 +21,7 @@
 #include "Emulation.h"
 #include "Platform.h"
 #include "EmuWindow.h"
+#include "Snapshot.h"
 
 using namespace std;
 
@@ -222,3 +223,23 @@ string FdImage::getPropertyStringValue(const string& propertyName)
 
     return "";
 }
+
+
+void FdImage::saveState(SnapshotWriter& writer)
+{
+    writer.writeInt(m_curTrack);
+    writer.writeInt(m_curHead);
+    writer.writeInt(m_curSector);
+    writer.writeInt(m_curSectorOffset);
+}
+
+
+void FdImage::loadState(SnapshotReader& reader)
+{
+    m_curTrack = reader.readInt();
+    m_curHead = reader.readInt();
+    m_curSector = reader.readInt();
+    m_curSectorOffset = reader.readInt();
+    if (m_file.isOpen() && m_curSectorOffset)
+        seek(m_curSectorOffset);
+}
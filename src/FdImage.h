@@ -58,6 +58,10 @@ class FdImage : public EmuObject
         void writeNextByte(uint8_t bt);
         void writeByte(int offset, uint8_t bt);
 
+        // only head position is saved, image contents stay in the file
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
+
         static EmuObject* create(const EmuValuesList& parameters) {return new FdImage(parameters[0].asInt(), parameters[1].asInt(), parameters[2].asInt(), parameters[3].asInt());} // add check!
 
     private:
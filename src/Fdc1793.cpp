@@ -25,6 +25,7 @@
 #include "FdImage.h"
 #include "Emulation.h"
 #include "Dma8257.h"
+#include "Snapshot.h"
 
 using namespace std;
 
@@ -338,6 +339,40 @@ uint8_t Fdc1793::readByte(int addr)
 }
 
 
+void Fdc1793::saveState(SnapshotWriter& writer)
+{
+    writer.writeInt(m_accessMode);
+    writer.writeInt(m_disk);
+    writer.writeInt(m_head);
+    writer.write8(m_track);
+    writer.write8(m_sector);
+    writer.write8(m_data);
+    writer.write8(m_status);
+    writer.writeBool(m_directionIn);
+    writer.writeBool(m_irq);
+    writer.writeInt(m_lastCommand);
+    writer.writeInt(m_addressIdCnt);
+    writer.writeBuf(m_addressId, sizeof(m_addressId));
+}
+
+
+void Fdc1793::loadState(SnapshotReader& reader)
+{
+    m_accessMode = FdcAccessMode(reader.readInt());
+    m_disk = reader.readInt();
+    m_head = reader.readInt();
+    m_track = reader.read8();
+    m_sector = reader.read8();
+    m_data = reader.read8();
+    m_status = reader.read8();
+    m_directionIn = reader.readBool();
+    m_irq = reader.readBool();
+    m_lastCommand = reader.readInt();
+    m_addressIdCnt = reader.readInt();
+    reader.readBuf(m_addressId, sizeof(m_addressId));
+}
+
+
 void Fdc1793::generateInt()
 {
     m_irq = true;
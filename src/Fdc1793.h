@@ -51,6 +51,9 @@ class Fdc1793 : public AddressableDevice
         void writeByte(int addr, uint8_t value) override;
         uint8_t readByte(int addr) override;
 
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
+
 
         void setDrive(int drive);
         void setHead(int head);
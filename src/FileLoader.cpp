@@ -46,8 +46,7 @@ void FileLoader::setFilter(const std::string& filter)
 
 bool FileLoader::chooseAndLoadFile(bool run)
 {
-    string fileName = palOpenFileDialog("Open file", m_filter, false, m_platform->getWindow());
-    g_emulation->restoreFocus();
+    string fileName = chooseFile();
     if (fileName == "")
         return true;
     if (!loadFile(fileName, run)) {
@@ -58,6 +57,14 @@ bool FileLoader::chooseAndLoadFile(bool run)
 }
 
 
+string FileLoader::chooseFile()
+{
+    string fileName = palOpenFileDialog("Open file", m_filter, false, m_platform->getWindow());
+    g_emulation->restoreFocus();
+    return fileName;
+}
+
+
 bool FileLoader::setProperty(const std::string& propertyName, const EmuValuesList& values)
 {
     if (EmuObject::setProperty(propertyName, values))
@@ -36,6 +36,7 @@ class FileLoader : public EmuObject
         virtual bool loadFile(const std::string& fileName, bool run = false) = 0;
 
         bool chooseAndLoadFile(bool run = false);
+        std::string chooseFile();
         void setFilter(const std::string& filter);
         void attachAddrSpace(AddressableDevice* as);
         void attachTapeRedirector(TapeRedirector* tapeRedirector);
@@ -0,0 +1,635 @@
+﻿/*
+ *  Emu80 v. 4.x
+ *  © Viktor Pykhonin <pyk@mail.ru>, 2016-2019
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+    #include <winsock2.h>
+    typedef int socklen_t;
+#else
+    #include <sys/socket.h>
+    #include <netinet/in.h>
+    #include <netinet/tcp.h>
+    #include <arpa/inet.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <errno.h>
+    #define INVALID_SOCKET (-1)
+    #define closesocket close
+#endif
+
+#ifndef MSG_NOSIGNAL
+    #define MSG_NOSIGNAL 0
+#endif
+
+#include "Pal.h"
+
+#include "GdbStub.h"
+#include "Globals.h"
+#include "Emulation.h"
+#include "Cpu.h"
+#include "CpuZ80.h"
+#include "Debugger.h"
+#include "Watchpoints.h"
+
+using namespace std;
+
+
+static const unsigned maxPacketSize = 4096; // reported to gdb as PacketSize
+
+static const char hexDigits[] = "0123456789abcdef";
+
+
+static void appendHex8(string& s, uint8_t value)
+{
+    s += hexDigits[value >> 4];
+    s += hexDigits[value & 0xF];
+}
+
+
+static void appendHex16(string& s, uint16_t value)
+{
+    // target byte order
+    appendHex8(s, value & 0xFF);
+    appendHex8(s, value >> 8);
+}
+
+
+static unsigned parseHex(const string& s)
+{
+    return strtoul(s.c_str(), nullptr, 16);
+}
+
+
+static uint16_t parseHex16(const string& s)
+{
+    return parseHex(s.substr(0, 2)) | (parseHex(s.substr(2, 2)) << 8);
+}
+
+
+static void setNonBlocking(GdbSocket s)
+{
+#ifdef _WIN32
+    u_long mode = 1;
+    ioctlsocket(s, FIONBIO, &mode);
+#else
+    fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK);
+#endif
+}
+
+
+static bool wouldBlock()
+{
+#ifdef _WIN32
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+}
+
+
+GdbStub::GdbStub(int port)
+{
+    m_port = port;
+    m_socket = INVALID_SOCKET;
+
+#ifdef _WIN32
+    WSADATA wsaData;
+    WSAStartup(MAKEWORD(2, 2), &wsaData);
+#endif
+
+    m_listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+    if (m_listenSocket == GdbSocket(INVALID_SOCKET))
+        return;
+
+    int reuse = 1;
+    setsockopt(m_listenSocket, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // local connections only
+    addr.sin_port = htons(port);
+
+    if (bind(m_listenSocket, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(m_listenSocket, 1) != 0) {
+        emuLog << "gdb stub: can't listen on port " << port << "\n";
+        closesocket(m_listenSocket);
+        m_listenSocket = INVALID_SOCKET;
+        return;
+    }
+
+    setNonBlocking(m_listenSocket);
+}
+
+
+GdbStub::~GdbStub()
+{
+    closeConnection();
+
+    if (m_listenSocket != GdbSocket(INVALID_SOCKET))
+        closesocket(m_listenSocket);
+
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+
+void GdbStub::poll(Cpu* cpu)
+{
+    if (m_listenSocket == GdbSocket(INVALID_SOCKET))
+        return;
+
+    if (m_socket == GdbSocket(INVALID_SOCKET)) {
+        m_socket = accept(m_listenSocket, nullptr, nullptr);
+        if (m_socket == GdbSocket(INVALID_SOCKET))
+            return;
+
+        if (!cpu) {
+            closesocket(m_socket);
+            m_socket = INVALID_SOCKET;
+            return;
+        }
+
+        setNonBlocking(m_socket);
+        int noDelay = 1;
+        setsockopt(m_socket, IPPROTO_TCP, TCP_NODELAY, (const char*)&noDelay, sizeof(noDelay));
+
+        m_cpu = static_cast<Cpu8080Compatible*>(cpu);
+        m_noAck = false;
+        m_inBuf.clear();
+
+        // gdb expects the target to be stopped after connection
+        m_running = false;
+        m_interrupted = false;
+        g_emulation->debugRequest(m_cpu);
+    }
+
+    processInput();
+}
+
+
+bool GdbStub::cpuStopped(Cpu* cpu)
+{
+    if (m_socket == GdbSocket(INVALID_SOCKET) || cpu != m_cpu)
+        return false;
+
+    if (m_running) {
+        m_running = false;
+        sendStopReply();
+    }
+    return true;
+}
+
+
+void GdbStub::detachCpu(Cpu* cpu)
+{
+    if (cpu == m_cpu)
+        closeConnection();
+}
+
+
+void GdbStub::closeConnection()
+{
+    if (m_socket == GdbSocket(INVALID_SOCKET))
+        return;
+
+    removeBreakpoints();
+
+    closesocket(m_socket);
+    m_socket = INVALID_SOCKET;
+    m_inBuf.clear();
+
+    // emulation continues without gdb
+    if (!m_running)
+        g_emulation->debugRun();
+    m_running = false;
+    m_cpu = nullptr;
+}
+
+
+void GdbStub::removeBreakpoints()
+{
+    for (auto it = m_breakpoints.begin(); it != m_breakpoints.end(); it++)
+        delete it->second;
+    m_breakpoints.clear();
+
+    for (auto it = m_watchpoints.begin(); it != m_watchpoints.end(); it++)
+        m_cpu->getWatchpoints()->removeWatchpoint(it->second);
+    m_watchpoints.clear();
+}
+
+
+void GdbStub::processInput()
+{
+    char buf[4096];
+    for (;;) {
+        int n = recv(m_socket, buf, sizeof(buf), 0);
+        if (n > 0)
+            m_inBuf.append(buf, n);
+        else if (n < 0 && wouldBlock())
+            break;
+        else {
+            // disconnected
+            closeConnection();
+            return;
+        }
+    }
+
+    size_t pos = 0;
+    while (pos < m_inBuf.size()) {
+        char c = m_inBuf[pos];
+        if (c == '\x03') {
+            // break request
+            if (m_running) {
+                m_interrupted = true;
+                g_emulation->debugRequest(m_cpu);
+            }
+            pos++;
+        } else if (c == '$') {
+            size_t end = m_inBuf.find('#', pos);
+            if (end == string::npos || end + 2 >= m_inBuf.size())
+                break; // incomplete packet
+
+            string packet = m_inBuf.substr(pos + 1, end - pos - 1);
+            unsigned checksum = parseHex(m_inBuf.substr(end + 1, 2));
+            pos = end + 3;
+
+            uint8_t sum = 0;
+            for (unsigned i = 0; i < packet.size(); i++)
+                sum += packet[i];
+            bool ok = sum == checksum;
+
+            if (!m_noAck)
+                send(m_socket, ok ? "+" : "-", 1, MSG_NOSIGNAL);
+            if (ok)
+                processPacket(packet);
+
+            if (m_socket == GdbSocket(INVALID_SOCKET))
+                return; // closed on detach or kill
+        } else
+            pos++; // acks
+    }
+    m_inBuf.erase(0, pos);
+}
+
+
+void GdbStub::sendPacket(const string& data)
+{
+    uint8_t sum = 0;
+    for (unsigned i = 0; i < data.size(); i++)
+        sum += data[i];
+
+    string packet;
+    packet.reserve(data.size() + 4);
+    packet += '$';
+    packet += data;
+    packet += '#';
+    appendHex8(packet, sum);
+
+    const char* ptr = packet.data();
+    int len = packet.size();
+    while (len > 0) {
+        int n = send(m_socket, ptr, len, MSG_NOSIGNAL);
+        if (n > 0) {
+            ptr += n;
+            len -= n;
+        } else if (n < 0 && !wouldBlock())
+            return; // connection error, will be closed on next receive
+    }
+}
+
+
+void GdbStub::sendStopReply()
+{
+    WatchpointSpace* watchSpace = m_cpu->getWatchpoints();
+    const Watchpoint* wp = watchSpace->getHitWatchpoint();
+
+    if (m_interrupted)
+        sendPacket("S02"); // SIGINT
+    else if (wp) {
+        string reply = wp->type == WT_WRITE ? "T05watch:" : (wp->type == WT_READ ? "T05rwatch:" : "T05awatch:");
+        appendHex8(reply, watchSpace->getHitAddr() >> 8);
+        appendHex8(reply, watchSpace->getHitAddr() & 0xFF);
+        reply += ';';
+        watchSpace->clearHit();
+        sendPacket(reply);
+    } else
+        sendPacket("S05"); // SIGTRAP
+}
+
+
+void GdbStub::resume(bool step)
+{
+    // breakpoint at the current PC shouldn't stop the CPU right away
+    auto it = m_breakpoints.find(m_cpu->getPC());
+    if (it != m_breakpoints.end())
+        it->second->setSkipCount(1);
+
+    if (step)
+        m_cpu->debugStepRequest();
+
+    m_running = true;
+    m_interrupted = false;
+    g_emulation->debugRun();
+}
+
+
+void GdbStub::processPacket(const string& packet)
+{
+    char cmd = packet.empty() ? 0 : packet[0];
+    string args = packet.size() > 1 ? packet.substr(1) : "";
+
+    switch (cmd) {
+        case '?':
+            sendStopReply();
+            break;
+        case 'g':
+            sendPacket(readRegisters());
+            break;
+        case 'G':
+            writeRegisters(args);
+            sendPacket("OK");
+            break;
+        case 'p': {
+            int reg = parseHex(args);
+            if (reg >= 0 && reg < getNumRegisters()) {
+                string reply;
+                appendHex16(reply, getRegister(reg));
+                sendPacket(reply);
+            } else
+                sendPacket("E01");
+            break;
+        }
+        case 'P': {
+            size_t eq = args.find('=');
+            int reg = parseHex(args.substr(0, eq));
+            if (eq != string::npos && reg >= 0 && reg < getNumRegisters()) {
+                setRegister(reg, parseHex16(args.substr(eq + 1)));
+                sendPacket("OK");
+            } else
+                sendPacket("E01");
+            break;
+        }
+        case 'm':
+            sendPacket(readMemory(args));
+            break;
+        case 'M':
+            sendPacket(writeMemory(args) ? "OK" : "E01");
+            break;
+        case 'c':
+        case 's':
+            // reply is sent when CPU stops
+            if (!args.empty())
+                m_cpu->setPC(parseHex(args));
+            resume(cmd == 's');
+            break;
+        case 'Z':
+        case 'z':
+            sendPacket(setBreakpoint(args, cmd == 'Z'));
+            break;
+        case 'D':
+            sendPacket("OK");
+            closeConnection();
+            break;
+        case 'k':
+            closeConnection();
+            break;
+        case 'H':
+        case 'T':
+            sendPacket("OK");
+            break;
+        case 'q':
+            if (packet.compare(0, 10, "qSupported") == 0) {
+                char reply[64];
+                snprintf(reply, sizeof(reply), "PacketSize=%x;QStartNoAckMode+", maxPacketSize);
+                sendPacket(reply);
+            } else if (packet == "qAttached")
+                sendPacket("1");
+            else if (packet == "qC")
+                sendPacket("QC1");
+            else if (packet == "qfThreadInfo")
+                sendPacket("m1");
+            else if (packet == "qsThreadInfo")
+                sendPacket("l");
+            else
+                sendPacket("");
+            break;
+        case 'Q':
+            if (packet == "QStartNoAckMode") {
+                sendPacket("OK");
+                m_noAck = true;
+            } else
+                sendPacket("");
+            break;
+        default:
+            // unsupported
+            sendPacket("");
+            break;
+    }
+}
+
+
+int GdbStub::getNumRegisters()
+{
+    return m_cpu->getType() == Cpu::CPU_Z80 ? 13 : 6;
+}
+
+
+uint16_t GdbStub::getRegister(int reg)
+{
+    CpuZ80* z80 = static_cast<CpuZ80*>(m_cpu);
+
+    switch (reg) {
+        case 0:
+            return m_cpu->getAF();
+        case 1:
+            return m_cpu->getBC();
+        case 2:
+            return m_cpu->getDE();
+        case 3:
+            return m_cpu->getHL();
+        case 4:
+            return m_cpu->getSP();
+        case 5:
+            return m_cpu->getPC();
+        case 6:
+            return z80->getIX();
+        case 7:
+            return z80->getIY();
+        case 8:
+            return z80->getAF2();
+        case 9:
+            return z80->getBC2();
+        case 10:
+            return z80->getDE2();
+        case 11:
+            return z80->getHL2();
+        case 12:
+            return z80->getIR();
+        default:
+            return 0;
+    }
+}
+
+
+void GdbStub::setRegister(int reg, uint16_t value)
+{
+    CpuZ80* z80 = static_cast<CpuZ80*>(m_cpu);
+
+    switch (reg) {
+        case 0:
+            m_cpu->setAF(value);
+            break;
+        case 1:
+            m_cpu->setBC(value);
+            break;
+        case 2:
+            m_cpu->setDE(value);
+            break;
+        case 3:
+            m_cpu->setHL(value);
+            break;
+        case 4:
+            m_cpu->setSP(value);
+            break;
+        case 5:
+            m_cpu->setPC(value);
+            break;
+        case 6:
+            z80->setIX(value);
+            break;
+        case 7:
+            z80->setIY(value);
+            break;
+        case 8:
+            z80->setAF2(value);
+            break;
+        case 9:
+            z80->setBC2(value);
+            break;
+        case 10:
+            z80->setDE2(value);
+            break;
+        case 11:
+            z80->setHL2(value);
+            break;
+        case 12:
+            z80->setIR(value);
+            break;
+        default:
+            break;
+    }
+}
+
+
+string GdbStub::readRegisters()
+{
+    string res;
+    for (int i = 0; i < getNumRegisters(); i++)
+        appendHex16(res, getRegister(i));
+    return res;
+}
+
+
+void GdbStub::writeRegisters(const string& hex)
+{
+    for (int i = 0; i < getNumRegisters() && (i + 1) * 4 <= int(hex.size()); i++)
+        setRegister(i, parseHex16(hex.substr(i * 4, 4)));
+}
+
+
+// m addr,len - the whole block is sent in one reply limited by the packet size
+string GdbStub::readMemory(const string& args)
+{
+    size_t comma = args.find(',');
+    if (comma == string::npos)
+        return "E01";
+
+    unsigned addr = parseHex(args.substr(0, comma));
+    unsigned len = parseHex(args.substr(comma + 1));
+    if (len > maxPacketSize / 2)
+        len = maxPacketSize / 2;
+
+    AddressableDevice* as = m_cpu->getAddrSpace();
+    string res;
+    res.reserve(len * 2);
+    for (unsigned i = 0; i < len; i++)
+        appendHex8(res, as->readByte((addr + i) & 0xFFFF));
+    return res;
+}
+
+
+// M addr,len:data
+bool GdbStub::writeMemory(const string& args)
+{
+    size_t comma = args.find(',');
+    size_t colon = args.find(':');
+    if (comma == string::npos || colon == string::npos || colon < comma)
+        return false;
+
+    unsigned addr = parseHex(args.substr(0, comma));
+    unsigned len = parseHex(args.substr(comma + 1, colon - comma - 1));
+    string data = args.substr(colon + 1);
+    if (data.size() < len * 2)
+        return false;
+
+    AddressableDevice* as = m_cpu->getAddrSpace();
+    for (unsigned i = 0; i < len; i++)
+        as->writeByte((addr + i) & 0xFFFF, parseHex(data.substr(i * 2, 2)));
+    return true;
+}
+
+
+// Z/z type,addr,kind: 0, 1 - code breakpoints, 2 - write, 3 - read, 4 - access watchpoints
+string GdbStub::setBreakpoint(const string& args, bool insert)
+{
+    string bpArgs = args.substr(0, args.find(';')); // conditions are not supported
+
+    int type;
+    unsigned addr, kind;
+    if (sscanf(bpArgs.c_str(), "%d,%x,%x", &type, &addr, &kind) != 3)
+        return "E01";
+    addr &= 0xFFFF;
+
+    if (type == 0 || type == 1) {
+        auto it = m_breakpoints.find(addr);
+        if (insert && it == m_breakpoints.end()) {
+            CodeBreakpoint* bp = new CodeBreakpoint(addr);
+            m_cpu->addHook(bp);
+            m_breakpoints[addr] = bp;
+        } else if (!insert && it != m_breakpoints.end()) {
+            delete it->second;
+            m_breakpoints.erase(it);
+        }
+    } else if (type >= 2 && type <= 4) {
+        auto it = m_watchpoints.find(bpArgs);
+        if (insert && it == m_watchpoints.end()) {
+            int wpType = type == 2 ? WT_WRITE : (type == 3 ? WT_READ : WT_ACCESS);
+            m_watchpoints[bpArgs] = m_cpu->getWatchpoints()->addWatchpoint(addr, kind, wpType);
+        } else if (!insert && it != m_watchpoints.end()) {
+            m_cpu->getWatchpoints()->removeWatchpoint(it->second);
+            m_watchpoints.erase(it);
+        }
+    } else
+        return ""; // unsupported
+
+    return "OK";
+}
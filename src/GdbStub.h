@@ -0,0 +1,98 @@
+﻿/*
+ *  Emu80 v. 4.x
+ *  © Viktor Pykhonin <pyk@mail.ru>, 2016-2019
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+// GDB remote serial protocol server
+
+#ifndef GDBSTUB_H
+#define GDBSTUB_H
+
+#include <stdint.h>
+
+#include <string>
+#include <map>
+
+#ifdef _WIN32
+    typedef uintptr_t GdbSocket;
+#else
+    typedef int GdbSocket;
+#endif
+
+class Cpu;
+class Cpu8080Compatible;
+class CodeBreakpoint;
+
+
+// Serves one gdb connection on a local TCP port for the CPU of the first platform.
+// Registers (16 bit, little endian): AF, BC, DE, HL, SP, PC, and for Z80 also IX, IY,
+// AF', BC', DE', HL', IR, the order of gdb z80 target.
+// The stub works from the main loop and doesn't block: incoming data is polled once per cycle,
+// the CPU is stopped with the same debug request as the built-in debugger uses.
+class GdbStub
+{
+    public:
+        GdbStub(int port);
+        ~GdbStub();
+
+        int getPort() {return m_port;}
+
+        // accepts connection and processes incoming packets, cpu is attached on connection
+        void poll(Cpu* cpu);
+
+        // called when emulation is stopped by debug request, returns false if the stop
+        // should be handled by the built-in debugger
+        bool cpuStopped(Cpu* cpu);
+
+        // closes connection if it serves this CPU, called before CPU is destroyed
+        void detachCpu(Cpu* cpu);
+
+    private:
+        int m_port;
+        GdbSocket m_listenSocket;
+        GdbSocket m_socket;
+
+        Cpu8080Compatible* m_cpu = nullptr;
+        bool m_running = false;     // CPU runs on gdb request, the next stop is to be reported
+        bool m_interrupted = false; // stop was requested by gdb
+        bool m_noAck = false;
+        std::string m_inBuf;
+
+        std::map<uint16_t, CodeBreakpoint*> m_breakpoints;
+        std::map<std::string, int> m_watchpoints; // "type,addr,kind" -> watchpoint id
+
+        void closeConnection();
+        void removeBreakpoints();
+
+        void processInput();
+        void processPacket(const std::string& packet);
+        void sendPacket(const std::string& data);
+        void sendStopReply();
+
+        void resume(bool step);
+
+        std::string readRegisters();
+        void writeRegisters(const std::string& hex);
+        int getNumRegisters();
+        uint16_t getRegister(int reg);
+        void setRegister(int reg, uint16_t value);
+
+        std::string readMemory(const std::string& args);
+        bool writeMemory(const std::string& args);
+        std::string setBreakpoint(const std::string& args, bool insert);
+};
+
+
+#endif // GDBSTUB_H
@@ -23,6 +23,7 @@
 #include "Emulation.h"
 #include "AddrSpace.h"
 #include "GenericModules.h"
+#include "Snapshot.h"
 
 using namespace std;
 
@@ -49,6 +50,20 @@ void PeriodicInt8080::operate()
 }
 
 
+void PeriodicInt8080::saveState(SnapshotWriter& writer)
+{
+    saveClockState(writer);
+    writer.writeBool(m_active);
+}
+
+
+void PeriodicInt8080::loadState(SnapshotReader& reader)
+{
+    loadClockState(reader);
+    m_active = reader.readBool();
+}
+
+
 bool PeriodicInt8080::setProperty(const string& propertyName, const EmuValuesList& values)
 {
     if (EmuObject::setProperty(propertyName, values))
@@ -84,6 +99,19 @@ uint8_t PageSelector::readByte(int)
 }
 
 
+// page itself is restored by the mapper
+void PageSelector::saveState(SnapshotWriter& writer)
+{
+    writer.write8(m_value);
+}
+
+
+void PageSelector::loadState(SnapshotReader& reader)
+{
+    m_value = reader.read8();
+}
+
+
 bool PageSelector::setProperty(const string& propertyName, const EmuValuesList& values)
 {
     if (EmuObject::setProperty(propertyName, values))
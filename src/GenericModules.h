@@ -35,6 +35,9 @@ class PeriodicInt8080 : public AddressableDevice, public IActive
         // derived from ActiveDevice
         void operate() override;
 
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
+
         static EmuObject* create(const EmuValuesList& parameters) {return new PeriodicInt8080(static_cast<Cpu8080Compatible*>(findObj(parameters[0].asString())), parameters[1].asInt(), parameters[2].asInt());}
 
     private:
@@ -58,6 +61,9 @@ class PageSelector : public AddressableDevice
         void writeByte(int addr, uint8_t value) override;
         uint8_t readByte(int addr) override;
 
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
+
         static EmuObject* create(const EmuValuesList&) {return new PageSelector();}
 
     private:
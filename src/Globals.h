@@ -25,6 +25,8 @@
     #define TARGET "/qt"
 #elif defined PAL_WX
     #define TARGET ""
+#elif defined PAL_HEADLESS
+    #define TARGET "/headless"
 #else
     #define TARGET "/lite"
 #endif
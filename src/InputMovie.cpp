@@ -0,0 +1,377 @@
+﻿/*
+ *  Emu80 v. 4.x
+ *  © Viktor Pykhonin <pyk@mail.ru>, 2016-2019
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "Pal.h"
+#include "Emulation.h"
+#include "Platform.h"
+#include "EmuWindow.h"
+#include "KbdLayout.h"
+#include "FileLoader.h"
+#include "WavReader.h"
+#include "Snapshot.h"
+#include "InputMovie.h"
+
+using namespace std;
+
+
+static const char* c_movieMagic = "EMU80MOV";
+static const uint32_t c_movieVersion = 1;
+
+
+InputMovie::InputMovie(Platform* platform)
+{
+    m_platform = platform;
+    pause();
+}
+
+
+bool InputMovie::startRecording(const string& fileName)
+{
+    // check if the file can be written before recording
+    PalFile file;
+    file.open(fileName, "w");
+    if (!file.isOpen()) {
+        emuLog << "Can't create movie file: " << fileName << "\n";
+        return false;
+    }
+    file.close();
+
+    m_fileName = fileName;
+    m_startClock = g_emulation->getCurClock();
+
+    SnapshotWriter writer(m_startClock);
+    m_platform->saveState(writer);
+    writer.swapData(m_state);
+
+    // recording continues from the restored state as playback does, so that
+    // objects which are not saved in states are reset the same way
+    SnapshotReader reader(m_state.data(), m_state.size(), m_startClock);
+    m_platform->loadState(reader);
+
+    KbdLayout* kbdLayout = m_platform->getKbdLayout();
+    m_kbdLayoutMode = kbdLayout ? kbdLayout->getPropertyStringValue("layout") : "";
+
+    m_events.clear();
+    m_pos = 0;
+    m_tapeFiles.clear();
+    m_tapePos = 0;
+
+    m_mode = MM_RECORDING;
+    return true;
+}
+
+
+bool InputMovie::startPlayback(const string& fileName)
+{
+    m_startClock = g_emulation->getCurClock();
+    if (!readFile(fileName))
+        return false;
+
+    SnapshotReader reader(m_state.data(), m_state.size(), m_startClock);
+    m_platform->loadState(reader);
+    if (!reader.isValid()) {
+        emuLog << "Invalid movie state: " << fileName << "\n";
+        m_platform->reset();
+        return false;
+    }
+
+    KbdLayout* kbdLayout = m_platform->getKbdLayout();
+    if (kbdLayout && m_kbdLayoutMode != "")
+        kbdLayout->setProperty("layout", m_kbdLayoutMode);
+
+    m_fileName = fileName;
+    m_mode = MM_PLAYING;
+    scheduleNext();
+    return true;
+}
+
+
+bool InputMovie::stop()
+{
+    bool res = true;
+    if (m_mode == MM_RECORDING) {
+        m_endClock = g_emulation->getCurClock();
+        res = writeFile();
+        if (!res)
+            emuLog << "Can't write movie file: " << m_fileName << "\n";
+    }
+
+    m_mode = MM_NONE;
+    m_events.clear();
+    m_pos = 0;
+    m_tapeFiles.clear();
+    m_tapePos = 0;
+    m_state.clear();
+    pause();
+
+    return res;
+}
+
+
+bool InputMovie::isFinished()
+{
+    return m_mode == MM_PLAYING && m_pos >= m_events.size() && g_emulation->getCurClock() >= m_endClock;
+}
+
+
+void InputMovie::addEvent(MovieEvent& event)
+{
+    // host input is ignored while playing
+    if (m_mode != MM_RECORDING)
+        return;
+
+    // devices which have already run at the current clock are ahead of the event,
+    // playback applies it at the same point
+    event.clock = g_emulation->getCurClock() + 1;
+    m_events.push_back(event);
+    if (m_pos == m_events.size() - 1)
+        scheduleNext();
+}
+
+
+void InputMovie::keyEvent(PalKeyCode keyCode, bool isPressed, unsigned unicodeKey)
+{
+    MovieEvent event = {0, ME_KEY, keyCode, isPressed, unicodeKey, ""};
+    addEvent(event);
+}
+
+
+void InputMovie::resetKeysEvent()
+{
+    MovieEvent event = {0, ME_RESETKEYS, 0, false, 0, ""};
+    addEvent(event);
+}
+
+
+void InputMovie::sysReqEvent(SysReq sr)
+{
+    MovieEvent event = {0, ME_SYSREQ, sr, false, 0, ""};
+    addEvent(event);
+}
+
+
+void InputMovie::loadFileEvent(const string& fileName, bool run)
+{
+    MovieEvent event = {0, ME_LOADFILE, run, false, 0, fileName};
+    addEvent(event);
+}
+
+
+void InputMovie::wavFileEvent(const string& fileName)
+{
+    MovieEvent event = {0, ME_WAVFILE, 0, false, 0, fileName};
+    addEvent(event);
+}
+
+
+string InputMovie::chooseTapeFile(const string& title, const string& filter, bool write)
+{
+    if (m_mode == MM_PLAYING)
+        return m_tapePos < m_tapeFiles.size() ? m_tapeFiles[m_tapePos++] : "";
+
+    string fileName = palOpenFileDialog(title, filter, write, m_platform->getWindow());
+    if (m_mode == MM_RECORDING)
+        m_tapeFiles.push_back(fileName);
+    return fileName;
+}
+
+
+void InputMovie::operate()
+{
+    // file loading with run flag executes emulation, so the device is paused while applying events
+    pause();
+    while (m_pos < m_events.size() && m_events[m_pos].clock <= g_emulation->getCurClock()) {
+        MovieEvent event = m_events[m_pos++];
+        applyEvent(event);
+    }
+    scheduleNext();
+}
+
+
+void InputMovie::scheduleNext()
+{
+    if (m_pos < m_events.size()) {
+        m_curClock = m_events[m_pos].clock;
+        resume();
+    } else
+        pause();
+}
+
+
+void InputMovie::applyEvent(const MovieEvent& event)
+{
+    switch (event.type) {
+        case ME_KEY:
+            m_platform->processKey(PalKeyCode(event.code), event.isPressed, event.unicodeKey);
+            break;
+        case ME_RESETKEYS:
+            m_platform->resetKeys();
+            break;
+        case ME_SYSREQ:
+            m_platform->sysReq(SysReq(event.code));
+            break;
+        case ME_LOADFILE:
+            if (m_platform->getLoader() && !m_platform->getLoader()->loadFile(event.fileName, event.code))
+                emuLog << "Error loading file: " << event.fileName << "\n";
+            break;
+        case ME_WAVFILE:
+            if (event.fileName == "")
+                g_emulation->getWavReader()->stop();
+            else
+                g_emulation->getWavReader()->loadFile(event.fileName);
+            break;
+    }
+}
+
+
+bool InputMovie::writeFile()
+{
+    SnapshotWriter writer;
+    writer.writeBuf((const uint8_t*)c_movieMagic, 8);
+    writer.write32(c_movieVersion);
+    writer.writeString(m_platform->getName());
+    writer.writeString(m_kbdLayoutMode);
+    writer.write64(m_endClock - m_startClock);
+
+    writer.write32(m_state.size());
+    writer.writeBuf(m_state.data(), m_state.size());
+
+    writer.write32(m_events.size());
+    for (auto it = m_events.begin(); it != m_events.end(); it++) {
+        writer.write64(it->clock - m_startClock);
+        writer.write8(it->type);
+        switch (it->type) {
+            case ME_KEY:
+                writer.writeInt(it->code);
+                writer.writeBool(it->isPressed);
+                writer.write32(it->unicodeKey);
+                break;
+            case ME_SYSREQ:
+                writer.writeInt(it->code);
+                break;
+            case ME_LOADFILE:
+                writer.writeString(it->fileName);
+                writer.writeBool(it->code);
+                break;
+            case ME_WAVFILE:
+                writer.writeString(it->fileName);
+                break;
+            default:
+                break;
+        }
+    }
+
+    writer.write32(m_tapeFiles.size());
+    for (auto it = m_tapeFiles.begin(); it != m_tapeFiles.end(); it++)
+        writer.writeString(*it);
+
+    PalFile file;
+    file.open(m_fileName, "w");
+    if (!file.isOpen())
+        return false;
+
+    const vector<uint8_t>& data = writer.getData();
+    for (auto it = data.begin(); it != data.end(); it++)
+        file.write8(*it);
+
+    file.close();
+    return true;
+}
+
+
+bool InputMovie::readFile(const string& fileName)
+{
+    int fileSize;
+    uint8_t* buf = palReadFile(fileName, fileSize, false);
+    if (!buf) {
+        emuLog << "Can't open movie file: " << fileName << "\n";
+        return false;
+    }
+
+    bool res = false;
+    SnapshotReader reader(buf, fileSize);
+    if (fileSize < 12 || memcmp(buf, c_movieMagic, 8) != 0)
+        emuLog << "Not a movie file: " << fileName << "\n";
+    else {
+        for (int i = 0; i < 8; i++)
+            reader.read8();
+        string platformName;
+        if (reader.read32() != c_movieVersion)
+            emuLog << "Unsupported movie version: " << fileName << "\n";
+        else if ((platformName = reader.readString()) != m_platform->getName())
+            emuLog << "Movie is recorded for another platform (" << platformName << "): " << fileName << "\n";
+        else {
+            m_kbdLayoutMode = reader.readString();
+            m_endClock = m_startClock + reader.read64();
+
+            unsigned stateSize = reader.read32();
+            if (stateSize <= reader.getSize()) {
+                m_state.resize(stateSize);
+                reader.readBuf(m_state.data(), stateSize);
+            } else
+                reader.setInvalid();
+
+            m_events.clear();
+            m_pos = 0;
+            unsigned nEvents = reader.read32();
+            for (unsigned i = 0; i < nEvents && reader.isValid(); i++) {
+                MovieEvent event = {0, ME_KEY, 0, false, 0, ""};
+                event.clock = m_startClock + reader.read64();
+                event.type = MovieEventType(reader.read8());
+                switch (event.type) {
+                    case ME_KEY:
+                        event.code = reader.readInt();
+                        event.isPressed = reader.readBool();
+                        event.unicodeKey = reader.read32();
+                        break;
+                    case ME_RESETKEYS:
+                        break;
+                    case ME_SYSREQ:
+                        event.code = reader.readInt();
+                        break;
+                    case ME_LOADFILE:
+                        event.fileName = reader.readString();
+                        event.code = reader.readBool();
+                        break;
+                    case ME_WAVFILE:
+                        event.fileName = reader.readString();
+                        break;
+                    default:
+                        reader.setInvalid();
+                        break;
+                }
+                m_events.push_back(event);
+            }
+
+            m_tapeFiles.clear();
+            m_tapePos = 0;
+            unsigned nTapeFiles = reader.read32();
+            for (unsigned i = 0; i < nTapeFiles && reader.isValid(); i++)
+                m_tapeFiles.push_back(reader.readString());
+
+            res = reader.isValid();
+            if (!res)
+                emuLog << "Invalid movie file: " << fileName << "\n";
+        }
+    }
+
+    delete[] buf;
+    return res;
+}
@@ -0,0 +1,112 @@
+﻿/*
+ *  Emu80 v. 4.x
+ *  © Viktor Pykhonin <pyk@mail.ru>, 2016-2019
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INPUTMOVIE_H
+#define INPUTMOVIE_H
+
+#include <string>
+#include <vector>
+
+#include "PalKeys.h"
+#include "EmuTypes.h"
+#include "EmuObjects.h"
+
+class Platform;
+
+
+// Records host input of a platform stamped with emulation clock and replays it at the same clocks.
+// Movie file contains the platform state at the start of recording followed by events.
+// In both modes events are applied by this device from the scheduler, so recorded and replayed
+// runs go exactly the same way: host events are queued one clock after the current one
+// while recording and are ignored while playing.
+// Tape file names chosen by emulated code (tape redirector) are requested at deterministic
+// moments, so they are stored and returned in the same order.
+class InputMovie : public IActive
+{
+    public:
+        InputMovie(Platform* platform);
+
+        bool startRecording(const std::string& fileName);
+        bool startPlayback(const std::string& fileName);
+
+        // writes movie file when recording, returns false on write error
+        bool stop();
+
+        bool isRecording() {return m_mode == MM_RECORDING;}
+        bool isPlaying() {return m_mode == MM_PLAYING;}
+        bool isFinished(); // all events are played and recorded run length has passed
+        Platform* getPlatform() {return m_platform;}
+
+        // Host input of the movie platform
+        void keyEvent(PalKeyCode keyCode, bool isPressed, unsigned unicodeKey);
+        void resetKeysEvent();
+        void sysReqEvent(SysReq sr); // reset and keyboard layout switches
+        void loadFileEvent(const std::string& fileName, bool run);
+        void wavFileEvent(const std::string& fileName); // "" - stop wav playback
+
+        // Returns tape file name chosen with the dialog while recording or stored one while playing
+        std::string chooseTapeFile(const std::string& title, const std::string& filter, bool write);
+
+        void operate() override;
+
+    private:
+        enum MovieMode {
+            MM_NONE,
+            MM_RECORDING,
+            MM_PLAYING
+        };
+
+        enum MovieEventType {
+            ME_KEY,
+            ME_RESETKEYS,
+            ME_SYSREQ,
+            ME_LOADFILE,
+            ME_WAVFILE
+        };
+
+        struct MovieEvent {
+            uint64_t clock;
+            MovieEventType type;
+            int code;               // key code, system request or run flag
+            bool isPressed;
+            unsigned unicodeKey;
+            std::string fileName;
+        };
+
+        Platform* m_platform;
+        MovieMode m_mode = MM_NONE;
+        std::string m_fileName;
+
+        std::vector<uint8_t> m_state;
+        std::string m_kbdLayoutMode;
+        uint64_t m_startClock = 0;
+        uint64_t m_endClock = 0;
+
+        std::vector<MovieEvent> m_events;
+        unsigned m_pos = 0;
+        std::vector<std::string> m_tapeFiles;
+        unsigned m_tapePos = 0;
+
+        void addEvent(MovieEvent& event);
+        void applyEvent(const MovieEvent& event);
+        void scheduleNext();
+        bool writeFile();
+        bool readFile(const std::string& fileName);
+};
+
+#endif // INPUTMOVIE_H
@@ -20,9 +20,25 @@
 
 #include "Memory.h"
 #include "Pal.h"
+#include "Snapshot.h"
 
 using namespace std;
 
+
+uint8_t* getMemoryPagePtr(uint8_t* buf, int size, int addrMask, int addr)
+{
+    if (!buf)
+        return nullptr;
+    if (addrMask) {
+        if ((addrMask & 0xFF) != 0xFF || (addr & 0xFF) != 0)
+            return nullptr;
+        addr &= addrMask;
+    }
+    if (addr < 0 || addr + 0x100 > size)
+        return nullptr;
+    return buf + addr;
+}
+
 // Ram implementation
 
 /*Ram::Ram()
@@ -71,6 +87,7 @@ Ram::~Ram()
 {
     if (!m_extBuf)
         delete[] m_buf;
+    delete[] m_dirtyBlocks;
 }
 
 
@@ -80,8 +97,11 @@ void Ram::writeByte(int addr, uint8_t value)
     //m_lastTag = m_tag;
     if (m_addrMask)
         addr &= m_addrMask;
-    if (m_buf && addr < m_size)
+    if (m_buf && addr < m_size) {
         m_buf[addr] = value;
+        if (m_dirtyBlocks)
+            m_dirtyBlocks[addr >> DIRTY_BLOCK_SHIFT] = true;
+    }
 }
 
 
@@ -99,6 +119,66 @@ uint8_t Ram::readByte(int addr)
 
 
 
+uint8_t* Ram::getDirectPagePtr(int addr, bool write)
+{
+    uint8_t* ptr = getMemoryPagePtr(m_buf, m_size, m_addrMask, addr);
+    if (write && ptr && ptr + 0x100 > m_buf + m_trackStart && ptr < m_buf + m_trackEnd)
+        return nullptr;
+    return ptr;
+}
+
+
+
+void Ram::setWriteTracking(int startAddr, int size)
+{
+    if (!m_dirtyBlocks) {
+        m_nDirtyBlocks = ((m_size - 1) >> DIRTY_BLOCK_SHIFT) + 1;
+        m_dirtyBlocks = new bool[m_nDirtyBlocks];
+    }
+    m_trackStart = startAddr;
+    m_trackEnd = startAddr + size;
+    markAllDirty();
+    invalidateDirectPages();
+}
+
+
+
+void Ram::markAllDirty()
+{
+    if (m_dirtyBlocks)
+        memset(m_dirtyBlocks, true, m_nDirtyBlocks);
+}
+
+
+
+void Ram::clearDirtyBlocks()
+{
+    if (m_dirtyBlocks)
+        memset(m_dirtyBlocks, false, m_nDirtyBlocks);
+}
+
+
+
+void Ram::saveState(SnapshotWriter& writer)
+{
+    writer.writeInt(m_size);
+    writer.writeBuf(getDataPtr(), m_size);
+}
+
+
+
+void Ram::loadState(SnapshotReader& reader)
+{
+    if (reader.readInt() != m_size) {
+        reader.setInvalid();
+        return;
+    }
+    reader.readBuf(getDataPtr(), m_size);
+    markAllDirty();
+}
+
+
+
 // Rom implementation
 
 Rom::Rom()
@@ -112,6 +192,7 @@ Rom::Rom()
 Rom::Rom(unsigned memSize, string fileName)
 {
     m_buf = new uint8_t [memSize];
+    memset(m_buf, 0xFF, memSize); // if the file is shorter than ROM
     m_size = memSize;
     if (palReadFromFile(fileName, 0, memSize, m_buf) == 0/*!= memSize*/) {
         delete[] m_buf;
@@ -129,6 +210,13 @@ Rom::~Rom()
 
 
 
+uint8_t* Rom::getDirectPagePtr(int addr, bool write)
+{
+    return write ? nullptr : getMemoryPagePtr(m_buf, m_size, m_addrMask, addr);
+}
+
+
+
 uint8_t Rom::readByte(int addr)
 {
     if (m_addrMask)
@@ -24,6 +24,10 @@
 #include "EmuObjects.h"
 
 
+// Returns pointer to 256-byte page of memory buffer or nullptr if page can't be accessed directly
+uint8_t* getMemoryPagePtr(uint8_t* buf, int size, int addrMask, int addr);
+
+
 class Ram : public AddressableDevice
 {
     public:
@@ -34,10 +38,21 @@ class Ram : public AddressableDevice
         virtual ~Ram();
         void writeByte(int addr, uint8_t value) override;
         uint8_t readByte(int addr) override;
+        uint8_t* getDirectPagePtr(int addr, bool write) override;
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
         /*const*/ uint8_t* getDataPtr() {return m_buf ? m_buf : m_extBuf;}
         uint8_t& operator[](int nAddr) {return m_buf[nAddr];} // no check for borders, use with caution
         int getSize() {return m_size;}
 
+        // Write tracking for renderers: writes are marked in blocks of 2^DIRTY_BLOCK_SHIFT bytes,
+        // direct write pages are not provided for the tracked range so no write is missed
+        static const int DIRTY_BLOCK_SHIFT = 5;
+        void setWriteTracking(int startAddr, int size);
+        bool isBlockDirty(int addr) {return !m_dirtyBlocks || m_dirtyBlocks[addr >> DIRTY_BLOCK_SHIFT];}
+        void markAllDirty();
+        void clearDirtyBlocks();
+
         static EmuObject* create(const EmuValuesList& parameters) {return parameters[0].isInt() ? new Ram(parameters[0].asInt()) : nullptr;}
 
     protected:
@@ -46,6 +61,11 @@ class Ram : public AddressableDevice
         int m_size;
         uint8_t* m_buf = nullptr;
         uint8_t* m_extBuf = nullptr;
+
+        bool* m_dirtyBlocks = nullptr;
+        int m_nDirtyBlocks = 0;
+        int m_trackStart = 0;
+        int m_trackEnd = 0;
 };
 
 
@@ -58,6 +78,7 @@ class Rom : public AddressableDevice
         virtual ~Rom();
         void writeByte(int, uint8_t)  override {}
         uint8_t readByte(int addr) override;
+        uint8_t* getDirectPagePtr(int addr, bool write) override;
         const uint8_t* getDataPtr() {return m_buf;}
         const uint8_t& operator[](int nAddr) {return m_buf[nAddr];} // no check for borders, use with caution
 
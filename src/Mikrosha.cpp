@@ -197,24 +197,30 @@ const uint8_t* MikroshaRenderer::getAltFontPtr(bool, bool, bool)
 }
 
 
-void MikroshaPit8253SoundSource::updateStats()
+void MikroshaPit8253SoundSource::updateStats(uint64_t clock)
 {
     if (m_pit) {
-        m_pit->updateState();
+        m_pit->updateState(clock);
         if (m_gate)
-            m_sumValue += m_pit->getCounter(2)->getAvgOut();
+            m_sumValue += m_pit->getCounter(2)->getAvgOut(clock);
         }
 }
 
 
-int MikroshaPit8253SoundSource::calcValue()
+void MikroshaPit8253SoundSource::renderBlock(int* buffer, const uint64_t* sampleClocks, int nSamples)
 {
-    updateStats();
+    SoundSource::renderBlock(buffer, sampleClocks, nSamples);
+}
+
+
+int MikroshaPit8253SoundSource::calcValue(uint64_t clock)
+{
+    updateStats(clock);
     int res = m_sumValue;
     m_sumValue = 0;
 
     for (int i = 0; i < 3; i++)
-        m_pit->getCounter(i)->resetStats();
+        m_pit->getCounter(i)->resetStats(clock);
 
     return res;
 }
@@ -222,6 +228,8 @@ int MikroshaPit8253SoundSource::calcValue()
 
 void MikroshaPit8253SoundSource::setGate(bool gate)
 {
-    updateStats();
+    g_emulation->getSoundMixer()->update();
+
+    updateStats(g_emulation->getCurClock());
     m_gate = gate;
 }
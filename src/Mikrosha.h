@@ -45,7 +45,8 @@ class MikroshaCore : public PlatformCore
 class MikroshaPit8253SoundSource : public Pit8253SoundSource
 {
     public:
-        int calcValue() override;
+        int calcValue(uint64_t clock) override;
+        void renderBlock(int* buffer, const uint64_t* sampleClocks, int nSamples) override;
 
         void setGate(bool gate);
 
@@ -55,7 +56,7 @@ class MikroshaPit8253SoundSource : public Pit8253SoundSource
         bool m_gate = false;
         int m_sumValue;
 
-        void updateStats();
+        void updateStats(uint64_t clock);
 };
 
 
@@ -18,6 +18,8 @@
 
 #include <string.h>
 
+#include <algorithm>
+
 #include "Orion.h"
 #include "Emulation.h"
 #include "Platform.h"
@@ -28,6 +30,7 @@
 #include "AddrSpace.h"
 #include "Fdc1793.h"
 #include "Cpu.h"
+#include "Snapshot.h"
 
 using namespace std;
 
@@ -94,19 +97,35 @@ OrionRenderer::OrionRenderer()
 
 void OrionRenderer::attachScreenMemory(Ram* screenMemory)
 {
+    m_screenRam = screenMemory;
     m_screenMemory = screenMemory->getDataPtr();
+    updateWriteTracking();
 }
 
 
 void OrionRenderer::attachColorMemory(Ram* colorMemory)
 {
+    m_colorRam = colorMemory;
     m_colorMemory = colorMemory->getDataPtr();
+    updateWriteTracking();
 }
 
 
 void OrionRenderer::setScreenBase(uint16_t base)
 {
+    if (base == m_screenBase)
+        return;
     m_screenBase = base;
+    updateWriteTracking();
+}
+
+
+void OrionRenderer::updateWriteTracking()
+{
+    if (m_screenRam)
+        m_screenRam->setWriteTracking(m_screenBase, 0x3000);
+    if (m_colorRam)
+        m_colorRam->setWriteTracking(m_screenBase, 0x3000);
 }
 
 
@@ -116,6 +135,20 @@ void OrionRenderer::setColorModeByte(uint8_t modeByte)
     m_palette = modeByte & 1;
 }
 
+
+void OrionRenderer::saveState(SnapshotWriter& writer)
+{
+    writer.write16(m_screenBase);
+    writer.write8((m_colorMode << 1) | m_palette);
+}
+
+
+void OrionRenderer::loadState(SnapshotReader& reader)
+{
+    setScreenBase(reader.read16());
+    setColorModeByte(reader.read8());
+}
+
 void OrionRenderer::renderFrame()
 {
     swapBuffers();
@@ -137,46 +170,82 @@ void OrionRenderer::renderFrame()
         m_aspectRatio = 576.0 * 9 / 704 / 10;
     }
 
-    int offset = offsetY * m_sizeX + offsetX;
+    int params[4] = {m_screenBase, m_colorMode, m_palette, m_isColorMode};
+    bool fullUpdate = !m_isImageValid || memcmp(params, m_imageParams, sizeof(params));
+    if (fullUpdate) {
+        memcpy(m_imageParams, params, sizeof(params));
+        m_frameImage.resize(384 * 256);
+        m_isImageValid = true;
+    }
+
+    const int blockSize = 1 << Ram::DIRTY_BLOCK_SHIFT;
+    int minCol = 48, maxCol = -1, minRow = 256, maxRow = -1;
 
-    for (int row = 0; row < 256; row++)
-        for (int col = 0; col < 48; col++) {
+    for (int col = 0; col < 48; col++)
+        for (int row = 0; row < 256; row += blockSize) {
             int addr = m_screenBase + col * 256 + row;
-            if (m_colorMode != OCM_4COLOR) {
-                uint8_t bt = m_screenMemory[addr];
-                int fgColor, bgColor;
-                if (m_colorMode == OCM_MONO) {
-                    if (!m_palette) {
-                        fgColor = 2;
-                        bgColor = 0;
-                    } else {
-                        fgColor = 6;
-                        bgColor = 3;
-                    }
-                } else if (m_colorMode == OCM_BLANK) {
-                    fgColor = bgColor = 0;
-                } else { //if (m_colorMode == OCM_16COLOR) {
-                    fgColor = m_colorMemory[addr] & 0xF;
-                    bgColor = (m_colorMemory[addr] & 0xF0) >> 4;
-                }
-                if (!m_isColorMode) {
-                    fgColor = fgColor & 0x2 ? 7 : 0;
-                    bgColor = bgColor & 0x2 ? 7 : 0;
-                }
-                for (int pt = 0; pt < 8; pt++, bt<<=1)
-                    m_pixelData[offset + row * m_sizeX + col * 8 + pt] = (bt & 0x80) ? orion16ColorPalette[fgColor] : orion16ColorPalette[bgColor];
+            if (!fullUpdate && !m_screenRam->isBlockDirty(addr) && !m_colorRam->isBlockDirty(addr))
+                continue;
+            renderBlock(col, row, blockSize);
+            minCol = min(minCol, col);
+            maxCol = col;
+            minRow = min(minRow, row);
+            maxRow = max(maxRow, row + blockSize - 1);
+        }
+
+    m_screenRam->clearDirtyBlocks();
+    m_colorRam->clearDirtyBlocks();
+
+    for (int row = 0; row < 256; row++)
+        memcpy(m_pixelData + (row + offsetY) * m_sizeX + offsetX, m_frameImage.data() + row * 384, 384 * sizeof(uint32_t));
+
+    if (maxCol >= 0)
+        setChangedRect(offsetX + minCol * 8, offsetY + minRow, (maxCol - minCol + 1) * 8, maxRow - minRow + 1);
+    else
+        setChangedRect(0, 0, 0, 0);
+}
+
+
+void OrionRenderer::renderBlock(int col, int row, int nRows)
+{
+    for (; nRows > 0; row++, nRows--) {
+        int addr = m_screenBase + col * 256 + row;
+        uint32_t* ptr = m_frameImage.data() + row * 384 + col * 8;
+        if (m_colorMode != OCM_4COLOR) {
+            uint8_t bt = m_screenMemory[addr];
+            int fgColor, bgColor;
+            if (m_colorMode == OCM_MONO) {
+                if (!m_palette) {
+                    fgColor = 2;
+                    bgColor = 0;
                 } else {
-                // 4 color mode
-                    uint8_t bt1 = m_screenMemory[addr];
-                    uint8_t bt2 = m_colorMemory[addr];
-                    for (int pt = 0; pt < 8; pt++, bt1<<=1, bt2<<=1) {
-                        int color = ((bt1 & 0x80) >> 6) | ((bt2 & 0x80) >> 7);
-                        if (!m_isColorMode)
-                            color = color & 0x2 ? 4 : 0;
-                        m_pixelData[offset + row * m_sizeX + col * 8 + pt] = orion4ColorPalettes[m_palette][color];
-                    }
+                    fgColor = 6;
+                    bgColor = 3;
                 }
+            } else if (m_colorMode == OCM_BLANK) {
+                fgColor = bgColor = 0;
+            } else { //if (m_colorMode == OCM_16COLOR) {
+                fgColor = m_colorMemory[addr] & 0xF;
+                bgColor = (m_colorMemory[addr] & 0xF0) >> 4;
+            }
+            if (!m_isColorMode) {
+                fgColor = fgColor & 0x2 ? 7 : 0;
+                bgColor = bgColor & 0x2 ? 7 : 0;
+            }
+            for (int pt = 0; pt < 8; pt++, bt<<=1)
+                ptr[pt] = (bt & 0x80) ? orion16ColorPalette[fgColor] : orion16ColorPalette[bgColor];
+        } else {
+            // 4 color mode
+            uint8_t bt1 = m_screenMemory[addr];
+            uint8_t bt2 = m_colorMemory[addr];
+            for (int pt = 0; pt < 8; pt++, bt1<<=1, bt2<<=1) {
+                int color = ((bt1 & 0x80) >> 6) | ((bt2 & 0x80) >> 7);
+                if (!m_isColorMode)
+                    color = color & 0x2 ? 4 : 0;
+                ptr[pt] = orion4ColorPalettes[m_palette][color];
+            }
         }
+    }
 }
 
 
@@ -19,6 +19,8 @@
 #ifndef ORION_H
 #define ORION_H
 
+#include <vector>
+
 #include "PlatformCore.h"
 #include "CrtRenderer.h"
 #include "FileLoader.h"
@@ -85,9 +87,14 @@ class OrionRenderer : public CrtRenderer
         void setScreenBase(uint16_t base);
         void setColorModeByte(uint8_t modeByte);
 
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
+
         static EmuObject* create(const EmuValuesList&) {return new OrionRenderer();}
 
     private:
+        Ram* m_screenRam = nullptr;
+        Ram* m_colorRam = nullptr;
         const uint8_t* m_screenMemory = nullptr;
         const uint8_t* m_colorMemory = nullptr;
         uint16_t m_screenBase = 0xC000;
@@ -95,6 +102,14 @@ class OrionRenderer : public CrtRenderer
         int m_palette = 0;
         bool m_isColorMode = true;
         bool m_showBorder = false;
+
+        // 384x256 image updated for the written video memory blocks only
+        std::vector<uint32_t> m_frameImage;
+        int m_imageParams[4];
+        bool m_isImageValid = false;
+
+        void updateWriteTracking();
+        void renderBlock(int col, int row, int nRows);
 };
 
 
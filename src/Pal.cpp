@@ -39,6 +39,11 @@ bool palInit(int& argc, char** argv)
         return false;
 #endif
 
+#ifdef PAL_HEADLESS
+    if (!palHeadlessInit(argc, argv))
+        return false;
+#endif
+
     return true;
 }
 
@@ -56,6 +61,10 @@ void palQuit()
 #ifdef PAL_QT
     palQtQuit();
 #endif
+
+#ifdef PAL_HEADLESS
+    palHeadlessQuit();
+#endif
 }
 
 
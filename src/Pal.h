@@ -35,6 +35,10 @@
 #include "lite/litePal.h"
 #endif // PAL_LITE
 
+#ifdef PAL_HEADLESS
+#include "headless/headlessPal.h"
+#endif // PAL_HEADLESS
+
 bool palInit(int& argc, char** argv);
 void palQuit();
 void palIdle();
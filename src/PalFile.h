@@ -26,3 +26,7 @@
 #ifdef PAL_SDL
 #include "sdl/sdlPalFile.h"
 #endif // PAL_SDL
+
+#ifdef PAL_HEADLESS
+#include "headless/headlessPalFile.h"
+#endif // PAL_HEADLESS
@@ -26,3 +26,7 @@
 #ifdef PAL_SDL
 #include "sdl/sdlPalWindow.h"
 #endif // PAL_SDL
+
+#ifdef PAL_HEADLESS
+#include "headless/headlessPalWindow.h"
+#endif // PAL_HEADLESS
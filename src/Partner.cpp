@@ -29,6 +29,7 @@
 #include "RkKeyboard.h"
 #include "WavReader.h"
 #include "Memory.h"
+#include "Snapshot.h"
 
 using namespace std;
 
@@ -132,6 +133,25 @@ void PartnerCore::hrtc(bool isActive, int lc)
 
 
 
+void PartnerCore::saveState(SnapshotWriter& writer)
+{
+    writer.writeBool(m_beep);
+    writer.writeBool(m_beepGate);
+    writer.writeBool(m_intReq);
+}
+
+
+
+void PartnerCore::loadState(SnapshotReader& reader)
+{
+    m_beep = reader.readBool();
+    m_beepGate = reader.readBool();
+    m_intReq = reader.readBool();
+    m_beepSoundSource->setValue(m_beep && m_beepGate ? 1 : 0);
+}
+
+
+
 bool PartnerCore::setProperty(const string& propertyName, const EmuValuesList& values)
 {
     if (PlatformCore::setProperty(propertyName, values))
@@ -208,9 +228,33 @@ void PartnerAddrSpace::writeByte(int addr, uint8_t value)
 
 
 
+uint8_t* PartnerAddrSpace::getDirectPagePtr(int addr, bool write)
+{
+    // memory map granularity is 2K, so 256-byte page is always within one block
+    if (!m_buf || unsigned(addr) >= 0x10000)
+        return nullptr;
+    return m_memBlocks[m_buf[m_mapNum * 32 + ((addr & 0xf800) >> 11)]]->getDirectPagePtr(addr, write);
+}
+
+
+
+void PartnerAddrSpace::saveState(SnapshotWriter& writer)
+{
+    writer.writeInt(m_mapNum);
+}
+
+
+void PartnerAddrSpace::loadState(SnapshotReader& reader)
+{
+    m_mapNum = reader.readInt() & 0xF;
+    invalidateDirectPages();
+}
+
+
 void PartnerAddrSpace::setMemBlock(int blockNum, AddressableDevice* memBlock)
 {
     m_memBlocks[blockNum] = memBlock;
+    invalidateDirectPages();
 }
 
 
@@ -259,6 +303,18 @@ void PartnerRamUpdater::operate()
 }
 
 
+void PartnerRamUpdater::saveState(SnapshotWriter& writer)
+{
+    saveClockState(writer);
+}
+
+
+void PartnerRamUpdater::loadState(SnapshotReader& reader)
+{
+    loadClockState(reader);
+}
+
+
 bool PartnerRamUpdater::setProperty(const string& propertyName, const EmuValuesList& values)
 {
     if (EmuObject::setProperty(propertyName, values))
@@ -325,6 +381,18 @@ void PartnerMcpgSelector::writeByte(int, uint8_t value)
 }
 
 
+void PartnerMcpgSelector::saveState(SnapshotWriter& writer)
+{
+    writer.writeBool(m_isMcpgEnabled);
+}
+
+
+void PartnerMcpgSelector::loadState(SnapshotReader& reader)
+{
+    m_isMcpgEnabled = reader.readBool();
+}
+
+
 uint8_t PartnerPpi8255Circuit::getPortC()
 {
     return (m_kbd->getCtrlKeys() & 0x70) | (g_emulation->getWavReader()->getCurValue() ? 0x80 : 0x00);
@@ -44,13 +44,17 @@ class PartnerAddrSpace : public AddressableDevice
         virtual ~PartnerAddrSpace();
 
         bool setProperty(const std::string& propertyName, const EmuValuesList& values) override;
-        void reset()  override {m_mapNum = 0;}
+        void reset()  override {m_mapNum = 0; invalidateDirectPages();}
 
         void writeByte(int addr, uint8_t value) override;
         uint8_t readByte(int addr) override;
+        uint8_t* getDirectPagePtr(int addr, bool write) override;
 
         void setMemBlock(int blockNum, AddressableDevice* memBlock);
 
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
+
         static EmuObject* create(const EmuValuesList& parameters) {return new PartnerAddrSpace(parameters[0].asString());}
 
         friend PartnerAddrSpaceSelector;
@@ -73,7 +77,7 @@ class PartnerAddrSpaceSelector : public AddressableDevice
 
         void attachPartnerAddrSpace(PartnerAddrSpace* partnerAddrSpace) {m_partnerAddrSpace = partnerAddrSpace;}
 
-        void writeByte(int, uint8_t value) override {m_partnerAddrSpace->m_mapNum = (value & 0xf0) >> 4;}
+        void writeByte(int, uint8_t value) override {m_partnerAddrSpace->m_mapNum = (value & 0xf0) >> 4; invalidateDirectPages();}
         uint8_t readByte(int)  override {return 0xff;}
 
         static EmuObject* create(const EmuValuesList&) {return new PartnerAddrSpaceSelector();}
@@ -112,6 +116,9 @@ class PartnerMcpgSelector : public AddressableDevice
 
         bool getMcpgEnabled() {return m_isMcpgEnabled;}
 
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
+
         static EmuObject* create(const EmuValuesList&) {return new PartnerMcpgSelector();}
 
     private:
@@ -126,6 +133,9 @@ class PartnerRamUpdater : public ActiveDevice
 
         void operate() override;
 
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
+
         void attachDma(Dma8257* dma, int channel);
 
         static EmuObject* create(const EmuValuesList&) {return new PartnerRamUpdater();}
@@ -155,6 +165,9 @@ class PartnerCore : public PlatformCore
 
         void setBeepGate(bool isSet);
 
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
+
         void attachCpu(Cpu8080Compatible* cpu);
         void attach8275Renderer(Crt8275Renderer* crtRenderer);
         void attach8275McpgRenderer(Crt8275Renderer* crtMcpgRenderer);
@@ -23,6 +23,9 @@
 
 #include "Emulation.h"
 #include "Pit8253.h"
+#include "Snapshot.h"
+#include "SoundMixer.h"
+#include "BlepBuffer.h"
 
 Pit8253Counter::Pit8253Counter(Pit8253* pit, int number)
 {
@@ -52,6 +55,8 @@ void Pit8253Counter::operateForTicks(int ticks)
             //m_tempSumOut = 0;
             if (m_isCounting && !m_out) {
                 if (ticks >= m_counter) {
+                    if (m_blepBuffer)
+                        setSoundOut(m_tickBaseClock + uint64_t(m_counter) * m_kDiv, true);
                     m_tempSumOut += (ticks - m_counter);
                     m_isCounting = false;
                     m_out = true;
@@ -71,6 +76,17 @@ void Pit8253Counter::operateForTicks(int ticks)
                 int hiPeriod = (m_counterInitValue + 1) / 2;
                 int loPeriod = m_counterInitValue / 2;
 
+                if (m_blepBuffer && m_isCounting) {
+                    // record every output change
+                    bool out = m_out;
+                    int t = out ? (m_counter + 1) / 2 : m_counter / 2;
+                    while (t <= ticks) {
+                        out = !out;
+                        setSoundOut(m_tickBaseClock + uint64_t(t) * m_kDiv, out);
+                        t += out ? hiPeriod : loPeriod;
+                    }
+                }
+
                 int fullCycles = ticks / m_counterInitValue;
                 if (m_isCounting) {
                     m_tempSumOut += fullCycles * hiPeriod;
@@ -126,12 +142,16 @@ void Pit8253Counter::operateForTicks(int ticks)
 
 void Pit8253Counter::updateState()
 {
-    uint64_t curClock = g_emulation->getCurClock();
+    updateState(g_emulation->getCurClock());
+}
+
 
+void Pit8253Counter::updateState(uint64_t curClock)
+{
 #ifndef LESS_64BIT_DIVS
     int ticks = curClock / m_kDiv - m_prevClock / m_kDiv;
 #else
-    int dt = g_emulation->getCurClock() - m_prevClock;
+    int dt = curClock - m_prevClock;
      if (m_prevFastClock >= m_kDiv * 1024) {
         m_prevFastClock -= m_kDiv * 1024;
     }
@@ -147,6 +167,12 @@ void Pit8253Counter::updateState()
 #endif
         //m_tempAddOutClocks += (m_kDiv - m_prevClock % m_kDiv) % m_kDiv;
 
+#ifndef LESS_64BIT_DIVS
+    m_tickBaseClock = m_prevClock - m_prevClock % m_kDiv;
+#else
+    m_tickBaseClock = m_prevClock - m_prevFastClock % m_kDiv;
+#endif
+
     operateForTicks(ticks);
 
     if (m_out || !m_isCounting)
@@ -164,12 +190,13 @@ void Pit8253Counter::updateState()
 #ifdef LESS_64BIT_DIVS
     m_prevFastClock = curFastClock;
 #endif
+
+    updateSoundOut(curClock);
 }
 
 
-int Pit8253Counter::getAvgOut()
+int Pit8253Counter::getAvgOut(uint64_t curClock)
 {
-    uint64_t curClock = g_emulation->getCurClock();
     m_avgOut = 0;
     if (curClock != m_sampleClock) {
 #ifndef LESS_64BIT_DIVS
@@ -183,13 +210,13 @@ int Pit8253Counter::getAvgOut()
     return m_avgOut;
 }
 
-void Pit8253Counter::resetStats()
+void Pit8253Counter::resetStats(uint64_t curClock)
 {
     m_avgOut = 0;
     m_sumOutTicks = 0;
     m_tempSumOut = 0;
     m_tempAddOutClocks = 0;
-    m_prevClock = g_emulation->getCurClock();
+    m_prevClock = curClock;
     m_sampleClock = m_prevClock;
 #ifdef LESS_64BIT_DIVS
     m_prevFastClock = 0;
@@ -224,6 +251,8 @@ void Pit8253Counter::setMode(int mode)
         default:
             break;
     }
+
+    updateSoundOut(g_emulation->getCurClock());
 }
 
 
@@ -243,6 +272,8 @@ void Pit8253Counter::setHalfOfCounter()
             // not implemented yet
             break;
     }
+
+    updateSoundOut(g_emulation->getCurClock());
 }
 
 
@@ -275,6 +306,8 @@ void Pit8253Counter::setCounter(uint16_t counter)
             // not implemented yet
             break;
     }
+
+    updateSoundOut(g_emulation->getCurClock());
 }
 
 
@@ -283,6 +316,8 @@ void Pit8253Counter::setGate(bool gate)
     if (gate == m_gate)
         return;
 
+    g_emulation->getSoundMixer()->update();
+
     if (!m_extClockMode)
         updateState();
 
@@ -300,6 +335,8 @@ void Pit8253Counter::setGate(bool gate)
         default:
             break;
     }
+
+    updateSoundOut(g_emulation->getCurClock());
 }
 
 
@@ -316,6 +353,46 @@ bool Pit8253Counter::getOut()
 }
 
 
+// Output level as it is accounted in average output value
+bool Pit8253Counter::getSoundOut()
+{
+    if (!m_gate)
+        return m_out;
+
+    switch (m_mode) {
+        case 0:
+        case 3:
+            return m_out || !m_isCounting;
+        default:
+            return m_out;
+    }
+}
+
+
+void Pit8253Counter::setBlepBuffer(BlepBuffer* blepBuffer, int amp)
+{
+    m_blepBuffer = blepBuffer;
+    m_blepAmp = amp;
+    m_blepOut = getSoundOut();
+}
+
+
+void Pit8253Counter::setSoundOut(uint64_t clock, bool out)
+{
+    if (out != m_blepOut) {
+        m_blepBuffer->addDelta(clock, out ? m_blepAmp : -m_blepAmp);
+        m_blepOut = out;
+    }
+}
+
+
+void Pit8253Counter::updateSoundOut(uint64_t clock)
+{
+    if (m_blepBuffer)
+        setSoundOut(clock, getSoundOut());
+}
+
+
 Pit8253::Pit8253()
 {
     for (int i = 0; i < 3; i++) {
@@ -333,6 +410,48 @@ Pit8253::~Pit8253()
 }
 
 
+void Pit8253Counter::saveState(SnapshotWriter& writer)
+{
+    writer.writeBool(m_extClockMode);
+    writer.writeClock(m_prevClock);
+    writer.writeClock(m_sampleClock);
+    writer.writeInt(m_avgOut);
+    writer.writeInt(m_sumOutTicks);
+    writer.writeInt(m_tempSumOut);
+    writer.writeInt(m_tempAddOutClocks);
+#ifdef LESS_64BIT_DIVS
+    writer.write32(m_prevFastClock);
+#endif
+    writer.writeInt(m_mode);
+    writer.writeBool(m_gate);
+    writer.writeBool(m_out);
+    writer.writeInt(m_counter);
+    writer.writeInt(m_counterInitValue);
+    writer.writeBool(m_isCounting);
+}
+
+
+void Pit8253Counter::loadState(SnapshotReader& reader)
+{
+    m_extClockMode = reader.readBool();
+    m_prevClock = reader.readClock();
+    m_sampleClock = reader.readClock();
+    m_avgOut = reader.readInt();
+    m_sumOutTicks = reader.readInt();
+    m_tempSumOut = reader.readInt();
+    m_tempAddOutClocks = reader.readInt();
+#ifdef LESS_64BIT_DIVS
+    m_prevFastClock = reader.read32();
+#endif
+    m_mode = reader.readInt();
+    m_gate = reader.readBool();
+    m_out = reader.readBool();
+    m_counter = reader.readInt();
+    m_counterInitValue = reader.readInt();
+    m_isCounting = reader.readBool();
+}
+
+
 void Pit8253::setFrequency(int64_t freq)
 {
     EmuObject::setFrequency(freq);
@@ -349,6 +468,33 @@ void Pit8253::reset()
 }
 
 
+void Pit8253::saveState(SnapshotWriter& writer)
+{
+    for (int i = 0; i < 3; i++) {
+        m_counters[i]->saveState(writer);
+        writer.write16(m_latches[i]);
+        writer.writeBool(m_latched[i]);
+        writer.writeInt(m_rlModes[i]);
+        writer.writeBool(m_waitingHi[i]);
+    }
+}
+
+
+void Pit8253::loadState(SnapshotReader& reader)
+{
+    g_emulation->getSoundMixer()->update();
+
+    for (int i = 0; i < 3; i++) {
+        m_counters[i]->loadState(reader);
+        m_latches[i] = reader.read16();
+        m_latched[i] = reader.readBool();
+        m_rlModes[i] = PitReadLoadMode(reader.readInt());
+        m_waitingHi[i] = reader.readBool();
+        m_counters[i]->updateSoundOut(g_emulation->getCurClock());
+    }
+}
+
+
 void Pit8253::updateState()
 {
     for (int i = 0; i < 3; i++)
@@ -356,6 +502,13 @@ void Pit8253::updateState()
 }
 
 
+void Pit8253::updateState(uint64_t curClock)
+{
+    for (int i = 0; i < 3; i++)
+        m_counters[i]->updateState(curClock);
+}
+
+
 bool Pit8253::getOut(int counter)
 {
     return m_counters[counter]->getOut();
@@ -364,6 +517,8 @@ bool Pit8253::getOut(int counter)
 
 void Pit8253::writeByte(int addr, uint8_t value)
 {
+    g_emulation->getSoundMixer()->update();
+
     addr &= 0x3;
 
     if (addr == 0x03) {
@@ -416,6 +571,8 @@ void Pit8253::writeByte(int addr, uint8_t value)
 
 uint8_t Pit8253::readByte(int addr)
 {
+    g_emulation->getSoundMixer()->update();
+
     addr &= 0x3;
 
     if (addr == 0x03) {
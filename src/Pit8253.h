@@ -28,6 +28,7 @@
 //#define LESS_64BIT_DIVS
 
 class Pit8253;
+class BlepBuffer;
 
 
 //struct Pit8253Stats
@@ -53,16 +54,24 @@ class Pit8253Counter : public EmuObject //PassiveDevice
         void setGate(bool gate);
         bool getOut();
 
-        int getAvgOut();
+        int getAvgOut(uint64_t curClock);
         int getSumOutTicks() {return m_sumOutTicks;}
-        void resetStats();
+        void resetStats(uint64_t curClock);
 
         void updateState();
+        void updateState(uint64_t curClock);
         void operateForTicks(int ticks);
 
         void setExtClockMode(bool extClockMode) {m_extClockMode = extClockMode;}
         inline bool getExtClockMode() {return m_extClockMode;}
 
+        // output level used for sound, its changes are recorded to blepBuffer as steps of amp
+        bool getSoundOut();
+        void setBlepBuffer(BlepBuffer* blepBuffer, int amp);
+
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
+
         friend class Pit8253;
 
     private:
@@ -82,6 +91,11 @@ class Pit8253Counter : public EmuObject //PassiveDevice
         uint32_t m_prevFastClock = 0;
 #endif
 
+        BlepBuffer* m_blepBuffer = nullptr;
+        int m_blepAmp = 0;
+        bool m_blepOut = false;
+        uint64_t m_tickBaseClock = 0; // clock of tick preceding ticks counted by operateForTicks()
+
         int m_mode;
         bool m_gate;
         bool m_out;
@@ -96,6 +110,9 @@ class Pit8253Counter : public EmuObject //PassiveDevice
 
         void startCount();
         void stopCount();
+
+        void updateSoundOut(uint64_t clock);
+        void setSoundOut(uint64_t clock, bool out);
 };
 
 class Pit8253 : public AddressableDevice
@@ -122,19 +139,23 @@ class Pit8253 : public AddressableDevice
         uint8_t readByte(int addr) override;
 
         void updateState();
+        void updateState(uint64_t curClock);
         void setGate(int counter, bool gate);
         bool getOut(int counter);
 
         Pit8253Counter* getCounter(int counterNum) {return m_counters[counterNum];}
 
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
+
         static EmuObject* create(const EmuValuesList&) {return new Pit8253();}
 
     private:
         Pit8253Counter* m_counters[3];
         uint16_t m_latches[3];
-        bool m_latched[3];
-        PitReadLoadMode m_rlModes[3];
-        bool m_waitingHi[3];
+        bool m_latched[3] = {false, false, false};
+        PitReadLoadMode m_rlModes[3] = {PRLM_LATCH, PRLM_LATCH, PRLM_LATCH};
+        bool m_waitingHi[3] = {false, false, false};
 };
 
 #endif // PIT8253_H
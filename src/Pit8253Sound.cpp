@@ -32,20 +32,30 @@ void Pit8253SoundSource::attachPit(Pit8253* pit)
 }
 
 
-int Pit8253SoundSource::calcValue()
+void Pit8253SoundSource::renderBlock(int* buffer, const uint64_t* sampleClocks, int nSamples)
 {
-    int res = 0;
+    if (!m_pit)
+        return;
 
-    if (m_pit) {
-        m_pit->updateState();
+    if (!m_blepAttached) {
+        int level = 0;
         for (int i = 0; i < 3; i++) {
-            res += SND_AMP - (m_pit->getCounter(i)->getAvgOut());
-            m_pit->getCounter(i)->resetStats();
-            //res += m_pit->getOut(i) ? SND_AMP : 0;
+            Pit8253Counter* counter = m_pit->getCounter(i);
+            counter->setBlepBuffer(&m_blepBuffer, -SND_AMP);
+            if (!counter->getSoundOut())
+                level += SND_AMP;
         }
+        m_blepBuffer.setLevel(level);
+        m_blepAttached = true;
     }
 
-    return res;
+    // counters record their output changes up to the end of the block
+    uint64_t clock = sampleClocks[nSamples - 1];
+    m_pit->updateState(clock);
+    for (int i = 0; i < 3; i++)
+        m_pit->getCounter(i)->resetStats(clock);
+
+    m_blepBuffer.render(buffer, sampleClocks, nSamples);
 }
 
 
@@ -63,13 +73,19 @@ bool Pit8253SoundSource::setProperty(const string& propertyName, const EmuValues
 }
 
 
-int RkPit8253SoundSource::calcValue()
+void RkPit8253SoundSource::renderBlock(int* buffer, const uint64_t* sampleClocks, int nSamples)
+{
+    SoundSource::renderBlock(buffer, sampleClocks, nSamples);
+}
+
+
+int RkPit8253SoundSource::calcValue(uint64_t clock)
 {
     int res = 0;
 
     if (m_pit) {
-        m_pit->getCounter(0)->updateState();
-        m_pit->getCounter(1)->updateState();
+        m_pit->getCounter(0)->updateState(clock);
+        m_pit->getCounter(1)->updateState(clock);
 
         //m_pit->getCounter(2)->operateForTicks(m_pit->getCounter(1)->getSumOutTicks());
         int t = m_pit->getCounter(1)->getSumOutTicks();
@@ -77,11 +93,11 @@ int RkPit8253SoundSource::calcValue()
         cnt->operateForTicks(t);
 
         if (!m_pit->getCounter(2)->getOut())
-            res += (SND_AMP - m_pit->getCounter(0)->getAvgOut());
+            res += (SND_AMP - m_pit->getCounter(0)->getAvgOut(clock));
 
-        m_pit->getCounter(0)->resetStats();
-        m_pit->getCounter(1)->resetStats();
-        m_pit->getCounter(2)->resetStats();
+        m_pit->getCounter(0)->resetStats(clock);
+        m_pit->getCounter(1)->resetStats(clock);
+        m_pit->getCounter(2)->resetStats(clock);
     }
 
     return res;
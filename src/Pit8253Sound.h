@@ -22,16 +22,18 @@
 #define PIT8253SOUND_H
 
 #include "SoundMixer.h"
+#include "BlepBuffer.h"
 
 class Pit8253;
 
 
+// Counter output changes are formed as band-limited steps
 class Pit8253SoundSource : public SoundSource
 {
     public:
         bool setProperty(const std::string& propertyName, const EmuValuesList& values) override;
 
-        int calcValue() override;
+        void renderBlock(int* buffer, const uint64_t* sampleClocks, int nSamples) override;
 
         void attachPit(Pit8253* pit);
 
@@ -39,13 +41,19 @@ class Pit8253SoundSource : public SoundSource
 
     protected:
         Pit8253* m_pit = nullptr;
+
+    private:
+        BlepBuffer m_blepBuffer;
+        bool m_blepAttached = false;
 };
 
 
+// Counter 2 is clocked by counter 1 output, output is averaged over sample period
 class RkPit8253SoundSource : public Pit8253SoundSource
 {
     public:
-        int calcValue() override;
+        int calcValue(uint64_t clock) override;
+        void renderBlock(int* buffer, const uint64_t* sampleClocks, int nSamples) override;
 
         static EmuObject* create(const EmuValuesList&) {return new RkPit8253SoundSource();}
 };
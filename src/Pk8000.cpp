@@ -30,6 +30,7 @@
 #include "Fdc1793.h"
 #include "WavReader.h"
 #include "TapeRedirector.h"
+#include "Snapshot.h"
 
 using namespace std;
 
@@ -89,6 +90,18 @@ void Pk8000Core::vrtc(bool isActive)
 }
 
 
+void Pk8000Core::saveState(SnapshotWriter& writer)
+{
+    writer.writeBool(m_intReq);
+}
+
+
+void Pk8000Core::loadState(SnapshotReader& reader)
+{
+    m_intReq = reader.readBool();
+}
+
+
 void Pk8000Core::attachCrtRenderer(Pk8000Renderer* crtRenderer)
 {
     m_crtRenderer = crtRenderer;
@@ -175,6 +188,59 @@ void Pk8000Renderer::operate()
 }
 
 
+void Pk8000Renderer::saveState(SnapshotWriter& writer)
+{
+    saveClockState(writer);
+    writer.writeInt(m_bank);
+    writer.writeInt(m_mode);
+    writer.write16(m_txtBase);
+    writer.write16(m_sgBase);
+    writer.write16(m_grBase);
+    writer.write16(m_colBase);
+    writer.write16(m_nextLineSgBase);
+    writer.write32(m_fgColor);
+    writer.write32(m_bgColor);
+    writer.writeBuf(m_colorRegs, sizeof(m_colorRegs));
+    writer.writeBool(m_blanking);
+    writer.writeBool(m_activeArea);
+    writer.writeInt(m_curLine);
+    writer.writeClock(m_curScanlineClock);
+    writer.writeInt(m_curScanlinePixel);
+    writer.writeBuf(reinterpret_cast<uint8_t*>(m_bgScanlinePixels), sizeof(m_bgScanlinePixels));
+    writer.writeBuf(reinterpret_cast<uint8_t*>(m_fgScanlinePixels), sizeof(m_fgScanlinePixels));
+}
+
+
+void Pk8000Renderer::loadState(SnapshotReader& reader)
+{
+    loadClockState(reader);
+    setScreenBank(reader.readInt());
+    setMode(reader.readInt());
+    m_txtBase = reader.read16();
+    m_sgBase = reader.read16();
+    m_grBase = reader.read16();
+    m_colBase = reader.read16();
+    m_nextLineSgBase = reader.read16();
+    m_fgColor = reader.read32();
+    m_bgColor = reader.read32();
+    reader.readBuf(m_colorRegs, sizeof(m_colorRegs));
+    m_blanking = reader.readBool();
+    m_activeArea = reader.readBool();
+    m_curLine = reader.readInt();
+    if (m_curLine < 0 || m_curLine >= 308) {
+        m_curLine = 0;
+        reader.setInvalid();
+    }
+    m_curScanlineClock = reader.readClock();
+    m_curScanlinePixel = reader.readInt();
+    reader.readBuf(reinterpret_cast<uint8_t*>(m_bgScanlinePixels), sizeof(m_bgScanlinePixels));
+    reader.readBuf(reinterpret_cast<uint8_t*>(m_fgScanlinePixels), sizeof(m_fgScanlinePixels));
+
+    if (m_waits)
+        m_waits->setState(m_activeArea && m_wideBorder);
+}
+
+
 void Pk8000Renderer::attachScreenMemoryBank(int bank, Ram* screenMemoryBank)
 {
     if (bank >= 0 && bank < 4) {
@@ -577,6 +643,18 @@ void Pk8000ColorSelector::writeByte(int, uint8_t value)
 }
 
 
+void Pk8000ColorSelector::saveState(SnapshotWriter& writer)
+{
+    writer.write8(m_value);
+}
+
+
+void Pk8000ColorSelector::loadState(SnapshotReader& reader)
+{
+    m_value = reader.read8();
+}
+
+
 bool Pk8000ColorSelector::setProperty(const string& propertyName, const EmuValuesList& values)
 {
     if (EmuObject::setProperty(propertyName, values))
@@ -601,6 +679,18 @@ void Pk8000TxtBufSelector::writeByte(int, uint8_t value)
 }
 
 
+void Pk8000TxtBufSelector::saveState(SnapshotWriter& writer)
+{
+    writer.write8(m_value);
+}
+
+
+void Pk8000TxtBufSelector::loadState(SnapshotReader& reader)
+{
+    m_value = reader.read8();
+}
+
+
 bool Pk8000TxtBufSelector::setProperty(const string& propertyName, const EmuValuesList& values)
 {
     if (EmuObject::setProperty(propertyName, values))
@@ -625,6 +715,18 @@ void Pk8000SymGenBufSelector::writeByte(int, uint8_t value)
 }
 
 
+void Pk8000SymGenBufSelector::saveState(SnapshotWriter& writer)
+{
+    writer.write8(m_value);
+}
+
+
+void Pk8000SymGenBufSelector::loadState(SnapshotReader& reader)
+{
+    m_value = reader.read8();
+}
+
+
 bool Pk8000SymGenBufSelector::setProperty(const string& propertyName, const EmuValuesList& values)
 {
     if (EmuObject::setProperty(propertyName, values))
@@ -649,6 +751,18 @@ void Pk8000GrBufSelector::writeByte(int, uint8_t value)
 }
 
 
+void Pk8000GrBufSelector::saveState(SnapshotWriter& writer)
+{
+    writer.write8(m_value);
+}
+
+
+void Pk8000GrBufSelector::loadState(SnapshotReader& reader)
+{
+    m_value = reader.read8();
+}
+
+
 bool Pk8000GrBufSelector::setProperty(const string& propertyName, const EmuValuesList& values)
 {
     if (EmuObject::setProperty(propertyName, values))
@@ -673,6 +787,18 @@ void Pk8000ColBufSelector::writeByte(int, uint8_t value)
 }
 
 
+void Pk8000ColBufSelector::saveState(SnapshotWriter& writer)
+{
+    writer.write8(m_value);
+}
+
+
+void Pk8000ColBufSelector::loadState(SnapshotReader& reader)
+{
+    m_value = reader.read8();
+}
+
+
 bool Pk8000ColBufSelector::setProperty(const string& propertyName, const EmuValuesList& values)
 {
     if (EmuObject::setProperty(propertyName, values))
@@ -64,6 +64,9 @@ class Pk8000Renderer : public CrtRenderer, public IActive
         uint8_t getColorReg(unsigned addr);
         bool isBorderWide() {return m_wideBorder;}
 
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
+
         static EmuObject* create(const EmuValuesList&) {return new Pk8000Renderer();}
 
     private:
@@ -140,6 +143,9 @@ class Pk8000ColorSelector : public AddressableDevice
         void writeByte(int addr, uint8_t value) override;
         uint8_t readByte(int) override {return m_value;}
 
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
+
         static EmuObject* create(const EmuValuesList&) {return new Pk8000ColorSelector();}
 
     private:
@@ -159,6 +165,9 @@ class Pk8000TxtBufSelector : public AddressableDevice
         void writeByte(int addr, uint8_t value) override;
         uint8_t readByte(int) override {return m_value;}
 
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
+
         static EmuObject* create(const EmuValuesList&) {return new Pk8000TxtBufSelector();}
 
     private:
@@ -178,6 +187,9 @@ class Pk8000SymGenBufSelector : public AddressableDevice
         void writeByte(int addr, uint8_t value) override;
         uint8_t readByte(int) override {return m_value;}
 
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
+
         static EmuObject* create(const EmuValuesList&) {return new Pk8000SymGenBufSelector();}
 
     private:
@@ -197,6 +209,9 @@ class Pk8000GrBufSelector : public AddressableDevice
         void writeByte(int addr, uint8_t value) override;
         uint8_t readByte(int) override {return m_value;}
 
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
+
         static EmuObject* create(const EmuValuesList&) {return new Pk8000GrBufSelector();}
 
     private:
@@ -216,6 +231,9 @@ class Pk8000ColBufSelector : public AddressableDevice
         void writeByte(int addr, uint8_t value) override;
         uint8_t readByte(int) override {return m_value;}
 
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
+
         static EmuObject* create(const EmuValuesList&) {return new Pk8000ColBufSelector();}
 
     private:
@@ -239,6 +257,9 @@ class Pk8000Core : public PlatformCore
 
         void attachCrtRenderer(Pk8000Renderer* crtRenderer);
 
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
+
         static EmuObject* create(const EmuValuesList&) {return new Pk8000Core();}
     private:
         Pk8000Renderer* m_crtRenderer = nullptr;
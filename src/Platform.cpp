@@ -17,6 +17,10 @@
  */
 
 #include <sstream>
+#include <string.h>
+
+#include "Pal.h"
+#include "PalFile.h"
 
 #include "Platform.h"
 #include "Emulation.h"
@@ -33,6 +37,11 @@
 #include "Keyboard.h"
 #include "RamDisk.h"
 #include "Debugger.h"
+#include "Ppi8255.h"
+#include "Snapshot.h"
+#include "RewindBuffer.h"
+#include "GdbStub.h"
+#include "InputMovie.h"
 
 using namespace std;
 
@@ -123,6 +132,8 @@ Platform::Platform(string configFileName, string name)
         m_window->show();
 
     reset();
+
+    updateRewindOptions();
 }
 
 
@@ -142,11 +153,20 @@ void Platform::reset()
 
 Platform::~Platform()
 {
+    if (GdbStub* gdbStub = g_emulation->getGdbStub())
+        gdbStub->detachCpu(m_cpu);
+
+    InputMovie* movie = g_emulation->getMovie();
+    if (movie && movie->getPlatform() == this)
+        g_emulation->stopMovie();
+
     for (auto it = m_objList.begin(); it != m_objList.end(); it++)
         delete *it;
 
     if (m_dbgWindow)
         delete m_dbgWindow;
+
+    delete m_rewindBuffer;
 }
 
 
@@ -231,6 +251,15 @@ void Platform::sysReq(SysReq sr)
             if (m_ramDisk)
             m_ramDisk->saveToFile();
             break;
+        case SR_SAVESTATE:
+            chooseAndSaveSnapshot();
+            break;
+        case SR_LOADSTATE:
+            chooseAndLoadSnapshot();
+            break;
+        case SR_REWIND:
+            rewind();
+            break;
         default:
             break;
     }
@@ -332,3 +361,168 @@ string Platform::getAllDebugInfo()
     }
     return res;
 }
+
+
+static const char* c_snapshotMagic = "EMU80SNP";
+static const uint32_t c_snapshotVersion = 1;
+static const char* c_snapshotFilter = "Emu80 save states (*.esn)|*.esn;*.ESN";
+
+
+void Platform::saveState(SnapshotWriter& writer)
+{
+    writer.writeString(getName());
+
+    // each object is stored in a section named without platform prefix
+    string prefix = getName() + ".";
+    for (auto it = m_objList.begin(); it != m_objList.end(); it++) {
+        string name = (*it)->getName();
+        if (name.compare(0, prefix.size(), prefix) == 0)
+            name = name.substr(prefix.size());
+        writer.beginSection(name);
+        (*it)->saveState(writer);
+        writer.endSection();
+    }
+}
+
+
+void Platform::loadState(SnapshotReader& reader)
+{
+    if (reader.readString() != getName()) {
+        reader.setInvalid();
+        return;
+    }
+
+    vector<pair<EmuObject*, SnapshotReader> > sections;
+    while (reader.isValid() && !reader.isEnd()) {
+        string name;
+        SnapshotReader sectionReader(nullptr, 0);
+        if (!reader.readSection(name, sectionReader))
+            break;
+        EmuObject* obj = g_emulation->findObject(getName() + "." + name);
+        if (!obj) {
+            emuLog << "Snapshot: unknown object " << name << "\n";
+            continue;
+        }
+        // PPIs restore their circuits by repeating output values which may affect
+        // other devices, so they are loaded first and other devices overwrite these changes
+        if (dynamic_cast<Ppi8255*>(obj))
+            sections.insert(sections.begin(), make_pair(obj, sectionReader));
+        else
+            sections.push_back(make_pair(obj, sectionReader));
+    }
+
+    for (auto it = sections.begin(); it != sections.end(); it++) {
+        it->first->loadState(it->second);
+        if (!it->second.isValid()) {
+            emuLog << "Snapshot: invalid data for object " << it->first->getName() << "\n";
+            reader.setInvalid();
+        }
+    }
+
+    AddressableDevice::invalidateDirectPages();
+    resetKeys();
+}
+
+
+bool Platform::saveSnapshot(const string& fileName)
+{
+    SnapshotWriter writer(g_emulation->getCurClock());
+    writer.writeBuf((const uint8_t*)c_snapshotMagic, 8);
+    writer.write32(c_snapshotVersion);
+    saveState(writer);
+
+    PalFile file;
+    file.open(fileName, "w");
+    if (!file.isOpen())
+        return false;
+
+    const vector<uint8_t>& data = writer.getData();
+    for (auto it = data.begin(); it != data.end(); it++)
+        file.write8(*it);
+
+    file.close();
+    return true;
+}
+
+
+bool Platform::loadSnapshot(const string& fileName)
+{
+    int fileSize;
+    uint8_t* buf = palReadFile(fileName, fileSize, false);
+    if (!buf)
+        return false;
+
+    bool res = false;
+    if (fileSize < 12 || memcmp(buf, c_snapshotMagic, 8) != 0)
+        emuLog << "Not a save state file: " << fileName << "\n";
+    else {
+        SnapshotReader reader(buf, fileSize, g_emulation->getCurClock());
+        for (int i = 0; i < 8; i++)
+            reader.read8();
+        if (reader.read32() != c_snapshotVersion)
+            emuLog << "Unsupported save state version: " << fileName << "\n";
+        else {
+            loadState(reader);
+            if (reader.isValid())
+                res = true;
+            else {
+                // partially loaded state is inconsistent
+                emuLog << "Invalid save state file: " << fileName << "\n";
+                reset();
+            }
+        }
+    }
+
+    delete[] buf;
+    return res;
+}
+
+
+void Platform::chooseAndSaveSnapshot()
+{
+    string fileName = palOpenFileDialog("Save state", c_snapshotFilter, true, m_window);
+    g_emulation->restoreFocus();
+    if (fileName != "")
+        saveSnapshot(fileName);
+}
+
+
+void Platform::chooseAndLoadSnapshot()
+{
+    string fileName = palOpenFileDialog("Load state", c_snapshotFilter, false, m_window);
+    g_emulation->restoreFocus();
+    if (fileName != "")
+        loadSnapshot(fileName);
+}
+
+
+void Platform::updateRewindOptions()
+{
+    unsigned depth = g_emulation->getRewindDepth();
+    if (!depth) {
+        delete m_rewindBuffer;
+        m_rewindBuffer = nullptr;
+        return;
+    }
+
+    if (!m_rewindBuffer)
+        m_rewindBuffer = new RewindBuffer(this);
+    m_rewindBuffer->setDepth(depth);
+    m_rewindBuffer->setMemoryLimit(g_emulation->getRewindMemoryLimit());
+}
+
+
+void Platform::captureRewindState()
+{
+    if (m_rewindBuffer)
+        m_rewindBuffer->capture();
+}
+
+
+// Steps back for a half of second
+bool Platform::rewind()
+{
+    if (!m_rewindBuffer)
+        return false;
+    return m_rewindBuffer->stepBack(RewindBuffer::c_capturesPerSecond / 2);
+}
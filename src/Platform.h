@@ -36,6 +36,7 @@ class CrtRenderer;
 class Keyboard;
 class FdImage;
 class DebugWindow;
+class RewindBuffer;
 
 
 class Platform : public ParentObject
@@ -56,6 +57,19 @@ class Platform : public ParentObject
         void resetKeys();
         /*virtual */void loadFile(std::string fileName);
 
+        // Save states
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
+        bool saveSnapshot(const std::string& fileName);
+        bool loadSnapshot(const std::string& fileName);
+        void chooseAndSaveSnapshot();
+        void chooseAndLoadSnapshot();
+
+        // Rewind, options are taken from emulation object
+        void updateRewindOptions();
+        void captureRewindState();
+        bool rewind();
+
         const std::string& getBaseDir() {return m_baseDir;}
 
         EmuWindow* getWindow() {return m_window;}
@@ -90,6 +104,7 @@ class Platform : public ParentObject
         int m_defConfigTabId = 0;
 
         DebugWindow* m_dbgWindow = nullptr;
+        RewindBuffer* m_rewindBuffer = nullptr;
 
         std::string m_helpFile = "";
         CodePage m_codePage = CP_RK;
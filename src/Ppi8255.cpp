@@ -25,6 +25,7 @@
 #include "Emulation.h"
 #include "RkKeyboard.h"
 #include "SoundMixer.h"
+#include "Snapshot.h"
 
 using namespace std;
 
@@ -151,6 +152,44 @@ uint8_t Ppi8255::readByte(int addr)
 
 
 
+void Ppi8255::saveState(SnapshotWriter& writer)
+{
+    writer.write8(m_portA);
+    writer.write8(m_portB);
+    writer.write8(m_portC);
+    writer.writeInt(m_chAMode);
+    writer.writeInt(m_chBMode);
+    writer.writeInt(m_chCHiMode);
+    writer.writeInt(m_chCLoMode);
+}
+
+
+void Ppi8255::loadState(SnapshotReader& reader)
+{
+    m_portA = reader.read8();
+    m_portB = reader.read8();
+    m_portC = reader.read8();
+    m_chAMode = PpiChMode(reader.readInt());
+    m_chBMode = PpiChMode(reader.readInt());
+    m_chCHiMode = PpiChMode(reader.readInt());
+    m_chCLoMode = PpiChMode(reader.readInt());
+
+    // restore circuit state by repeating modes and output values
+    if (m_ppiCircuit) {
+        m_ppiCircuit->setPortAMode(m_chAMode == PCM_IN);
+        m_ppiCircuit->setPortBMode(m_chBMode == PCM_IN);
+        m_ppiCircuit->setPortCLoMode(m_chCLoMode == PCM_IN);
+        m_ppiCircuit->setPortCHiMode(m_chCHiMode == PCM_IN);
+        if (m_chAMode == PCM_OUT)
+            m_ppiCircuit->setPortA(m_portA);
+        if (m_chBMode == PCM_OUT)
+            m_ppiCircuit->setPortB(m_portB);
+        if (m_chCLoMode == PCM_OUT || m_chCHiMode == PCM_OUT)
+            m_ppiCircuit->setPortC(m_portC);
+    }
+}
+
+
 void Ppi8255::attachPpi8255Circuit(Ppi8255Circuit* circuit)
 {
     m_ppiCircuit = circuit;
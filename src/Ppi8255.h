@@ -48,6 +48,9 @@ class Ppi8255 : public AddressableDevice
         void writeByte(int addr, uint8_t value) override;
         uint8_t readByte(int addr) override;
 
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
+
         // Подключение объекта - обвязки ВВ55
         void attachPpi8255Circuit(Ppi8255Circuit* circuit);
 
@@ -26,10 +26,45 @@
 
 #include "Emulation.h"
 #include "Psg3910.h"
+#include "Snapshot.h"
 
 using namespace std;
 
 
+// Output values are fixed point with PSG_AMP_SHIFT fractional bits
+static const int PSG_AMP_SHIFT = 16;
+
+// Logarithmic DAC table from Emuscriptoria (0.0 ... 1.0 scaled to fixed point)
+static const unsigned c_psgAmps[16] =
+{0, 898, 1343, 1907, 2779, 4050, 5551, 8972, 11082, 17347, 23115, 29485, 37382, 44807, 55588, 65536};
+
+
+// Returns number of steps till next counter overflow
+static inline unsigned stepsToOverflow(unsigned counter, unsigned period)
+{
+    return counter + 1 >= period ? 1 : period - counter;
+}
+
+
+// Advances counter by nSteps steps and returns number of overflows
+static inline uint64_t advanceCounter(unsigned& counter, unsigned period, uint64_t nSteps)
+{
+    unsigned first = stepsToOverflow(counter, period);
+    if (nSteps < first) {
+        counter += nSteps;
+        return 0;
+    }
+
+    nSteps -= first;
+    if (period <= 1) {
+        counter = 0;
+        return nSteps + 1;
+    }
+    counter = nSteps % period;
+    return nSteps / period + 1;
+}
+
+
 Psg3910::Psg3910()
 {
     m_prevClock = g_emulation->getCurClock();
@@ -60,16 +95,19 @@ void Psg3910::reset()
         m_counters[i].noiseGate = true;
         m_counters[i].counter = 0;
         m_counters[i].toneValue = false;
-        m_counters[i].outValue = 0.0;
+        m_counters[i].outValue = 0;
     }
 
-    m_accum = 0.0;
+    m_accum = 0;
+    m_stateChanged = true;
 }
 
 
 void Psg3910::writeByte(int addr, uint8_t value)
 {
-    updateState();
+    g_emulation->getSoundMixer()->update();
+
+    updateState(g_emulation->getCurClock());
 
     if (addr & 1) {
         // reg number
@@ -77,6 +115,7 @@ void Psg3910::writeByte(int addr, uint8_t value)
     } else {
         // register
         m_regs[m_curReg] = value;
+        m_stateChanged = true;
         switch (m_curReg) {
         case 0:
             m_counters[0].freq = (m_counters[0].freq & 0xF00) | value;
@@ -97,7 +136,7 @@ void Psg3910::writeByte(int addr, uint8_t value)
             m_counters[2].freq = (m_counters[2].freq & 0xFF) | ((value & 0x0F) << 8);
             break;
         case 6:
-            m_noiseFreq = (value & 0x1F) << 1; // double freq due to step() called with f/8, not f/16
+            m_noiseFreq = (value & 0x1F) << 1; // double freq due to steps made with f/8, not f/16
             break;
         case 7:
             m_counters[0].toneGate = value & 0x01;
@@ -120,10 +159,10 @@ void Psg3910::writeByte(int addr, uint8_t value)
             m_counters[2].var = value & 0x10;
             break;
         case 0xB:
-            m_envFreq = (m_envFreq & 0x1FE00) | (value << 1);  // double freq due to step() called with f/8, not f/16
+            m_envFreq = (m_envFreq & 0x1FE00) | (value << 1);  // double freq due to steps made with f/8, not f/16
             break;
         case 0xC:
-            m_envFreq = (m_envFreq & 0x1FE) | (value << 9);    // double freq due to step() called with f/8, not f/16
+            m_envFreq = (m_envFreq & 0x1FE) | (value << 9);    // double freq due to steps made with f/8, not f/16
             break;
         case 0xD:
             m_hold = value & 1;
@@ -153,36 +192,87 @@ uint8_t Psg3910::readByte(int addr)
 }
 
 
-void Psg3910::step()
+void Psg3910::saveState(SnapshotWriter& writer)
 {
-    // Logarithmic DAC table from Emuscriptoria
-    static const double logAmps[16] =
-    {0.0, 0.0137, 0.0205, 0.0291, 0.0424, 0.0618, 0.0847, 0.1369, 0.1691, 0.2647, 0.3527, 0.4499, 0.5704, 0.6837, 0.8482, 1.0};
-
-    if (++m_noiseCounter >= m_noiseFreq) {
-        m_noiseCounter = 0;
-        m_noise = (m_noise >> 1) | (((m_noise & 1) ^ ((m_noise & 4) >> 2)) << 16);
-        m_noiseValue = m_noise & 2;
+    writer.writeClock(m_prevClock);
+    writer.writeClock(m_discreteClock);
+    writer.writeDouble(double(m_accum) / (1 << PSG_AMP_SHIFT));
+    writer.writeDouble(double(m_outValue) / (1 << PSG_AMP_SHIFT));
+    writer.write32(m_stepNo);
+    for (int i = 0; i < 3; i++) {
+        Psg3910Counter& cnt = m_counters[i];
+        writer.write32(cnt.freq);
+        writer.write32(cnt.amp);
+        writer.writeBool(cnt.var);
+        writer.writeBool(cnt.toneGate);
+        writer.writeBool(cnt.noiseGate);
+        writer.write32(cnt.counter);
+        writer.writeBool(cnt.toneValue);
+        writer.writeDouble(double(cnt.outValue) / (1 << PSG_AMP_SHIFT));
     }
+    writer.write32(m_noiseFreq);
+    writer.write32(m_envFreq);
+    writer.write32(m_envCounter);
+    writer.write32(m_envCounter2);
+    writer.writeBool(m_att);
+    writer.writeBool(m_alt);
+    writer.writeBool(m_hold);
+    writer.writeInt(m_noise);
+    writer.writeBool(m_noiseValue);
+    writer.write32(m_noiseCounter);
+    writer.write32(m_envValue);
+    writer.write32(m_curReg);
+    writer.writeBuf(m_regs, sizeof(m_regs));
+}
 
-    if (++m_envCounter >= m_envFreq) {
-        m_envCounter = 0;
-        envStep();
+
+void Psg3910::loadState(SnapshotReader& reader)
+{
+    m_prevClock = reader.readClock();
+    m_discreteClock = reader.readClock();
+    m_accum = reader.readDouble() * (1 << PSG_AMP_SHIFT) + 0.5;
+    m_outValue = reader.readDouble() * (1 << PSG_AMP_SHIFT) + 0.5;
+    m_stepNo = reader.read32();
+    for (int i = 0; i < 3; i++) {
+        Psg3910Counter& cnt = m_counters[i];
+        cnt.freq = reader.read32();
+        cnt.amp = reader.read32();
+        cnt.var = reader.readBool();
+        cnt.toneGate = reader.readBool();
+        cnt.noiseGate = reader.readBool();
+        cnt.counter = reader.read32();
+        cnt.toneValue = reader.readBool();
+        cnt.outValue = reader.readDouble() * (1 << PSG_AMP_SHIFT) + 0.5;
     }
+    m_noiseFreq = reader.read32();
+    m_envFreq = reader.read32();
+    m_envCounter = reader.read32();
+    m_envCounter2 = reader.read32();
+    m_att = reader.readBool();
+    m_alt = reader.readBool();
+    m_hold = reader.readBool();
+    m_noise = reader.readInt();
+    m_noiseValue = reader.readBool();
+    m_noiseCounter = reader.read32();
+    m_envValue = reader.read32();
+    m_curReg = reader.read32();
+    reader.readBuf(m_regs, sizeof(m_regs));
+    m_stateChanged = true;
+}
 
-    m_outValue = 0.0;
-    for (unsigned i = 0; i < 3; i++) {
-        if (++m_counters[i].counter >= m_counters[i].freq) {
-            m_counters[i].counter = 0;
-            m_counters[i].toneValue = !m_counters[i].toneValue;
-        }
 
-        bool tone = m_counters[i].freq ? m_counters[i].toneValue : false; // silent if tone freq = 0
-        bool val = (m_counters[i].toneGate || tone) && (m_counters[i].noiseGate || m_noiseValue);
+unsigned Psg3910::calcOutput()
+{
+    unsigned outValue = 0;
+    for (unsigned i = 0; i < 3; i++) {
+        Psg3910Counter& cnt = m_counters[i];
+        bool tone = cnt.freq ? cnt.toneValue : false; // silent if tone freq = 0
+        bool val = (cnt.toneGate || tone) && (cnt.noiseGate || m_noiseValue);
 
-        m_counters[i].outValue = val ? logAmps[m_counters[i].var ? m_envValue : m_counters[i].amp] : 0.0;
-        m_outValue += m_counters[i].outValue;
+        cnt.outValue = val ? c_psgAmps[cnt.var ? m_envValue : cnt.amp] : 0;
+        outValue += cnt.outValue;
     }
+    return outValue;
 }
 
 
@@ -201,36 +291,122 @@ void Psg3910::envStep()
 }
 
 
-void Psg3910::updateState()
+void Psg3910::envSteps(uint64_t nSteps)
 {
-    uint64_t curClock = g_emulation->getCurClock();
+    // envelope state is periodic with 32 steps after the first one unless it's held
+    if (!m_hold && nSteps > 33)
+        nSteps = 1 + (nSteps - 1) % 32;
 
-    while(m_discreteClock < curClock) {
-        step();
-        m_accum += m_outValue * m_kDiv * 8;
-        m_discreteClock += m_kDiv * 8;
+    while (nSteps--) {
+        bool held = m_envCounter2 >= 16 && m_hold;
+        envStep();
+        if (held)
+            break; // further steps don't change anything
     }
 }
 
 
-uint16_t Psg3910::getOutput()
+// True if envelope is held and further envelope steps don't change its value
+bool Psg3910::isEnvHeld()
 {
-    updateState();
+    return m_envCounter2 >= 16 && m_hold && m_envValue == ((m_alt ? m_att : !m_att) ? 0u : 15u);
+}
+
+
+void Psg3910::noiseSteps(uint64_t nSteps)
+{
+    if (!nSteps)
+        return;
+    while (nSteps--)
+        m_noise = (m_noise >> 1) | (((m_noise & 1) ^ ((m_noise & 4) >> 2)) << 16);
+    m_noiseValue = m_noise & 2;
+}
+
+
+// Output changes only when a tone, noise or envelope counter which is audible at the moment
+// overflows, so we jump from one such event to another and integrate constant output in between.
+// Counters which can't affect output are advanced in bulk.
+void Psg3910::updateState(uint64_t curClock)
+{
+    if (m_discreteClock >= curClock)
+        return;
+
+    unsigned stepClocks = m_kDiv * 8;
+    uint64_t nSteps = (curClock - m_discreteClock + stepClocks - 1) / stepClocks;
+    m_discreteClock += nSteps * stepClocks;
+
+    unsigned outValue = m_outValue;
+
+    if (m_stateChanged) {
+        m_stateChanged = false;
+        m_noiseAudible = false;
+        m_envAudible = false;
+        for (unsigned i = 0; i < 3; i++) {
+            Psg3910Counter& cnt = m_counters[i];
+            bool silent = !cnt.var && !cnt.amp;
+            m_toneAudible[i] = !silent && !cnt.toneGate && cnt.freq;
+            m_noiseAudible = m_noiseAudible || (!silent && !cnt.noiseGate);
+            m_envAudible = m_envAudible || cnt.var;
+        }
+        outValue = calcOutput();
+    }
 
-    uint64_t curClock = g_emulation->getCurClock();
+    while (nSteps) {
+        // find next step at which output may change
+        uint64_t n = nSteps;
+        bool event = false;
+        unsigned steps;
+        if (m_noiseAudible && (steps = stepsToOverflow(m_noiseCounter, m_noiseFreq)) <= n) {
+            n = steps;
+            event = true;
+        }
+        if (m_envAudible && !isEnvHeld() && (steps = stepsToOverflow(m_envCounter, m_envFreq)) <= n) {
+            n = steps;
+            event = true;
+        }
+        for (unsigned i = 0; i < 3; i++)
+            if (m_toneAudible[i] && (steps = stepsToOverflow(m_counters[i].counter, m_counters[i].freq)) <= n) {
+                n = steps;
+                event = true;
+            }
+
+        // output is constant during first n - 1 steps
+        m_accum += uint64_t(outValue) * (n - 1) * stepClocks;
+
+        noiseSteps(advanceCounter(m_noiseCounter, m_noiseFreq, n));
+        envSteps(advanceCounter(m_envCounter, m_envFreq, n));
+        for (unsigned i = 0; i < 3; i++)
+            if (advanceCounter(m_counters[i].counter, m_counters[i].freq, n) & 1)
+                m_counters[i].toneValue = !m_counters[i].toneValue;
+
+        if (event)
+            outValue = calcOutput();
+        m_accum += uint64_t(outValue) * stepClocks;
+
+        nSteps -= n;
+    }
+
+    m_outValue = outValue;
+}
+
+
+uint16_t Psg3910::getOutput(uint64_t curClock)
+{
+    updateState(curClock);
 
-    double delta = m_outValue * (m_discreteClock - curClock);
-    uint16_t res = (m_accum - delta) / (curClock - m_prevClock) * SND_AMP;
+    uint64_t delta = uint64_t(m_outValue) * (m_discreteClock - curClock);
+    uint64_t clocks = curClock - m_prevClock;
+    uint64_t avg = clocks ? (m_accum - delta) / clocks : m_outValue;
     m_accum = delta;
     m_prevClock = curClock;
 
-    return res;
+    return avg * SND_AMP >> PSG_AMP_SHIFT;
 }
 
 
-int Psg3910SoundSource::calcValue()
+int Psg3910SoundSource::calcValue(uint64_t clock)
 {
-    return m_psg ? m_psg->getOutput() : 0;
+    return m_psg ? m_psg->getOutput(clock) : 0;
 }
 
 
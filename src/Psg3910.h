@@ -51,8 +51,11 @@ class Psg3910 : public AddressableDevice
         void writeByte(int addr, uint8_t value) override;
         uint8_t readByte(int addr) override;
 
-        void updateState();
-        uint16_t getOutput();
+        void updateState(uint64_t curClock);
+        uint16_t getOutput(uint64_t curClock);
+
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
 
         static EmuObject* create(const EmuValuesList&) {return new Psg3910();}
 
@@ -66,13 +69,13 @@ class Psg3910 : public AddressableDevice
 
             unsigned counter;
             bool toneValue;
-            double outValue;
+            unsigned outValue;
         };
 
         uint64_t m_prevClock = 0;
         uint64_t m_discreteClock = 0;
-        double m_accum = 0.0;
-        double m_outValue = 0;
+        uint64_t m_accum = 0;       // output integrated over clocks, fixed point
+        unsigned m_outValue = 0;    // output after the last step, fixed point
         unsigned m_stepNo = 0;
 
         Psg3910Counter m_counters[3];
@@ -80,20 +83,29 @@ class Psg3910 : public AddressableDevice
         unsigned m_envFreq;
         unsigned m_envCounter;
         unsigned m_envCounter2;
-        bool m_att;
-        bool m_alt;
-        bool m_hold;
+        bool m_att = false;
+        bool m_alt = false;
+        bool m_hold = false;
 
         int m_noise;
-        bool m_noiseValue;
+        bool m_noiseValue = false;
         unsigned m_noiseCounter;
         unsigned m_envValue = 0;
 
         unsigned m_curReg;
         uint8_t m_regs[16];
 
-        void step();
+        // which counters may change output, valid while m_stateChanged is false
+        bool m_stateChanged = true;
+        bool m_toneAudible[3];
+        bool m_noiseAudible;
+        bool m_envAudible;
+
+        unsigned calcOutput();
         void envStep();
+        void envSteps(uint64_t nSteps);
+        void noiseSteps(uint64_t nSteps);
+        bool isEnvHeld();
 };
 
 
@@ -101,7 +113,7 @@ class Psg3910SoundSource : public SoundSource
 {
     public:
         bool setProperty(const std::string& propertyName, const EmuValuesList& values) override;
-        int calcValue() override;
+        int calcValue(uint64_t clock) override;
 
         void attachPsg(Psg3910* psg) {m_psg = psg;}
 
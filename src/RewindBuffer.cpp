@@ -0,0 +1,214 @@
+﻿/*
+ *  Emu80 v. 4.x
+ *  © Viktor Pykhonin <pyk@mail.ru>, 2016-2019
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "RewindBuffer.h"
+#include "Emulation.h"
+#include "Platform.h"
+#include "Snapshot.h"
+
+using namespace std;
+
+
+// Encoded data is a sequence of (unchanged bytes count, changed bytes count, XOR values)
+// records with counts stored as 7-bit varints
+
+static inline void writeVarint(vector<uint8_t>& out, unsigned value)
+{
+    while (value >= 0x80) {
+        out.push_back((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(value);
+}
+
+
+static inline bool readVarint(const vector<uint8_t>& data, unsigned& pos, unsigned& value)
+{
+    value = 0;
+    for (int shift = 0; pos < data.size() && shift < 32; shift += 7) {
+        uint8_t b = data[pos++];
+        value |= (b & 0x7F) << shift;
+        if (!(b & 0x80))
+            return true;
+    }
+    return false;
+}
+
+
+RewindBuffer::RewindBuffer(Platform* platform)
+{
+    m_platform = platform;
+}
+
+
+void RewindBuffer::setDepth(unsigned seconds)
+{
+    m_maxFrames = seconds * c_capturesPerSecond;
+    dropOldFrames();
+}
+
+
+void RewindBuffer::setMemoryLimit(unsigned megabytes)
+{
+    m_memoryLimit = size_t(megabytes) * 1024 * 1024;
+    dropOldFrames();
+}
+
+
+void RewindBuffer::encode(const vector<uint8_t>& state, const vector<uint8_t>* base, vector<uint8_t>& out)
+{
+    // runs of less than 4 unchanged bytes are included into changed ones
+    const unsigned minGap = 4;
+
+    unsigned size = state.size();
+    const uint8_t* cur = state.data();
+    const uint8_t* prev = base ? base->data() : nullptr;
+
+    unsigned pos = 0;
+    while (pos < size) {
+        unsigned start = pos;
+        if (prev) {
+            // skip unchanged blocks first
+            while (pos + 64 <= size && !memcmp(cur + pos, prev + pos, 64))
+                pos += 64;
+            while (pos + 8 <= size && !memcmp(cur + pos, prev + pos, 8))
+                pos += 8;
+            while (pos < size && cur[pos] == prev[pos])
+                pos++;
+        } else
+            while (pos < size && !cur[pos])
+                pos++;
+        if (pos == size)
+            break;
+
+        unsigned litStart = pos;
+        unsigned litEnd = pos;
+        for (; pos < size && pos - litEnd < minGap; pos++)
+            if (cur[pos] != (prev ? prev[pos] : 0))
+                litEnd = pos + 1;
+
+        writeVarint(out, litStart - start);
+        writeVarint(out, litEnd - litStart);
+        for (unsigned i = litStart; i < litEnd; i++)
+            out.push_back(cur[i] ^ (prev ? prev[i] : 0));
+        pos = litEnd;
+    }
+}
+
+
+bool RewindBuffer::apply(const RewindFrame& frame, vector<uint8_t>& state)
+{
+    if (frame.isKeyframe)
+        state.assign(frame.stateSize, 0);
+    else if (state.size() != frame.stateSize)
+        return false;
+
+    const vector<uint8_t>& data = frame.data;
+    unsigned size = state.size();
+    unsigned pos = 0;
+    unsigned dataPos = 0;
+    while (dataPos < data.size()) {
+        unsigned skip, len;
+        if (!readVarint(data, dataPos, skip) || !readVarint(data, dataPos, len))
+            return false;
+        pos += skip;
+        if (pos > size || len > size - pos || len > data.size() - dataPos)
+            return false;
+        for (unsigned i = 0; i < len; i++)
+            state[pos++] ^= data[dataPos++];
+    }
+    return true;
+}
+
+
+void RewindBuffer::capture()
+{
+    uint64_t curClock = g_emulation->getCurClock();
+    if (!m_frames.empty() && curClock - m_lastCaptureClock < uint64_t(g_emulation->getFrequency()) / c_capturesPerSecond)
+        return;
+    m_lastCaptureClock = curClock;
+
+    SnapshotWriter writer(curClock);
+    writer.reserve(m_lastState.size());
+    m_platform->saveState(writer);
+    vector<uint8_t> state;
+    writer.swapData(state);
+
+    RewindFrame frame;
+    frame.isKeyframe = m_frames.empty() || m_framesSinceKeyframe >= c_keyframeInterval || state.size() != m_lastState.size();
+    frame.stateSize = state.size();
+    encode(state, frame.isKeyframe ? nullptr : &m_lastState, frame.data);
+    frame.data.shrink_to_fit();
+
+    m_framesSinceKeyframe = frame.isKeyframe ? 1 : m_framesSinceKeyframe + 1;
+    m_memoryUsed += frame.data.size();
+    m_frames.push_back(std::move(frame));
+    m_lastState.swap(state);
+
+    dropOldFrames();
+}
+
+
+void RewindBuffer::dropOldFrames()
+{
+    // frames are dropped by whole keyframe groups, the last group is always kept
+    while (m_frames.size() > m_maxFrames || m_memoryUsed > m_memoryLimit) {
+        unsigned nextKeyframe = 1;
+        while (nextKeyframe < m_frames.size() && !m_frames[nextKeyframe].isKeyframe)
+            nextKeyframe++;
+        if (nextKeyframe == m_frames.size())
+            break;
+        for (unsigned i = 0; i < nextKeyframe; i++) {
+            m_memoryUsed -= m_frames.front().data.size();
+            m_frames.pop_front();
+        }
+    }
+}
+
+
+bool RewindBuffer::stepBack(unsigned nCaptures)
+{
+    if (m_frames.empty())
+        return false;
+
+    unsigned target = m_frames.size() > nCaptures ? m_frames.size() - 1 - nCaptures : 0;
+    unsigned keyframe = target;
+    while (keyframe > 0 && !m_frames[keyframe].isKeyframe)
+        keyframe--;
+
+    vector<uint8_t> state;
+    for (unsigned i = keyframe; i <= target; i++)
+        if (!apply(m_frames[i], state))
+            return false;
+
+    SnapshotReader reader(state.data(), state.size(), g_emulation->getCurClock());
+    m_platform->loadState(reader);
+
+    // states after the restored one are discarded
+    while (m_frames.size() > target + 1) {
+        m_memoryUsed -= m_frames.back().data.size();
+        m_frames.pop_back();
+    }
+    m_framesSinceKeyframe = target - keyframe + 1;
+    m_lastState.swap(state);
+    m_lastCaptureClock = g_emulation->getCurClock();
+
+    return reader.isValid();
+}
@@ -0,0 +1,78 @@
+﻿/*
+ *  Emu80 v. 4.x
+ *  © Viktor Pykhonin <pyk@mail.ru>, 2016-2019
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Rewind buffer: recent platform states kept in memory
+
+#ifndef REWINDBUFFER_H
+#define REWINDBUFFER_H
+
+#include <deque>
+#include <vector>
+
+#include "EmuTypes.h"
+
+class Platform;
+
+
+// States are captured periodically as keyframes followed by deltas to the previous state.
+// Both are stored XOR/RLE-encoded (keyframes against zero-filled state), so unchanged
+// memory pages and empty RAM disk areas take almost no space.
+class RewindBuffer
+{
+    public:
+        RewindBuffer(Platform* platform);
+
+        void setDepth(unsigned seconds);
+        void setMemoryLimit(unsigned megabytes);
+
+        // Captures platform state if the capture period has passed since the last capture
+        void capture();
+
+        // Restores the state captured nCaptures periods before the last one
+        bool stepBack(unsigned nCaptures);
+
+        unsigned getCaptureCount() {return m_frames.size();}
+        size_t getMemoryUsed() {return m_memoryUsed;}
+
+        static const unsigned c_capturesPerSecond = 50;
+        static const unsigned c_keyframeInterval = 16;
+
+    private:
+        struct RewindFrame {
+            bool isKeyframe;
+            unsigned stateSize;
+            std::vector<uint8_t> data;
+        };
+
+        Platform* m_platform;
+
+        std::deque<RewindFrame> m_frames;
+        std::vector<uint8_t> m_lastState;
+        uint64_t m_lastCaptureClock = 0;
+        unsigned m_framesSinceKeyframe = 0;
+
+        unsigned m_maxFrames = 0;
+        size_t m_memoryLimit = 0;
+        size_t m_memoryUsed = 0;
+
+        void encode(const std::vector<uint8_t>& state, const std::vector<uint8_t>* base, std::vector<uint8_t>& out);
+        bool apply(const RewindFrame& frame, std::vector<uint8_t>& state);
+        void dropOldFrames();
+};
+
+#endif // REWINDBUFFER_H
@@ -0,0 +1,130 @@
+﻿/*
+ *  Emu80 v. 4.x
+ *  © Viktor Pykhonin <pyk@mail.ru>, 2016-2019
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EmuObjects.h"
+#include "Scheduler.h"
+
+using namespace std;
+
+
+inline bool Scheduler::less(IActive* dev1, IActive* dev2)
+{
+    return dev1->m_schedClock < dev2->m_schedClock || (dev1->m_schedClock == dev2->m_schedClock && dev1->m_schedSeqNo < dev2->m_schedSeqNo);
+}
+
+
+inline void Scheduler::place(IActive* device, int pos)
+{
+    m_heap[pos] = device;
+    device->m_schedPos = pos;
+}
+
+
+void Scheduler::siftUp(int pos)
+{
+    IActive* device = m_heap[pos];
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (!less(device, m_heap[parent]))
+            break;
+        place(m_heap[parent], pos);
+        pos = parent;
+    }
+    place(device, pos);
+}
+
+
+void Scheduler::siftDown(int pos)
+{
+    int size = m_heap.size();
+    IActive* device = m_heap[pos];
+    for (;;) {
+        int child = pos * 2 + 1;
+        if (child >= size)
+            break;
+        if (child + 1 < size && less(m_heap[child + 1], m_heap[child]))
+            child++;
+        if (!less(m_heap[child], device))
+            break;
+        place(m_heap[child], pos);
+        pos = child;
+    }
+    place(device, pos);
+}
+
+
+void Scheduler::addDevice(IActive* device)
+{
+    device->m_schedSeqNo = m_lastSeqNo++;
+    device->m_schedClock = device->getEffectiveClock();
+    m_heap.push_back(device);
+    siftUp(m_heap.size() - 1);
+}
+
+
+void Scheduler::removeDevice(IActive* device)
+{
+    int pos = device->m_schedPos;
+    if (pos < 0)
+        return;
+
+    device->m_schedPos = -1;
+    IActive* last = m_heap.back();
+    m_heap.pop_back();
+    if (last == device)
+        return;
+
+    place(last, pos);
+    siftUp(pos);
+    siftDown(last->m_schedPos);
+}
+
+
+void Scheduler::update(IActive* device)
+{
+    int pos = device->m_schedPos;
+    if (pos < 0)
+        return;
+
+    uint64_t clock = device->getEffectiveClock();
+    if (clock == device->m_schedClock)
+        return;
+
+    device->m_schedClock = clock;
+    siftUp(pos);
+    siftDown(device->m_schedPos);
+}
+
+
+IActive* Scheduler::getNextDevice()
+{
+    if (m_heap.empty())
+        return nullptr;
+
+    // Stored keys are never greater than actual clocks, so the top is valid
+    // as soon as its stored key matches the actual one
+    IActive* device = m_heap[0];
+    uint64_t clock;
+    while ((clock = device->getEffectiveClock()) != device->m_schedClock) {
+        device->m_schedClock = clock;
+        siftDown(0);
+        device = m_heap[0];
+    }
+
+    return clock != (uint64_t)-1 ? device : nullptr;
+}
@@ -0,0 +1,80 @@
+﻿/*
+ *  Emu80 v. 4.x
+ *  © Viktor Pykhonin <pyk@mail.ru>, 2016-2019
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Scheduler.h
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <vector>
+
+#include "EmuObjects.h"
+
+
+// Планировщик активных устройств
+// Binary min-heap of active devices ordered by (clock, registration order).
+// Devices changing their own clock forward inside operate() are re-sorted lazily
+// when they reach the top of the heap, so only clock decreases (syncronize,
+// resume) need an explicit update() call.
+class Scheduler
+{
+    public:
+        void addDevice(IActive* device);
+        void removeDevice(IActive* device);
+
+        // Re-sorts device after its clock or pause state has changed
+        void update(IActive* device);
+
+        // Returns device with the smallest clock or nullptr if all devices are paused
+        IActive* getNextDevice();
+
+        // Returns true if device is still the next one to operate (used for batched execution)
+        inline bool isNextDevice(IActive* device);
+
+        int getDeviceCount() {return m_heap.size();}
+
+    private:
+        std::vector<IActive*> m_heap;
+        unsigned m_lastSeqNo = 0;
+
+        inline bool less(IActive* dev1, IActive* dev2);
+        void siftUp(int pos);
+        void siftDown(int pos);
+        inline void place(IActive* device, int pos);
+};
+
+
+// Children of the root hold the smallest keys of all other devices. Their stored keys
+// may be lower than actual clocks, which only makes the check conservative.
+inline bool Scheduler::isNextDevice(IActive* device)
+{
+    if (device->m_schedPos != 0)
+        return false;
+
+    uint64_t clock = device->getEffectiveClock();
+    int size = m_heap.size();
+    for (int i = 1; i <= 2 && i < size; i++) {
+        IActive* other = m_heap[i];
+        if (other->m_schedClock < clock || (other->m_schedClock == clock && other->m_schedSeqNo < device->m_schedSeqNo))
+            return false;
+    }
+    return clock != (uint64_t)-1;
+}
+
+
+#endif  // SCHEDULER_H
@@ -36,6 +36,10 @@ SysReq TranslateKeyToSysReq(PalKeyCode key, bool isKeyDown, bool isAltPressed)
                 return SR_CONFIG;
             case PK_F1:
                 return SR_HELP;
+            case PK_F2:
+                return SR_SAVESTATE;
+            case PK_F5:
+                return SR_LOADSTATE;
             case PK_F3:
                 return SR_LOADRUN;
             case PK_L:
@@ -86,6 +90,8 @@ SysReq TranslateKeyToSysReq(PalKeyCode key, bool isKeyDown, bool isAltPressed)
                 return SR_SCREENSHOT;
             case PK_U:
                 return SR_MUTE;
+            case PK_BSP:
+                return SR_REWIND;
             default:
                 return SR_NONE;
         } else {
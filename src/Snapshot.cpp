@@ -0,0 +1,191 @@
+﻿/*
+ *  Emu80 v. 4.x
+ *  © Viktor Pykhonin <pyk@mail.ru>, 2016-2019
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "Snapshot.h"
+
+using namespace std;
+
+
+void SnapshotWriter::write16(uint16_t value)
+{
+    write8(value & 0xFF);
+    write8(value >> 8);
+}
+
+
+void SnapshotWriter::write32(uint32_t value)
+{
+    write16(value & 0xFFFF);
+    write16(value >> 16);
+}
+
+
+void SnapshotWriter::write64(uint64_t value)
+{
+    write32(value & 0xFFFFFFFF);
+    write32(value >> 32);
+}
+
+
+void SnapshotWriter::writeDouble(double value)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    write64(bits);
+}
+
+
+void SnapshotWriter::writeBuf(const uint8_t* buf, unsigned size)
+{
+    m_data.insert(m_data.end(), buf, buf + size);
+}
+
+
+void SnapshotWriter::writeString(const string& str)
+{
+    write32(str.size());
+    writeBuf((const uint8_t*)str.data(), str.size());
+}
+
+
+void SnapshotWriter::writeClock(uint64_t clock)
+{
+    // -1 is used as a paused device clock and stored as is
+    bool isInfinite = clock == uint64_t(-1);
+    writeBool(isInfinite);
+    write64(isInfinite ? 0 : clock - m_baseClock);
+}
+
+
+void SnapshotWriter::beginSection(const string& name)
+{
+    m_sectionStart = m_data.size();
+    writeString(name);
+    m_sectionPos = m_data.size();
+    write32(0); // section size, filled in endSection()
+}
+
+
+void SnapshotWriter::endSection()
+{
+    uint32_t size = m_data.size() - m_sectionPos - 4;
+    if (size == 0) {
+        m_data.resize(m_sectionStart);
+        return;
+    }
+    for (int i = 0; i < 4; i++)
+        m_data[m_sectionPos + i] = (size >> (i * 8)) & 0xFF;
+}
+
+
+SnapshotReader::SnapshotReader(const uint8_t* data, unsigned size, uint64_t baseClock)
+{
+    m_data = data;
+    m_size = size;
+    m_baseClock = baseClock;
+}
+
+
+uint8_t SnapshotReader::read8()
+{
+    if (m_pos >= m_size) {
+        m_isValid = false;
+        return 0;
+    }
+    return m_data[m_pos++];
+}
+
+
+uint16_t SnapshotReader::read16()
+{
+    uint16_t lo = read8();
+    return lo | (read8() << 8);
+}
+
+
+uint32_t SnapshotReader::read32()
+{
+    uint32_t lo = read16();
+    return lo | (uint32_t(read16()) << 16);
+}
+
+
+uint64_t SnapshotReader::read64()
+{
+    uint64_t lo = read32();
+    return lo | (uint64_t(read32()) << 32);
+}
+
+
+double SnapshotReader::readDouble()
+{
+    uint64_t bits = read64();
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+
+void SnapshotReader::readBuf(uint8_t* buf, unsigned size)
+{
+    if (size > m_size - m_pos) {
+        m_isValid = false;
+        m_pos = m_size;
+        return;
+    }
+    for (unsigned i = 0; i < size; i++)
+        buf[i] = m_data[m_pos++];
+}
+
+
+string SnapshotReader::readString()
+{
+    unsigned size = read32();
+    if (size > m_size - m_pos) {
+        m_isValid = false;
+        m_pos = m_size;
+        return "";
+    }
+    string str((const char*)m_data + m_pos, size);
+    m_pos += size;
+    return str;
+}
+
+
+uint64_t SnapshotReader::readClock()
+{
+    bool isInfinite = readBool();
+    uint64_t clock = read64();
+    return isInfinite ? uint64_t(-1) : m_baseClock + clock;
+}
+
+
+bool SnapshotReader::readSection(string& name, SnapshotReader& sectionReader)
+{
+    name = readString();
+    unsigned size = read32();
+    if (!m_isValid || size > m_size - m_pos) {
+        m_isValid = false;
+        return false;
+    }
+    sectionReader = SnapshotReader(m_data + m_pos, size, m_baseClock);
+    m_pos += size;
+    return true;
+}
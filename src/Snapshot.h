@@ -0,0 +1,100 @@
+﻿/*
+ *  Emu80 v. 4.x
+ *  © Viktor Pykhonin <pyk@mail.ru>, 2016-2019
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Emulation state snapshots (save states)
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <string>
+#include <vector>
+
+#include "EmuTypes.h"
+
+
+// Serializes object state into a byte buffer (little endian)
+class SnapshotWriter
+{
+    public:
+        // baseClock is the emulation clock at the moment of saving, clock values are stored relative to it
+        SnapshotWriter(uint64_t baseClock = 0) {m_baseClock = baseClock;}
+
+        void write8(uint8_t value) {m_data.push_back(value);}
+        void write16(uint16_t value);
+        void write32(uint32_t value);
+        void write64(uint64_t value);
+        void writeInt(int value) {write32(value);}
+        void writeBool(bool value) {write8(value ? 1 : 0);}
+        void writeDouble(double value);
+        void writeBuf(const uint8_t* buf, unsigned size);
+        void writeString(const std::string& str);
+        void writeClock(uint64_t clock);
+
+        // Sections are named blocks of object data, empty sections are omitted
+        void beginSection(const std::string& name);
+        void endSection();
+
+        const std::vector<uint8_t>& getData() {return m_data;}
+        void swapData(std::vector<uint8_t>& data) {m_data.swap(data);}
+        void reserve(unsigned size) {m_data.reserve(size);}
+
+    private:
+        std::vector<uint8_t> m_data;
+        uint64_t m_baseClock;
+        unsigned m_sectionStart = 0;
+        unsigned m_sectionPos = 0;
+};
+
+
+// Reads data written by SnapshotWriter, on overrun returns zeros and becomes invalid
+class SnapshotReader
+{
+    public:
+        // Clock values are converted to be relative to baseClock
+        SnapshotReader(const uint8_t* data, unsigned size, uint64_t baseClock = 0);
+
+        uint8_t read8();
+        uint16_t read16();
+        uint32_t read32();
+        uint64_t read64();
+        int readInt() {return int(read32());}
+        bool readBool() {return read8() != 0;}
+        double readDouble();
+        void readBuf(uint8_t* buf, unsigned size);
+        std::string readString();
+        uint64_t readClock();
+
+        // Reads next section header, returns reader for the section data
+        bool readSection(std::string& name, SnapshotReader& sectionReader);
+
+        bool isValid() {return m_isValid;}
+        void setInvalid() {m_isValid = false;}
+        bool isEnd() {return m_pos >= m_size;}
+
+        const uint8_t* getData() {return m_data;}
+        unsigned getSize() {return m_size;}
+
+    private:
+        const uint8_t* m_data;
+        unsigned m_size;
+        unsigned m_pos = 0;
+        uint64_t m_baseClock;
+        bool m_isValid = true;
+};
+
+#endif // SNAPSHOT_H
@@ -27,24 +27,52 @@
 
 using namespace std;
 
-// Вызывается 48000 (SAMPLE_RATE) раз в секунду для получения текущего сэмпла и его проигрывания
+// Вызывается раз в SOUND_BLOCK_SIZE сэмплов для формирования очередного блока и его проигрывания
 void SoundMixer::operate()
 {
-    int16_t sample = 0;
+    update();
+
+    m_curClock = m_sampleClock + uint64_t(m_ticksPerSample) * (SOUND_BLOCK_SIZE - 1);
+}
+
+
+void SoundMixer::update()
+{
+    uint64_t curClock = g_emulation->getCurClock();
+
+    while (m_sampleClock <= curClock) {
+        int nSamples = 0;
+        while (nSamples < SOUND_BLOCK_SIZE && m_sampleClock <= curClock) {
+            m_sampleClocks[nSamples++] = m_sampleClock;
+
+            m_sampleClock += m_ticksPerSample;
+
+            m_error += m_ticksPerSampleRemainder;
+            int delta = m_error / m_sampleRate;
+            m_error -= delta * m_sampleRate;
+            m_sampleClock += delta;
+        }
+        renderBlock(nSamples);
+    }
+}
+
+
+void SoundMixer::renderBlock(int nSamples)
+{
+    for (int i = 0; i < nSamples; i++)
+        m_mixBuffer[i] = 0;
+
     for(auto it = m_soundSources.begin(); it != m_soundSources.end(); it++)
-        sample += (*it)->calcValue();
+        (*it)->renderBlock(m_mixBuffer, m_sampleClocks, nSamples);
 
     if (!m_muted)
-        palPlaySample(sample >> m_sampleShift);
+        for (int i = 0; i < nSamples; i++)
+            m_outBuffer[i] = int16_t(m_mixBuffer[i]) >> m_sampleShift;
     else
-        palPlaySample(0);
+        for (int i = 0; i < nSamples; i++)
+            m_outBuffer[i] = 0;
 
-    m_curClock += m_ticksPerSample;
-
-    m_error += m_ticksPerSampleRemainder;
-    int delta = m_error / m_sampleRate;
-    m_error -= delta * m_sampleRate;
-    m_curClock += delta;
+    palPlaySamples(m_outBuffer, nSamples);
 }
 
 
@@ -101,36 +129,26 @@ SoundSource::~SoundSource()
 }
 
 
-void GeneralSoundSource::setValue(int value)
+void SoundSource::renderBlock(int* buffer, const uint64_t* sampleClocks, int nSamples)
 {
-    updateStats();
-    m_curValue = value;
+    for (int i = 0; i < nSamples; i++)
+        buffer[i] += calcValue(sampleClocks[i]);
 }
 
 
-// Обновляет внутренние счетчики, вызывается перед установкой нового значения либо перед получением текущего
-void GeneralSoundSource::updateStats()
+void GeneralSoundSource::setValue(int value)
 {
-    uint64_t curClock = g_emulation->getCurClock();
-    if (m_curValue) {
-        int clocks = curClock - prevClock;
-        sumVal += clocks;
-    }
+    g_emulation->getSoundMixer()->update();
 
-    prevClock = curClock;
-}
+    int prevLevel = m_curValue ? MAX_SIGNAL_AMP : 0;
+    int level = value ? MAX_SIGNAL_AMP : 0;
+    m_blepBuffer.addDelta(g_emulation->getCurClock(), level - prevLevel);
 
-// Получение текущего значения
-int GeneralSoundSource::calcValue()
-{
-    updateStats();
+    m_curValue = value;
+}
 
-    int res = 0;
 
-    uint64_t ticks = g_emulation->getCurClock() - initClock;
-    if (ticks)
-            res = sumVal * MAX_SIGNAL_AMP / ticks;
-    sumVal = 0;
-    initClock = g_emulation->getCurClock();
-    return res;
+void GeneralSoundSource::renderBlock(int* buffer, const uint64_t* sampleClocks, int nSamples)
+{
+    m_blepBuffer.render(buffer, sampleClocks, nSamples);
 }
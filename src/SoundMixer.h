@@ -24,10 +24,14 @@
 #include <list>
 
 #include "EmuObjects.h"
+#include "BlepBuffer.h"
 
 
 const int MAX_SIGNAL_AMP = 4095;
 
+// Максимальное количество сэмплов, формируемых за один вызов микшера
+const int SOUND_BLOCK_SIZE = 256;
+
 class SoundMixer;
 
 // Базовый класс источника звука
@@ -37,28 +41,30 @@ class SoundSource : public EmuObject
         SoundSource();
         virtual ~SoundSource();
 
-        // Получение текущего сэмпла
-        virtual int calcValue() = 0;
+        // Получение сэмпла, заканчивающегося в момент clock.
+        // Источник переопределяет либо calcValue(), либо renderBlock()
+        virtual int calcValue(uint64_t) {return 0;}
+
+        // Добавление к buffer сэмплов, заканчивающихся в моменты sampleClocks.
+        // Состояние источника не меняется в пределах блока: перед каждым изменением вызывается SoundMixer::update()
+        virtual void renderBlock(int* buffer, const uint64_t* sampleClocks, int nSamples);
 };
 
 
-// Простой источник звука
+// Простой источник звука, изменения значения формируются как ступеньки с ограниченным спектром
 class GeneralSoundSource : public SoundSource
 {
     public:
         // derived from SoundSOurce
-        int calcValue() override;
+        void renderBlock(int* buffer, const uint64_t* sampleClocks, int nSamples) override;
 
         // Установка текущего значения источника звука
         void setValue(int value);
 
     private:
         int m_curValue = 0;
-        uint64_t initClock = 0;
-        uint64_t prevClock = 0;
-        int sumVal = 0;
 
-        void updateStats();
+        BlepBuffer m_blepBuffer;
 };
 
 // Звуковой микшер
@@ -74,6 +80,10 @@ class SoundMixer : public ActiveDevice
         // derived from ActiveDevice
         void operate() override;
 
+        // формирует сэмплы вплоть до текущего момента,
+        // должна вызываться перед каждым изменением состояния источников звука
+        void update();
+
         // устанавливет количество тактов на сэмпл (1/SAMPLE_RATE с) на основании тактовой частоты
         void setFrequency(int64_t freq) override;
 
@@ -110,6 +120,16 @@ class SoundMixer : public ActiveDevice
 
         // сдвиг отсчета вправо для уменьшения громкости
         int m_sampleShift = 0;
+
+        // момент окончания следующего сэмпла
+        uint64_t m_sampleClock = 0;
+
+        // буферы формируемого блока
+        uint64_t m_sampleClocks[SOUND_BLOCK_SIZE];
+        int m_mixBuffer[SOUND_BLOCK_SIZE];
+        int16_t m_outBuffer[SOUND_BLOCK_SIZE];
+
+        void renderBlock(int nSamples);
 };
 
 #endif // SOUNDMIXER_H
@@ -20,6 +20,8 @@
 
 #include <string.h>
 
+#include <algorithm>
+
 #include "Pal.h"
 
 #include "Specialist.h"
@@ -32,6 +34,7 @@
 #include "SoundMixer.h"
 #include "WavReader.h"
 #include "Cpu.h"
+#include "Snapshot.h"
 
 using namespace std;
 
@@ -77,6 +80,15 @@ SpecRenderer::SpecRenderer()
 }
 
 
+void SpecRenderer::attachScreenMemory(SpecVideoRam* videoMemory)
+{
+    m_videoRam = videoMemory;
+    m_screenMemory = videoMemory->getDataPtr();
+    m_colorMemory = videoMemory->getColorDataPtr();
+    videoMemory->setWriteTracking(0, videoMemory->getSize());
+}
+
+
 void SpecRenderer::toggleColorMode()
 {
     if (m_colorMode == SCM_MX)
@@ -112,31 +124,66 @@ void SpecRenderer::renderFrame()
         m_aspectRatio = 576.0 * 9 / 704 / 8;
     }
 
+    bool fullUpdate = !m_isImageValid || m_colorMode != m_imageColorMode;
+    if (fullUpdate) {
+        m_imageColorMode = m_colorMode;
+        m_frameImage.resize(384 * 256);
+        m_isImageValid = true;
+    }
+
+    const int blockSize = 1 << Ram::DIRTY_BLOCK_SHIFT;
+    int minCol = 48, maxCol = -1, minRow = 256, maxRow = -1;
+
+    for (int col = 0; col < 48; col++)
+        for (int row = 0; row < 256; row += blockSize) {
+            if (!fullUpdate && !m_videoRam->isBlockDirty(col * 256 + row))
+                continue;
+            renderBlock(col, row, blockSize);
+            minCol = min(minCol, col);
+            maxCol = col;
+            minRow = min(minRow, row);
+            maxRow = max(maxRow, row + blockSize - 1);
+        }
+
+    m_videoRam->clearDirtyBlocks();
+
     for (int row = 0; row < 256; row++)
-        for (int col = 0; col < 48; col++) {
-            int addr = col * 256 + row;
-            uint8_t bt = m_screenMemory[addr];
-            uint8_t colorByte = m_colorMemory[addr];
-            uint32_t fgColor;
-            uint32_t bgColor = 0;
-            switch (m_colorMode) {
-                case SCM_MONO:
-                    fgColor = 0xC0C0C0;
-                    break;
-                case SCM_4COLOR:
-                    fgColor = spec4ColorPalette[(colorByte & 0xC0) >> 6];
-                    break;
-                case SCM_8COLOR:
-                    fgColor = spec8ColorPalette[((colorByte & 0xC0) >> 5) | ((colorByte & 0x10) >> 4)];
-                    break;
-                case SCM_MX:
-                default:
-                    fgColor = spec16ColorPalette[(colorByte & 0xF0) >> 4];
-                    bgColor = spec16ColorPalette[colorByte & 0xF];
-            }
-            for (int pt = 0; pt < 8; pt++, bt <<= 1)
-                m_pixelData[(row + offsetY) * m_sizeX + col * 8 + pt + offsetX] = (bt & 0x80) ? fgColor : bgColor;
+        memcpy(m_pixelData + (row + offsetY) * m_sizeX + offsetX, m_frameImage.data() + row * 384, 384 * sizeof(uint32_t));
+
+    if (maxCol >= 0)
+        setChangedRect(offsetX + minCol * 8, offsetY + minRow, (maxCol - minCol + 1) * 8, maxRow - minRow + 1);
+    else
+        setChangedRect(0, 0, 0, 0);
+}
+
+
+void SpecRenderer::renderBlock(int col, int row, int nRows)
+{
+    for (; nRows > 0; row++, nRows--) {
+        int addr = col * 256 + row;
+        uint8_t bt = m_screenMemory[addr];
+        uint8_t colorByte = m_colorMemory[addr];
+        uint32_t fgColor;
+        uint32_t bgColor = 0;
+        switch (m_colorMode) {
+            case SCM_MONO:
+                fgColor = 0xC0C0C0;
+                break;
+            case SCM_4COLOR:
+                fgColor = spec4ColorPalette[(colorByte & 0xC0) >> 6];
+                break;
+            case SCM_8COLOR:
+                fgColor = spec8ColorPalette[((colorByte & 0xC0) >> 5) | ((colorByte & 0x10) >> 4)];
+                break;
+            case SCM_MX:
+            default:
+                fgColor = spec16ColorPalette[(colorByte & 0xF0) >> 4];
+                bgColor = spec16ColorPalette[colorByte & 0xF];
         }
+        uint32_t* ptr = m_frameImage.data() + row * 384 + col * 8;
+        for (int pt = 0; pt < 8; pt++, bt <<= 1)
+            ptr[pt] = (bt & 0x80) ? fgColor : bgColor;
+    }
 }
 
 
@@ -231,10 +278,27 @@ void SpecVideoRam::setCurColor(uint8_t color)
 }
 
 
+void SpecVideoRam::saveState(SnapshotWriter& writer)
+{
+    Ram::saveState(writer);
+    writer.write8(m_color);
+    writer.writeBuf(m_colorBuf, m_memSize);
+}
+
+
+void SpecVideoRam::loadState(SnapshotReader& reader)
+{
+    Ram::loadState(reader);
+    m_color = reader.read8();
+    reader.readBuf(m_colorBuf, m_memSize);
+}
+
+
 void SpecVideoRam::reset()
 {
     memset(m_colorBuf, m_memSize, 0x70); // нужно ли?
     m_color = 0x70;
+    markAllDirty();
 };
 
 
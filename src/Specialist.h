@@ -19,6 +19,8 @@
 #ifndef SPECIALIST_H
 #define SPECIALIST_H
 
+#include <vector>
+
 #include "Memory.h"
 #include "CrtRenderer.h"
 #include "PlatformCore.h"
@@ -58,11 +60,15 @@ class SpecVideoRam : public Ram
         virtual ~SpecVideoRam();
 
         void writeByte(int addr, uint8_t value) override;
+        uint8_t* getDirectPagePtr(int addr, bool write) override {return write ? nullptr : Ram::getDirectPagePtr(addr, write);}
         void reset() override;
         uint8_t* getColorDataPtr() {return m_colorBuf;}
 
         void setCurColor(uint8_t color);
 
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
+
         static EmuObject* create(const EmuValuesList& parameters) {return parameters[0].isInt() ? new SpecVideoRam(parameters[0].asInt()) : nullptr;}
 
     private:
@@ -125,16 +131,24 @@ class SpecRenderer : public CrtRenderer
         bool setProperty(const std::string& propertyName, const EmuValuesList& values) override;
         std::string getPropertyStringValue(const std::string& propertyName) override;
 
-        inline void attachScreenMemory(SpecVideoRam* videoMemory) {m_screenMemory = videoMemory->getDataPtr(); m_colorMemory = videoMemory->getColorDataPtr();}
+        void attachScreenMemory(SpecVideoRam* videoMemory);
 
         static EmuObject* create(const EmuValuesList&) {return new SpecRenderer();}
 
     private:
+        SpecVideoRam* m_videoRam = nullptr;
         const uint8_t* m_screenMemory = nullptr;
         const uint8_t* m_colorMemory = nullptr;
 
         SpecColorMode m_colorMode = SCM_8COLOR;
         bool m_showBorder = false;
+
+        // 384x256 image updated for the written video memory blocks only
+        std::vector<uint32_t> m_frameImage;
+        SpecColorMode m_imageColorMode = SCM_8COLOR;
+        bool m_isImageValid = false;
+
+        void renderBlock(int col, int row, int nRows);
 };
 
 
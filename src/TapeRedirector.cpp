@@ -24,6 +24,7 @@
 #include "Platform.h"
 #include "EmuWindow.h"
 #include "CloseFileHook.h" // ElapsedTimer
+#include "InputMovie.h"
 
 #include "TapeRedirector.h"
 
@@ -61,7 +62,13 @@ void TapeRedirector::openFile()
         closeFile();
 
     if (m_permanentFileName == "") {
-        m_fileName = palOpenFileDialog("Open rk file", m_filter + "|Wav Files (*.wav)|*.wav;*.WAV|CSW Files (*.csw)|*.csw;*.CSW", m_rwMode == "w", m_platform->getWindow());
+        string filter = m_filter + "|Wav Files (*.wav)|*.wav;*.WAV|CSW Files (*.csw)|*.csw;*.CSW";
+        // file choice is a part of input movie
+        InputMovie* movie = g_emulation->getMovie();
+        if (movie && movie->getPlatform() == m_platform)
+            m_fileName = movie->chooseTapeFile("Open rk file", filter, m_rwMode == "w");
+        else
+            m_fileName = palOpenFileDialog("Open rk file", filter, m_rwMode == "w", m_platform->getWindow());
         g_emulation->restoreFocus();
     }
     else
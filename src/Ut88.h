@@ -71,6 +71,7 @@ class Ut88AddrSpaceMapper : public AddrSpaceMapper
 
         void writeByte(int addr, uint8_t value) override;
         uint8_t readByte(int addr) override;
+        uint8_t* getDirectPagePtr(int, bool) override {return nullptr;} // depends on CPU status word
 
         static EmuObject* create(const EmuValuesList&) {return new Ut88AddrSpaceMapper();}
 
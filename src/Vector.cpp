@@ -17,8 +17,17 @@
  */
 
 #include <sstream>
+#include <algorithm>
 #include <string.h>
 
+// Active area is converted 16 pixels at a time with SSSE3 if the compiler targets it
+// (-mssse3, -mavx2, -march=native etc.), table-driven scalar code is used otherwise.
+// VECTOR_RENDERER_NO_SIMD forces scalar code.
+#if defined(__SSSE3__) && !defined(VECTOR_RENDERER_NO_SIMD)
+    #define VECTOR_RENDERER_SSSE3
+    #include <tmmintrin.h>
+#endif
+
 #include "Vector.h"
 #include "EmuWindow.h"
 #include "Cpu.h"
@@ -28,6 +37,7 @@
 #include "Fdc1793.h"
 #include "SoundMixer.h"
 #include "WavReader.h"
+#include "Snapshot.h"
 
 using namespace std;
 
@@ -38,6 +48,7 @@ void VectorAddrSpace::reset() {
     m_stackDiskEnabled = false;
     m_inRamDiskPage = 0;
     m_stackDiskPage = 0;
+    invalidateDirectPages();
 }
 
 
@@ -68,12 +79,50 @@ uint8_t VectorAddrSpace::readByte(int addr)
 }
 
 
+uint8_t* VectorAddrSpace::getDirectPagePtr(int addr, bool write)
+{
+    // stack operations may be redirected to ram disk
+    if (m_stackDiskEnabled || unsigned(addr) >= 0x10000)
+        return nullptr;
+    if (m_inRamPagesMask && (addr >= 0x8000) && m_inRamPagesMask & (1 << ((addr & 0x6000) >> 13)))
+        return m_ramDisk->getDirectPagePtr(m_inRamDiskPage * 0x10000 + addr, write);
+    if (write)
+        return addr < 0x8000 ? m_mainMemory->getDirectPagePtr(addr, write) : nullptr; // video memory writes are notified
+    if (m_romEnabled && addr < 0x8000)
+        return m_rom->getDirectPagePtr(addr, write);
+    else
+        return m_mainMemory->getDirectPagePtr(addr, write);
+}
+
+
 void VectorAddrSpace::ramDiskControl(int inRamPagesMask, bool stackEnabled, int inRamPage, int stackPage)
 {
     m_inRamPagesMask = inRamPagesMask;
     m_stackDiskEnabled = stackEnabled;
     m_inRamDiskPage = inRamPage;
     m_stackDiskPage = stackPage;
+    invalidateDirectPages();
+}
+
+
+void VectorAddrSpace::saveState(SnapshotWriter& writer)
+{
+    writer.writeBool(m_romEnabled);
+    writer.writeInt(m_inRamPagesMask);
+    writer.writeBool(m_stackDiskEnabled);
+    writer.writeInt(m_inRamDiskPage);
+    writer.writeInt(m_stackDiskPage);
+}
+
+
+void VectorAddrSpace::loadState(SnapshotReader& reader)
+{
+    m_romEnabled = reader.readBool();
+    m_inRamPagesMask = reader.readInt();
+    m_stackDiskEnabled = reader.readBool();
+    m_inRamDiskPage = reader.readInt() & 3;
+    m_stackDiskPage = reader.readInt() & 3;
+    invalidateDirectPages();
 }
 
 
@@ -154,6 +203,20 @@ void VectorCore::vrtc(bool isActive)
 }
 
 
+void VectorCore::saveState(SnapshotWriter& writer)
+{
+    writer.writeBool(m_intReq);
+    writer.writeBool(m_intsEnabled);
+}
+
+
+void VectorCore::loadState(SnapshotReader& reader)
+{
+    m_intReq = reader.readBool();
+    m_intsEnabled = reader.readBool();
+}
+
+
 void VectorCore::attachCrtRenderer(VectorRenderer* crtRenderer)
 {
     m_crtRenderer = crtRenderer;
@@ -173,6 +236,24 @@ bool VectorCore::setProperty(const string& propertyName, const EmuValuesList& va
 }
 
 
+// Screen byte -> 8 dots, dot N in nibble N, plane bit at its place in color number (Y, R, G, B)
+static uint32_t s_planeDots[4][256];
+static bool s_planeDotsReady = false;
+
+static void initPlaneDots()
+{
+    for (int plane = 0; plane < 4; plane++)
+        for (int bt = 0; bt < 256; bt++) {
+            uint32_t dots = 0;
+            for (int dot = 0; dot < 8; dot++)
+                if (bt & (0x80 >> dot))
+                    dots |= (8 >> plane) << (dot * 4);
+            s_planeDots[plane][bt] = dots;
+        }
+    s_planeDotsReady = true;
+}
+
+
 VectorRenderer::VectorRenderer()
 {
     const int pixelFreq = 12; // MHz
@@ -196,6 +277,9 @@ VectorRenderer::VectorRenderer()
 
     m_frameBuf = new uint32_t[maxBufSize];
 
+    if (!s_planeDotsReady)
+        initPlaneDots();
+
     memset(m_palette, 0, sizeof(uint32_t) * 16);
 
     prepareFrame(); // prepare 1st frame dimensions
@@ -255,6 +339,50 @@ void VectorRenderer::advanceTo(uint64_t clock)
 }
 
 
+void VectorRenderer::saveState(SnapshotWriter& writer)
+{
+    saveClockState(writer);
+    writer.writeInt(m_curLine);
+    writer.write8(m_lineOffset);
+    writer.write8(m_latchedLineOffset);
+    writer.writeBool(m_lineOffsetIsLatched);
+    writer.write8(m_borderColor);
+    writer.writeBool(m_mode512px);
+    writer.writeBool(m_mode512pxLatched);
+    for (int i = 0; i < 16; i++)
+        writer.write32(m_palette[i]);
+    writer.writeInt(m_lastColor);
+    writer.writeClock(m_curScanlineClock);
+    writer.writeInt(m_curScanlinePixel);
+    writer.writeClock(m_curFrameClock);
+    writer.writeInt(m_curFramePixel);
+}
+
+
+void VectorRenderer::loadState(SnapshotReader& reader)
+{
+    loadClockState(reader);
+    m_curLine = reader.readInt();
+    m_lineOffset = reader.read8();
+    m_latchedLineOffset = reader.read8();
+    m_lineOffsetIsLatched = reader.readBool();
+    m_borderColor = reader.read8() & 0x0F;
+    m_mode512px = reader.readBool();
+    m_mode512pxLatched = reader.readBool();
+    for (int i = 0; i < 16; i++)
+        m_palette[i] = reader.read32();
+    m_lastColor = reader.readInt() & 0x0F;
+    m_curScanlineClock = reader.readClock();
+    m_curScanlinePixel = reader.readInt();
+    m_curFrameClock = reader.readClock();
+    m_curFramePixel = reader.readInt();
+    if (m_curFramePixel < 0 || m_curFramePixel >= 312 * 768) {
+        m_curFramePixel = 0;
+        reader.setInvalid();
+    }
+}
+
+
 void VectorRenderer::setBorderColor(uint8_t color)
 {
     advanceTo(g_emulation->getCurClock() + m_ticksPerPixel * 48);
@@ -293,6 +421,95 @@ void VectorRenderer::vidMemWriteNotify()
 }
 
 
+int VectorRenderer::getActivePixelColor(int px, uint8_t rollOff)
+{
+    int dot = (px & 0x0E) >> 1;
+    int offset = ((px & 0x1F0) << 4) | rollOff;
+    uint8_t btY = m_screenMemory[0x8000 + offset] << dot;
+    uint8_t btR = m_screenMemory[0xA000 + offset] << dot;
+    uint8_t btG = m_screenMemory[0xC000 + offset] << dot;
+    uint8_t btB = m_screenMemory[0xE000 + offset] << dot;
+    int logBGcolor = ((btG & 0x80) >> 6) | ((btB & 0x80) >> 7);
+    int logYRcolor = ((btY & 0x80) >> 4) | ((btR & 0x80) >> 5);
+    return logBGcolor | logYRcolor;
+}
+
+
+// Renders active area pixels from firstPx to lastPx (non-inclusive, 0-511)
+void VectorRenderer::renderActiveArea(uint32_t* ptr, uint8_t rollOff, int firstPx, int lastPx)
+{
+    if (firstPx >= lastPx)
+        return;
+
+    // in 512 px mode even pixels take colors 0-3, odd pixels take colors 0, 4, 8, 12
+    int px = firstPx;
+    for (; px < lastPx && (px & 0x0F); px++) {
+        int color = getActivePixelColor(px, rollOff);
+        *ptr++ = m_palette[m_mode512px ? color & (px & 1 ? 0x0C : 0x03) : color];
+    }
+
+#ifdef VECTOR_RENDERER_SSSE3
+    alignas(16) uint8_t paletteBytes[4][16];
+    for (int i = 0; i < 16; i++)
+        for (int k = 0; k < 4; k++)
+            paletteBytes[k][i] = m_palette[i] >> (k * 8);
+    __m128i pal0 = _mm_load_si128((const __m128i*)paletteBytes[0]);
+    __m128i pal1 = _mm_load_si128((const __m128i*)paletteBytes[1]);
+    __m128i pal2 = _mm_load_si128((const __m128i*)paletteBytes[2]);
+    __m128i pal3 = _mm_load_si128((const __m128i*)paletteBytes[3]);
+    __m128i nibbleMask = _mm_set1_epi8(0x0F);
+    __m128i pixelMask = m_mode512px ? _mm_set1_epi16(0x0C03) : _mm_set1_epi8(0x0F);
+#endif
+
+    // whole screen bytes, 16 pixels each
+    for (; px + 16 <= lastPx; px += 16) {
+        int offset = (px << 4) | rollOff;
+        uint32_t dots = s_planeDots[0][m_screenMemory[0x8000 + offset]] | s_planeDots[1][m_screenMemory[0xA000 + offset]] |
+                        s_planeDots[2][m_screenMemory[0xC000 + offset]] | s_planeDots[3][m_screenMemory[0xE000 + offset]];
+#ifdef VECTOR_RENDERER_SSSE3
+        __m128i v = _mm_cvtsi32_si128(dots);
+        __m128i idx = _mm_unpacklo_epi8(_mm_and_si128(v, nibbleMask), _mm_and_si128(_mm_srli_epi16(v, 4), nibbleMask));
+        idx = _mm_and_si128(_mm_unpacklo_epi8(idx, idx), pixelMask);
+        __m128i b0 = _mm_shuffle_epi8(pal0, idx);
+        __m128i b1 = _mm_shuffle_epi8(pal1, idx);
+        __m128i b2 = _mm_shuffle_epi8(pal2, idx);
+        __m128i b3 = _mm_shuffle_epi8(pal3, idx);
+        __m128i b01lo = _mm_unpacklo_epi8(b0, b1);
+        __m128i b01hi = _mm_unpackhi_epi8(b0, b1);
+        __m128i b23lo = _mm_unpacklo_epi8(b2, b3);
+        __m128i b23hi = _mm_unpackhi_epi8(b2, b3);
+        _mm_storeu_si128((__m128i*)ptr, _mm_unpacklo_epi16(b01lo, b23lo));
+        _mm_storeu_si128((__m128i*)(ptr + 4), _mm_unpackhi_epi16(b01lo, b23lo));
+        _mm_storeu_si128((__m128i*)(ptr + 8), _mm_unpacklo_epi16(b01hi, b23hi));
+        _mm_storeu_si128((__m128i*)(ptr + 12), _mm_unpackhi_epi16(b01hi, b23hi));
+        ptr += 16;
+#else
+        if (m_mode512px)
+            for (int i = 0; i < 8; i++) {
+                *ptr++ = m_palette[dots & 0x03];
+                *ptr++ = m_palette[dots & 0x0C];
+                dots >>= 4;
+            }
+        else
+            for (int i = 0; i < 8; i++) {
+                uint32_t color = m_palette[dots & 0x0F];
+                *ptr++ = color;
+                *ptr++ = color;
+                dots >>= 4;
+            }
+#endif
+    }
+
+    for (; px < lastPx; px++) {
+        int color = getActivePixelColor(px, rollOff);
+        *ptr++ = m_palette[m_mode512px ? color & (px & 1 ? 0x0C : 0x03) : color];
+    }
+
+    px = lastPx - 1;
+    m_lastColor = getActivePixelColor(px, rollOff) & (px & 1 ? 0x0C : 0x03);
+}
+
+
 void VectorRenderer::renderLine(int nLine, int firstPx, int lastPx)
 {
     // Render scan line #nLine
@@ -327,22 +544,7 @@ void VectorRenderer::renderLine(int nLine, int firstPx, int lastPx)
         if (firstPx < 181) firstPx = 181;
         ptr = linePtr + firstPx - 124;
         uint8_t rollOff = uint8_t(m_latchedLineOffset - nLine + 40);
-        for (int px = firstPx - 181; px < lastPx - 181 && px < 693 - 181; px++) {
-            int dot = (px & 0x0E) >> 1;
-            int offset = ((px & 0x1F0) << 4) | rollOff;
-            uint8_t btY = m_screenMemory[0x8000 + offset] << dot;
-            uint8_t btR = m_screenMemory[0xA000 + offset] << dot;
-            uint8_t btG = m_screenMemory[0xC000 + offset] << dot;
-            uint8_t btB = m_screenMemory[0xE000 + offset] << dot;
-            int logBGcolor = ((btG & 0x80) >> 6) | ((btB & 0x80) >> 7);
-            int logYRcolor = ((btY & 0x80) >> 4) | ((btR & 0x80) >> 5);
-            m_lastColor = px & 1 ? logYRcolor : logBGcolor;
-            if (m_mode512px) {
-                *ptr++ = m_palette[m_lastColor];
-            } else {
-                *ptr++ = m_palette[logBGcolor | logYRcolor];
-            }
-        }
+        renderActiveArea(ptr, rollOff, firstPx - 181, min(lastPx, 693) - 181);
 
         // right border
         if (firstPx < 693) firstPx = 693;
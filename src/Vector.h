@@ -62,6 +62,9 @@ class VectorRenderer : public CrtRenderer, public IActive
         void setPaletteColor(uint8_t color);
         void vidMemWriteNotify();
 
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
+
         static EmuObject* create(const EmuValuesList&) {return new VectorRenderer();}
 
     private:
@@ -99,6 +102,8 @@ class VectorRenderer : public CrtRenderer, public IActive
 
         void prepareFrame();
         void renderLine(int nLine, int firstPx, int LastPx);
+        void renderActiveArea(uint32_t* ptr, uint8_t rollOff, int firstPx, int lastPx);
+        int getActivePixelColor(int px, uint8_t rollOff);
         //void advance();
         void advanceTo(uint64_t clocks);
 };
@@ -119,6 +124,9 @@ class VectorCore : public PlatformCore
 
         void attachCrtRenderer(VectorRenderer* crtRenderer);
 
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
+
         static EmuObject* create(const EmuValuesList&) {return new VectorCore();}
     private:
         VectorRenderer* m_crtRenderer = nullptr;
@@ -138,15 +146,19 @@ class VectorAddrSpace : public AddressableDevice
 
         void writeByte(int addr, uint8_t value) override;
         uint8_t readByte(int addr) override;
+        uint8_t* getDirectPagePtr(int addr, bool write) override;
 
-        void attachRam(AddressableDevice* mem) {m_mainMemory = mem;}
-        void attachRom(Rom* rom) {m_rom = rom;}
-        void attachRamDisk(AddressableDevice* ramDisk) {m_ramDisk = ramDisk;}
+        void attachRam(AddressableDevice* mem) {m_mainMemory = mem; invalidateDirectPages();}
+        void attachRom(Rom* rom) {m_rom = rom; invalidateDirectPages();}
+        void attachRamDisk(AddressableDevice* ramDisk) {m_ramDisk = ramDisk; invalidateDirectPages();}
         void attachCrtRenderer(VectorRenderer* crtRenderer) {m_crtRenderer = crtRenderer;};
-        void enableRom() {m_romEnabled = true;}
-        void disableRom() {m_romEnabled = false;}
+        void enableRom() {m_romEnabled = true; invalidateDirectPages();}
+        void disableRom() {m_romEnabled = false; invalidateDirectPages();}
         void ramDiskControl(int inRamPagesMask, bool stackEnabled, int inRamPage, int stackPage);
 
+        void saveState(SnapshotWriter& writer) override;
+        void loadState(SnapshotReader& reader) override;
+
         static EmuObject* create(const EmuValuesList&) {return new VectorAddrSpace();}
 
     private:
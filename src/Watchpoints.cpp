@@ -0,0 +1,133 @@
+﻿/*
+ *  Emu80 v. 4.x
+ *  © Viktor Pykhonin <pyk@mail.ru>, 2016-2019
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "Globals.h"
+#include "Watchpoints.h"
+#include "Emulation.h"
+#include "Cpu.h"
+
+using namespace std;
+
+
+WatchpointSpace::WatchpointSpace(Cpu8080Compatible* cpu)
+{
+    m_cpu = cpu;
+    update();
+}
+
+
+void WatchpointSpace::writeByte(int addr, uint8_t value)
+{
+    m_cpu->getAddrSpace()->writeByte(addr, value);
+    if (m_writePages[(addr >> 8) & 0xFF])
+        checkAccess(addr, WT_WRITE, value);
+}
+
+
+uint8_t WatchpointSpace::readByte(int addr)
+{
+    uint8_t value = m_cpu->getAddrSpace()->readByte(addr);
+    if (m_readPages[(addr >> 8) & 0xFF])
+        checkAccess(addr, WT_READ, value);
+    return value;
+}
+
+
+uint8_t* WatchpointSpace::getDirectPagePtr(int addr, bool write)
+{
+    if ((write ? m_writePages : m_readPages)[(addr >> 8) & 0xFF])
+        return nullptr;
+    return m_cpu->getAddrSpace()->getDirectPagePtr(addr, write);
+}
+
+
+int WatchpointSpace::addWatchpoint(uint16_t addr, unsigned size, int type, int value)
+{
+    Watchpoint wp;
+    wp.id = m_nextId++;
+    wp.addr = addr;
+    wp.size = size > 0 && size <= 0x10000 ? size : 1;
+    wp.type = type;
+    wp.value = value;
+    m_watchpoints.push_back(wp);
+    update();
+    return wp.id;
+}
+
+
+void WatchpointSpace::removeWatchpoint(int id)
+{
+    m_watchpoints.remove_if([id](const Watchpoint& wp) {return wp.id == id;});
+    if (m_hitId == id)
+        m_hitId = 0;
+    update();
+}
+
+
+void WatchpointSpace::removeAll()
+{
+    m_watchpoints.clear();
+    m_hitId = 0;
+    update();
+}
+
+
+const Watchpoint* WatchpointSpace::getWatchpoint(int id)
+{
+    for (auto it = m_watchpoints.begin(); it != m_watchpoints.end(); it++)
+        if ((*it).id == id)
+            return &(*it);
+    return nullptr;
+}
+
+
+// Recalculates watched pages and attaches or detaches the layer
+void WatchpointSpace::update()
+{
+    memset(m_readPages, 0, sizeof(m_readPages));
+    memset(m_writePages, 0, sizeof(m_writePages));
+
+    for (auto it = m_watchpoints.begin(); it != m_watchpoints.end(); it++) {
+        unsigned lastPage = (*it).addr + (*it).size - 1;
+        for (unsigned page = (*it).addr >> 8; page <= lastPage >> 8; page++) {
+            if ((*it).type & WT_READ)
+                m_readPages[page & 0xFF] = true;
+            if ((*it).type & WT_WRITE)
+                m_writePages[page & 0xFF] = true;
+        }
+    }
+
+    m_cpu->attachWatchpoints(m_watchpoints.empty() ? nullptr : this);
+    invalidateDirectPages();
+}
+
+
+void WatchpointSpace::checkAccess(int addr, int type, uint8_t value)
+{
+    for (auto it = m_watchpoints.begin(); it != m_watchpoints.end(); it++)
+        if (((*it).type & type) && uint16_t(addr - (*it).addr) < (*it).size && ((*it).value < 0 || (*it).value == value)) {
+            m_hitId = (*it).id;
+            m_hitAddr = addr & 0xFFFF;
+            m_hitValue = value;
+            // access completes, CPU stops after the current instruction
+            g_emulation->debugRequest(m_cpu);
+            return;
+        }
+}
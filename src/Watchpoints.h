@@ -0,0 +1,91 @@
+﻿/*
+ *  Emu80 v. 4.x
+ *  © Viktor Pykhonin <pyk@mail.ru>, 2016-2019
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+// Memory watchpoints
+
+#ifndef WATCHPOINTS_H
+#define WATCHPOINTS_H
+
+#include <list>
+
+#include "EmuObjects.h"
+
+class Cpu8080Compatible;
+
+
+enum WatchpointType {
+    WT_READ = 1,
+    WT_WRITE = 2,
+    WT_ACCESS = 3
+};
+
+
+struct Watchpoint {
+    int id;
+    uint16_t addr;
+    unsigned size;  // range is addr..addr+size-1
+    int type;       // WatchpointType
+    int value;      // triggers only when this value is read or written, -1 for any value
+};
+
+
+// Interposing layer between CPU and its address space. CPU accesses memory through it in slow
+// path only, and direct page pointers are withheld only for pages containing watched ranges,
+// so accesses to other pages don't pass through the layer at all.
+// The layer is attached to CPU while at least one watchpoint is set.
+class WatchpointSpace : public AddressableDevice
+{
+    public:
+        WatchpointSpace(Cpu8080Compatible* cpu);
+
+        void writeByte(int addr, uint8_t value) override;
+        uint8_t readByte(int addr) override;
+        uint8_t* getDirectPagePtr(int addr, bool write) override;
+
+        // returns watchpoint id
+        int addWatchpoint(uint16_t addr, unsigned size, int type, int value = -1);
+        void removeWatchpoint(int id);
+        void removeAll();
+
+        const Watchpoint* getWatchpoint(int id);
+        const std::list<Watchpoint>& getWatchpoints() {return m_watchpoints;}
+
+        // last triggered watchpoint and access, nullptr if none since last call to clearHit()
+        const Watchpoint* getHitWatchpoint() {return getWatchpoint(m_hitId);}
+        int getHitAddr() {return m_hitAddr;}
+        uint8_t getHitValue() {return m_hitValue;}
+        void clearHit() {m_hitId = 0;}
+
+    private:
+        Cpu8080Compatible* m_cpu;
+        std::list<Watchpoint> m_watchpoints;
+        int m_nextId = 1;
+
+        // pages containing read/write watched ranges
+        bool m_readPages[256];
+        bool m_writePages[256];
+
+        int m_hitId = 0;
+        int m_hitAddr = 0;
+        uint8_t m_hitValue = 0;
+
+        void update();
+        void checkAccess(int addr, int type, uint8_t value);
+};
+
+
+#endif // WATCHPOINTS_H
@@ -40,20 +40,35 @@ WavReader::~WavReader()
 bool WavReader::chooseAndLoadFile()
 {
     if (m_isOpen) {
-        m_file.close();
-        g_emulation->setSpeedUpFactor(1);
-        m_isOpen = false;
+        stop();
         return false;
     }
 
-    string fileName = palOpenFileDialog("Open wave file", "Wav and csw files|*.wav;*.WAV;*.csw;*.CSW", false);
-    g_emulation->restoreFocus();
+    string fileName = chooseFile();
     if (fileName == "")
         return true;
 
     return loadFile(fileName);
 }
 
+
+string WavReader::chooseFile()
+{
+    string fileName = palOpenFileDialog("Open wave file", "Wav and csw files|*.wav;*.WAV;*.csw;*.CSW", false);
+    g_emulation->restoreFocus();
+    return fileName;
+}
+
+
+void WavReader::stop()
+{
+    if (m_isOpen) {
+        m_file.close();
+        g_emulation->setSpeedUpFactor(1);
+        m_isOpen = false;
+    }
+}
+
 void WavReader::reportError(const std::string& errorStr)
 {
     emuLog << errorStr << " " << m_fileName << "\n";
@@ -73,6 +88,8 @@ bool WavReader::loadFile(const std::string& fileName, TapeRedirector* tapeRedire
     bool res = tryWavFormat();
 
     if (res) {
+        g_emulation->getSoundMixer()->update();
+
         m_tapeRedirector = tapeRedirector;
         m_startClock = g_emulation->getCurClock();
         m_curSample = 0;
@@ -308,12 +325,17 @@ void WavReader::readNextCswSample()
 
 
 bool WavReader::getCurValue()
+{
+    return getValue(g_emulation->getCurClock());
+}
+
+
+bool WavReader::getValue(uint64_t clock)
 {
     if (!m_isOpen)
         return false;
 
-    uint64_t curClock = g_emulation->getCurClock();
-    int sampleNo = (curClock - m_startClock) * m_sampleRate / g_emulation->getFrequency();
+    int sampleNo = (clock - m_startClock) * m_sampleRate / g_emulation->getFrequency();
 
     if (sampleNo == m_curSample)
         return m_curValue;
@@ -423,7 +445,7 @@ WavSoundSource::WavSoundSource(WavReader* wavReader) : SoundSource()
 }
 
 
-int WavSoundSource::calcValue()
+int WavSoundSource::calcValue(uint64_t clock)
 {
-    return m_wavReader->getCurValue() ? SND_AMP / 2 : 0;
+    return m_wavReader->getValue(clock) ? SND_AMP / 2 : 0;
 }
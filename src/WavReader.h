@@ -46,9 +46,12 @@ class WavReader : public EmuObject
 
         bool loadFile(const std::string& fileName, TapeRedirector* tapeRedirecotr = nullptr);
         bool chooseAndLoadFile();
+        std::string chooseFile();
+        void stop();
         bool isPlaying() {return m_isOpen;}
 
         bool getCurValue();
+        bool getValue(uint64_t clock);
 
     private:
         PalFile m_file;
@@ -93,7 +96,7 @@ class WavSoundSource : public SoundSource
         WavSoundSource(WavReader* wavReader);
 
         // derived from SoundSOurce
-        int calcValue() override;
+        int calcValue(uint64_t clock) override;
 
     private:
         WavReader* m_wavReader;
@@ -0,0 +1,654 @@
+﻿/*
+ *  Emu80 v. 4.x
+ *  © Viktor Pykhonin <pyk@mail.ru>, 2016-2019
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Platform Abstraction Layer (headless version, no display and audio output)
+//
+// Time is virtual: palDelay doesn't sleep but advances the counter, so every
+// main loop cycle emulates one frame period as fast as the host can run it.
+// Options (removed from command line):
+//   --frames N               quit after N main loop cycles
+//   --bench <platforms>      run benchmark for comma separated list of platforms
+//                            ("all" for the standard set) for N frames each
+//   --bench-format json|csv  benchmark results format (json by default)
+//   --bench-output <file>    write benchmark results to file instead of stdout
+//   --profile <file>         profile emulated code of benchmarked platforms and write hot spot
+//                            report to file (<platform>-<file> for several platforms)
+//   --trace <file>           record execution trace of benchmarked platforms and write its
+//                            last part to file (<platform>-<file> for several platforms)
+//   --decode-trace <file>    print trace file as text and exit
+//   --rewind <seconds>       enable rewind buffer of given depth
+//   --load-state <file>      load save state before running
+//   --save-state <file>      write save state after running
+//   --record <file>          record input movie of the platform (after loading state if any)
+//   --replay <file>          play input movie, without --frames runs until the recorded run ends
+//   --cpu-diff <platforms>   run platforms with switch and threaded i8080 cores in lockstep
+//                            ("all" for the standard set) for N frames each, comparing
+//                            their states after every frame, exit code is 1 on mismatch
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sstream>
+#include <vector>
+
+#ifdef __linux__
+    #include <unistd.h>
+    #include <signal.h>
+    #include <sys/wait.h>
+#endif
+
+#include "headlessPal.h"
+
+#include "../Pal.h"
+#include "../EmuCalls.h"
+#include "../Globals.h"
+#include "../CpuTrace.h"
+
+using namespace std;
+
+static string basePath;
+
+static const uint64_t counterFreq = 1000000; // virtual counter frequency, 1 MHz
+static const int defaultFrameRate = 100;
+
+static uint64_t counter = 0;
+static bool delayed = false;
+
+static int sampleRate = 48000;
+static uint64_t maxFrames = 0;
+static uint64_t frameCount = 0;
+
+static bool isRunning = false;
+static bool quitReq = false;
+
+static bool benchMode = false;
+static vector<string> benchPlatforms;
+static string benchFormat = "json";
+static string benchOutput = "";
+static string profileFile = "";
+static string traceFile = "";
+static string rewindDepth = "";
+
+static string loadStateFile = "";
+static string saveStateFile = "";
+
+static string recordFile = "";
+static string replayFile = "";
+
+static bool cpuDiffMode = false;
+static vector<string> cpuDiffPlatforms;
+static bool cpuDiffFailed = false;
+
+static const uint64_t defaultBenchFrames = 1000;
+static const char* const benchAllPlatforms[] = {"rk86", "apogey", "mikrosha", "orion.2", "vector", "spec", "pk8000",
+                                                "partner", "eureka", "mikro80", "ut88"};
+
+
+static void parsePlatformList(const string& platformList, vector<string>& platforms)
+{
+    if (platformList == "all")
+        platforms.assign(begin(benchAllPlatforms), end(benchAllPlatforms));
+    else {
+        istringstream ss(platformList);
+        string platform;
+        while (getline(ss, platform, ','))
+            if (platform != "")
+                platforms.push_back(platform);
+    }
+}
+
+
+bool palHeadlessInit(int& argc, char** argv)
+{
+    // Options recognized by headless PAL are removed from argv
+    int n = 1;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--frames") && i + 1 < argc)
+            maxFrames = strtoull(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--bench") && i + 1 < argc) {
+            benchMode = true;
+            parsePlatformList(argv[++i], benchPlatforms);
+        } else if (!strcmp(argv[i], "--cpu-diff") && i + 1 < argc) {
+            cpuDiffMode = true;
+            parsePlatformList(argv[++i], cpuDiffPlatforms);
+        } else if (!strcmp(argv[i], "--bench-format") && i + 1 < argc)
+            benchFormat = argv[++i];
+        else if (!strcmp(argv[i], "--bench-output") && i + 1 < argc)
+            benchOutput = argv[++i];
+        else if (!strcmp(argv[i], "--profile") && i + 1 < argc)
+            profileFile = argv[++i];
+        else if (!strcmp(argv[i], "--trace") && i + 1 < argc)
+            traceFile = argv[++i];
+        else if (!strcmp(argv[i], "--decode-trace") && i + 1 < argc) {
+            // no emulation is needed to decode
+            if (!decodeTraceFile(argv[++i], stdout)) {
+                fprintf(stderr, "Can't decode trace: %s\n", argv[i]);
+                exit(1);
+            }
+            exit(0);
+        }
+        else if (!strcmp(argv[i], "--rewind") && i + 1 < argc)
+            rewindDepth = argv[++i];
+        else if (!strcmp(argv[i], "--load-state") && i + 1 < argc)
+            loadStateFile = argv[++i];
+        else if (!strcmp(argv[i], "--save-state") && i + 1 < argc)
+            saveStateFile = argv[++i];
+        else if (!strcmp(argv[i], "--record") && i + 1 < argc)
+            recordFile = argv[++i];
+        else if (!strcmp(argv[i], "--replay") && i + 1 < argc)
+            replayFile = argv[++i];
+        else
+            argv[n++] = argv[i];
+    }
+    argc = n;
+    argv[argc] = nullptr;
+
+    if (benchMode) {
+        if (benchPlatforms.empty()) {
+            fprintf(stderr, "No platforms to benchmark\n");
+            return false;
+        }
+        if (benchFormat != "json" && benchFormat != "csv") {
+            fprintf(stderr, "Unknown benchmark format: %s\n", benchFormat.c_str());
+            return false;
+        }
+        if (!maxFrames)
+            maxFrames = defaultBenchFrames;
+    }
+
+    if (cpuDiffMode) {
+        if (cpuDiffPlatforms.empty()) {
+            fprintf(stderr, "No platforms to check\n");
+            return false;
+        }
+        if (!maxFrames)
+            maxFrames = defaultBenchFrames;
+    }
+
+    string exeName;
+#ifdef __linux__
+    char buf[4096];
+    ssize_t len = readlink("/proc/self/exe", buf, sizeof(buf) - 1);
+    if (len > 0) {
+        buf[len] = '\0';
+        exeName = buf;
+    }
+#endif
+    if (exeName == "" && argc > 0)
+        exeName = argv[0];
+
+    string::size_type slashPos = exeName.find_last_of("/\\");
+    ::basePath = slashPos != string::npos ? exeName.substr(0, slashPos + 1) : "";
+
+    return true;
+}
+
+
+void palHeadlessQuit()
+{
+    if (cpuDiffFailed)
+        exit(1);
+}
+
+
+void palStart()
+{
+    isRunning = true;
+}
+
+
+void palPause()
+{
+    // nothing to do
+}
+
+
+void palResume()
+{
+    // nothing to do
+}
+
+
+static void runFrame()
+{
+    delayed = false;
+    emuEmulationCycle();
+
+    // with unlimited frame rate there are no delays, advance time by default frame period
+    if (!delayed)
+        counter += counterFreq / defaultFrameRate;
+}
+
+
+static void runFrames()
+{
+    frameCount = 0;
+    while (!quitReq) {
+        runFrame();
+
+        if (maxFrames && ++frameCount >= maxFrames)
+            break;
+
+        if (!maxFrames && replayFile != "" && emuIsMovieFinished())
+            break;
+    }
+}
+
+
+static string formatBenchResult(const EmuBenchResult& res, uint64_t frames)
+{
+    double hostTime = res.hostTime / 1e9;
+    if (hostTime <= 0)
+        hostTime = 1e-9;
+    double totalTime = res.cpuTime + res.rendererTime + res.mixerTime + res.rewindTime + res.otherTime;
+    if (totalTime <= 0)
+        totalTime = 1;
+
+    char buf[1024];
+    if (benchFormat == "csv")
+        snprintf(buf, sizeof(buf), "%s,%llu,%.6f,%.6f,%.3f,%.3f,%llu,%.0f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f",
+                 res.platformName.c_str(), (unsigned long long)frames, hostTime, res.emulatedTime,
+                 res.emulatedTime / hostTime, res.cpuClocks / hostTime / 1e6,
+                 (unsigned long long)res.instructions, res.instructions / hostTime,
+                 frames ? hostTime * 1e6 / frames : 0.,
+                 res.cpuTime * 100 / totalTime, res.rendererTime * 100 / totalTime,
+                 res.mixerTime * 100 / totalTime, res.rewindTime * 100 / totalTime, res.otherTime * 100 / totalTime);
+    else
+        snprintf(buf, sizeof(buf), "    {\"platform\": \"%s\", \"frames\": %llu, \"host_time_s\": %.6f, "
+                 "\"emulated_time_s\": %.6f, \"speed\": %.3f, \"emulated_mhz\": %.3f, \"instructions\": %llu, "
+                 "\"instructions_per_s\": %.0f, \"frame_time_us\": %.3f, \"cpu_pct\": %.2f, "
+                 "\"renderer_pct\": %.2f, \"mixer_pct\": %.2f, \"rewind_pct\": %.2f, \"other_pct\": %.2f}",
+                 res.platformName.c_str(), (unsigned long long)frames, hostTime, res.emulatedTime,
+                 res.emulatedTime / hostTime, res.cpuClocks / hostTime / 1e6,
+                 (unsigned long long)res.instructions, res.instructions / hostTime,
+                 frames ? hostTime * 1e6 / frames : 0.,
+                 res.cpuTime * 100 / totalTime, res.rendererTime * 100 / totalTime,
+                 res.mixerTime * 100 / totalTime, res.rewindTime * 100 / totalTime, res.otherTime * 100 / totalTime);
+    return buf;
+}
+
+
+// Makes output file name for the platform: <platform>-<file> if several platforms are benchmarked
+static string getPlatformFileName(const string& fileName, const string& platform)
+{
+    if (benchPlatforms.size() < 2)
+        return fileName;
+    string res = fileName;
+    size_t pos = res.find_last_of("/\\") + 1; // 0 if there is no path
+    res.insert(pos, platform + "-");
+    return res;
+}
+
+
+// Runs every platform from benchPlatforms for maxFrames frames and outputs results
+static void runBenchmark()
+{
+    vector<string> results;
+
+    for (unsigned i = 0; i < benchPlatforms.size(); i++) {
+        // 1st platform is already created by emulation as default one
+        if (i > 0)
+            emuSelectPlatform(benchPlatforms[i]);
+        quitReq = false;
+
+        string cpuName = benchPlatforms[i] + ".cpu";
+        if (profileFile != "")
+            emuSetPropertyValue(cpuName, "profiler", "yes");
+        if (traceFile != "")
+            emuSetPropertyValue(cpuName, "trace", "yes");
+
+        emuStartBenchmark();
+        runFrames();
+
+        if (profileFile != "") {
+            string fileName = getPlatformFileName(profileFile, benchPlatforms[i]);
+            if (!emuSetPropertyValue(cpuName, "profilerReport", fileName))
+                fprintf(stderr, "Can't write profile: %s\n", fileName.c_str());
+        }
+        if (traceFile != "") {
+            string fileName = getPlatformFileName(traceFile, benchPlatforms[i]);
+            if (!emuSetPropertyValue(cpuName, "traceDump", fileName))
+                fprintf(stderr, "Can't write trace: %s\n", fileName.c_str());
+        }
+
+        EmuBenchResult res;
+        if (emuGetBenchmarkResult(res))
+            results.push_back(formatBenchResult(res, frameCount));
+        else
+            fprintf(stderr, "Can't run platform: %s\n", benchPlatforms[i].c_str());
+    }
+
+    FILE* file = stdout;
+    if (benchOutput != "") {
+        file = fopen(benchOutput.c_str(), "w");
+        if (!file) {
+            fprintf(stderr, "Can't open file: %s\n", benchOutput.c_str());
+            return;
+        }
+    }
+
+    if (benchFormat == "csv") {
+        fprintf(file, "platform,frames,host_time_s,emulated_time_s,speed,emulated_mhz,instructions,"
+                      "instructions_per_s,frame_time_us,cpu_pct,renderer_pct,mixer_pct,rewind_pct,other_pct\n");
+        for (auto it = results.begin(); it != results.end(); it++)
+            fprintf(file, "%s\n", it->c_str());
+    } else {
+        fprintf(file, "{\n  \"version\": \"%s\",\n  \"results\": [\n", VERSION);
+        for (auto it = results.begin(); it != results.end(); it++)
+            fprintf(file, "%s%s\n", it->c_str(), it + 1 != results.end() ? "," : "");
+        fprintf(file, "  ]\n}\n");
+    }
+
+    if (file != stdout)
+        fclose(file);
+}
+
+
+#ifdef __linux__
+static bool readAll(int fd, void* buf, size_t size)
+{
+    uint8_t* ptr = static_cast<uint8_t*>(buf);
+    while (size) {
+        ssize_t len = read(fd, ptr, size);
+        if (len <= 0)
+            return false;
+        ptr += len;
+        size -= len;
+    }
+    return true;
+}
+
+
+// Runs the current platform with both i8080 cores for maxFrames frames. The process is forked,
+// so both cores start with exactly the same emulator state. Child process runs the switch core
+// and passes state hashes to parent after every frame, parent runs the threaded core and compares.
+static void runPlatformCpuDiff(const string& platform)
+{
+    string cpuName = platform + ".cpu";
+    if (!emuSetPropertyValue(cpuName, "dispatch", "threaded")) {
+        printf("%s: skipped, i8080 threaded core is not available\n", platform.c_str());
+        return;
+    }
+
+    int fds[2];
+    if (pipe(fds)) {
+        fprintf(stderr, "Can't create pipe\n");
+        cpuDiffFailed = true;
+        return;
+    }
+
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) {
+        fprintf(stderr, "Can't fork\n");
+        cpuDiffFailed = true;
+        close(fds[0]);
+        close(fds[1]);
+        return;
+    }
+
+    vector<pair<string, uint64_t> > hashes;
+
+    if (pid == 0) {
+        // child: reference core
+        close(fds[0]);
+        emuSetPropertyValue(cpuName, "dispatch", "switch");
+        for (frameCount = 0; frameCount < maxFrames; frameCount++) {
+            runFrame();
+            emuGetStateHashes(hashes);
+            uint32_t nHashes = hashes.size();
+            if (write(fds[1], &nHashes, sizeof(nHashes)) != sizeof(nHashes))
+                break;
+            for (auto it = hashes.begin(); it != hashes.end(); it++)
+                if (write(fds[1], &it->second, sizeof(it->second)) != sizeof(it->second))
+                    break;
+        }
+        close(fds[1]);
+        _exit(0);
+    }
+
+    // parent: threaded core
+    close(fds[1]);
+    string mismatch;
+    for (frameCount = 0; frameCount < maxFrames && mismatch == ""; frameCount++) {
+        runFrame();
+        emuGetStateHashes(hashes);
+        uint32_t nRefHashes;
+        if (!readAll(fds[0], &nRefHashes, sizeof(nRefHashes)) || nRefHashes != hashes.size()) {
+            mismatch = "section list";
+            break;
+        }
+        for (auto it = hashes.begin(); it != hashes.end(); it++) {
+            uint64_t refHash;
+            if (!readAll(fds[0], &refHash, sizeof(refHash)))
+                mismatch = "section list";
+            else if (refHash != it->second && mismatch == "")
+                mismatch = "section \"" + it->first + "\"";
+        }
+    }
+    close(fds[0]);
+    kill(pid, SIGKILL);
+    waitpid(pid, nullptr, 0);
+
+    if (mismatch == "")
+        printf("%s: ok, %llu frames\n", platform.c_str(), (unsigned long long)frameCount);
+    else {
+        printf("%s: %s mismatch at frame %llu\n", platform.c_str(), mismatch.c_str(), (unsigned long long)frameCount);
+        cpuDiffFailed = true;
+    }
+}
+#endif
+
+
+// Runs every platform from cpuDiffPlatforms with both i8080 cores comparing their states
+static void runCpuDiff()
+{
+#ifdef __linux__
+    for (unsigned i = 0; i < cpuDiffPlatforms.size(); i++) {
+        // 1st platform is already created by emulation as default one
+        if (i > 0)
+            emuSelectPlatform(cpuDiffPlatforms[i]);
+        runPlatformCpuDiff(cpuDiffPlatforms[i]);
+    }
+#else
+    fprintf(stderr, "Cores differential check is not supported on this platform\n");
+    cpuDiffFailed = true;
+#endif
+}
+
+
+void palExecute()
+{
+    if (rewindDepth != "")
+        emuSetPropertyValue("emulation", "rewindDepth", rewindDepth);
+
+    if (benchMode) {
+        runBenchmark();
+        return;
+    }
+
+    if (cpuDiffMode) {
+        runCpuDiff();
+        return;
+    }
+
+    if (loadStateFile != "" && !emuLoadSnapshot(loadStateFile))
+        fprintf(stderr, "Can't load state: %s\n", loadStateFile.c_str());
+
+    if (recordFile != "" && !emuStartMovieRecording(recordFile))
+        fprintf(stderr, "Can't record movie: %s\n", recordFile.c_str());
+    else if (replayFile != "" && !emuStartMoviePlayback(replayFile)) {
+        fprintf(stderr, "Can't play movie: %s\n", replayFile.c_str());
+        return;
+    }
+
+    runFrames();
+
+    if (!emuStopMovie())
+        fprintf(stderr, "Can't write movie: %s\n", recordFile.c_str());
+
+    if (saveStateFile != "" && !emuSaveSnapshot(saveStateFile))
+        fprintf(stderr, "Can't save state: %s\n", saveStateFile.c_str());
+}
+
+
+bool palSetSampleRate(int sampleRate)
+{
+    if (isRunning)
+        return false;
+    ::sampleRate = sampleRate;
+    return true;
+}
+
+
+int palGetSampleRate()
+{
+    return ::sampleRate;
+}
+
+
+bool palSetFrameRate(int)
+{
+    // nothing to do in headless version
+    return true;
+}
+
+
+bool palSetVsync(bool)
+{
+    // nothing to do in headless version
+    return true;
+}
+
+
+string palMakeFullFileName(string fileName)
+{
+    if (fileName[0] == '\0' || fileName[0] == '/' || fileName[0] == '\\' || (fileName.size() > 1 && fileName[1] == ':'))
+        return fileName;
+    string fullFileName(::basePath);
+    fullFileName += fileName;
+    return fullFileName;
+}
+
+
+int palReadFromFile(const string& fileName, int offset, int sizeToRead, uint8_t* buffer, bool useBasePath)
+{
+    string fullFileName;
+    if (useBasePath)
+        fullFileName = palMakeFullFileName(fileName);
+    else
+        fullFileName = fileName;
+
+    FILE* file = fopen(fullFileName.c_str(), "rb");
+    if (!file)
+        return 0;
+
+    int nBytesRead = 0;
+    if (fseek(file, offset, SEEK_SET) == 0)
+        nBytesRead = fread(buffer, 1, sizeToRead, file);
+    fclose(file);
+    return nBytesRead;
+}
+
+
+uint8_t* palReadFile(const string& fileName, int &fileSize, bool useBasePath)
+{
+    string fullFileName;
+    if (useBasePath)
+        fullFileName = palMakeFullFileName(fileName);
+    else
+        fullFileName = fileName;
+
+    FILE* file = fopen(fullFileName.c_str(), "rb");
+    if (!file)
+        return nullptr;
+
+    fseek(file, 0, SEEK_END);
+    fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (fileSize < 0) {
+        fileSize = 0;
+        fclose(file);
+        return nullptr;
+    }
+
+    uint8_t* buf = new uint8_t[fileSize];
+    fileSize = fread(buf, 1, fileSize, file);
+    fclose(file);
+    return buf;
+}
+
+
+void palRequestForQuit()
+{
+    quitReq = true;
+}
+
+
+void palPlaySample(int16_t)
+{
+    // no audio output
+}
+
+
+void palPlaySamples(const int16_t*, int)
+{
+    // no audio output
+}
+
+
+int palGetAudioQueueSize()
+{
+    return 0;
+}
+
+
+int palGetAudioLatency()
+{
+    return 0; // no audio output, emulation speed is not adjusted
+}
+
+
+uint64_t palGetCounter()
+{
+    return counter;
+}
+
+
+uint64_t palGetCounterFreq()
+{
+    return counterFreq;
+}
+
+
+void palDelay(uint64_t time)
+{
+    counter += time;
+    delayed = true;
+}
+
+
+string palGetDefaultPlatform()
+{
+    if (benchMode)
+        return benchPlatforms[0];
+    if (cpuDiffMode)
+        return cpuDiffPlatforms[0];
+    return "";
+}
@@ -0,0 +1,63 @@
+﻿/*
+ *  Emu80 v. 4.x
+ *  © Viktor Pykhonin <pyk@mail.ru>, 2016-2019
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Platform Abstraction Layer (headless version, no display and audio output)
+
+#ifndef HEADLESSPAL_H
+#define HEADLESSPAL_H
+
+#include <string>
+
+#include "../EmuTypes.h"
+#include "../PalKeys.h"
+
+class PalWindow;
+
+bool palHeadlessInit(int& argc, char** argv);
+void palHeadlessQuit();
+
+void palStart();
+void palPause();
+void palResume();
+
+void palExecute();
+
+uint64_t palGetCounter();
+uint64_t palGetCounterFreq();
+void palDelay(uint64_t time);
+
+bool palSetSampleRate(int sampleRate);
+int palGetSampleRate();
+
+bool palSetFrameRate(int frameRate);
+bool palSetVsync(bool vsync);
+
+std::string palMakeFullFileName(std::string fileName);
+int palReadFromFile(const std::string& fileName, int first, int size, uint8_t* buffer, bool useBasePath = true);
+uint8_t* palReadFile(const std::string& fileName, int &fileSize, bool useBasePath = true);
+
+void palRequestForQuit();
+
+void palPlaySample(int16_t sample);
+void palPlaySamples(const int16_t* samples, int nSamples);
+int palGetAudioQueueSize();
+int palGetAudioLatency();
+
+std::string palGetDefaultPlatform();
+
+#endif // HEADLESSPAL_H
@@ -0,0 +1,119 @@
+﻿/*
+ *  Emu80 v. 4.x
+ *  © Viktor Pykhonin <pyk@mail.ru>, 2016-2019
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "headlessPalFile.h"
+
+using namespace std;
+
+bool PalFile::open(string fileName, string mode)
+{
+    if (mode.find('b') == string::npos)
+        mode += "b";
+    m_file = fopen(fileName.c_str(), mode.c_str());
+    return m_file;
+}
+
+
+
+void PalFile::close()
+{
+    if (m_file)
+        fclose(m_file);
+    m_file = nullptr;
+}
+
+
+bool PalFile::isOpen()
+{
+    return m_file != nullptr;
+}
+
+
+uint8_t PalFile::read8()
+{
+    int c = fgetc(m_file);
+    return c != EOF ? c : 0;
+}
+
+
+uint16_t PalFile::read16()
+{
+    uint16_t lo = read8();
+    return lo | (read8() << 8);
+}
+
+
+uint32_t PalFile::read32()
+{
+    uint32_t lo = read16();
+    return lo | (read16() << 16);
+}
+
+
+void PalFile::write8(uint8_t value)
+{
+    fputc(value, m_file);
+}
+
+
+void PalFile::write16(uint16_t value)
+{
+    write8(value & 0xFF);
+    write8(value >> 8);
+}
+
+
+void PalFile::write32(uint32_t value)
+{
+    write16(value & 0xFFFF);
+    write16(value >> 16);
+}
+
+
+int64_t PalFile::getSize()
+{
+    long pos = ftell(m_file);
+    fseek(m_file, 0, SEEK_END);
+    long size = ftell(m_file);
+    fseek(m_file, pos, SEEK_SET);
+    return size;
+}
+
+
+void PalFile::seek(int position)
+{
+    fseek(m_file, position, SEEK_SET);
+}
+
+
+void PalFile::skip(int len)
+{
+    fseek(m_file, len, SEEK_CUR);
+}
+
+
+int64_t PalFile::getPos()
+{
+    return ftell(m_file);
+}
+
+
+bool PalFile::eof()
+{
+    return getSize() == getPos();
+}
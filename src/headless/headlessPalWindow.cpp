@@ -0,0 +1,111 @@
+﻿/*
+ *  Emu80 v. 4.x
+ *  © Viktor Pykhonin <pyk@mail.ru>, 2016-2019
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+
+#include "headlessPalWindow.h"
+
+using namespace std;
+
+PalWindow::PalWindow()
+{
+    m_params.style = PWS_FIXED;
+    m_params.antialiasing = false;
+    m_params.vsync = false;
+    m_params.width = 800;
+    m_params.height = 600;
+    m_params.visible = false;
+    m_params.title = "";
+}
+
+
+PalWindow::~PalWindow()
+{
+}
+
+
+void PalWindow::getSize(int& width, int& height)
+{
+    width = m_params.width;
+    height = m_params.height;
+}
+
+
+static void write16(FILE* file, uint16_t value)
+{
+    fputc(value & 0xFF, file);
+    fputc(value >> 8, file);
+}
+
+
+static void write32(FILE* file, uint32_t value)
+{
+    write16(file, value & 0xFFFF);
+    write16(file, value >> 16);
+}
+
+
+// Nothing is displayed, only screenshot requests are processed (unscaled 24-bit BMP)
+void PalWindow::drawImage(uint32_t* pixels, int imageWidth, int imageHeight, int, int, int, int, bool blend, bool)
+{
+    if (m_ssFileName == "" || blend)
+        return;
+
+    FILE* file = fopen(m_ssFileName.c_str(), "wb");
+    m_ssFileName = "";
+    if (!file)
+        return;
+
+    int lineSize = (imageWidth * 3 + 3) & ~3;
+
+    fputc('B', file);
+    fputc('M', file);
+    write32(file, 54 + lineSize * imageHeight);
+    write32(file, 0);
+    write32(file, 54);
+    write32(file, 40);
+    write32(file, imageWidth);
+    write32(file, imageHeight);
+    write16(file, 1);
+    write16(file, 24);
+    write32(file, 0);
+    write32(file, lineSize * imageHeight);
+    write32(file, 2835);
+    write32(file, 2835);
+    write32(file, 0);
+    write32(file, 0);
+
+    for (int y = imageHeight - 1; y >= 0; y--) {
+        uint32_t* line = pixels + y * imageWidth;
+        for (int x = 0; x < imageWidth; x++) {
+            fputc(line[x] & 0xFF, file);
+            fputc((line[x] >> 8) & 0xFF, file);
+            fputc((line[x] >> 16) & 0xFF, file);
+        }
+        for (int i = imageWidth * 3; i < lineSize; i++)
+            fputc(0, file);
+    }
+
+    fclose(file);
+}
+
+
+void PalWindow::screenshotRequest(const std::string& ssFileName)
+{
+    m_ssFileName = ssFileName;
+}
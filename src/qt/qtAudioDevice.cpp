@@ -19,10 +19,8 @@
 #include "qtAudioDevice.h"
 
 
-EmuAudioIoDevice::EmuAudioIoDevice(int sampleRate, int frameRate) : QIODevice(nullptr)
+EmuAudioIoDevice::EmuAudioIoDevice(int sampleRate, int frameRate) : QIODevice(nullptr), m_ringBuffer(16384)
 {
-    m_buffer = new QByteArray();
-    m_pos = 0;
     if (frameRate == 0 || frameRate > 60)
         frameRate = 60;
     m_minSamples = sampleRate / (frameRate - 6);
@@ -38,45 +36,46 @@ void EmuAudioIoDevice::start()
 
 void EmuAudioIoDevice::stop()
 {
-    m_pos = 0;
     close();
+    m_ringBuffer.reset();
 }
 
 
 qint64 EmuAudioIoDevice::readData(char *data, qint64 maxSize)
 {
-    if (m_pos < m_minSamples) {
-        for (;m_pos < m_minSamples; m_pos++)
-            m_buf[m_pos] = m_lastSample;
-    } else if (m_pos > m_maxSamples)
-        m_pos = m_minSamples * 2;
-
-    if (maxt < m_pos) maxt = m_pos; // !!!
-    if (maxt == 16384) maxt = 0;    // !!!
-
-     if (maxSize >= m_pos * 2) {
-        memcpy(data, m_buf, m_pos * 2);
-        int read = m_pos * 2;
-        m_pos = 0;
-        return read;
-    } else {
-        memcpy(data, m_buf, maxSize);
-        memcpy(m_buf, m_buf + maxSize / 2, m_pos * 2 - maxSize);
-        m_pos = m_pos - maxSize / 2;
-        return maxSize;
-    }
+    int16_t* samples = reinterpret_cast<int16_t*>(data);
+    int maxSamples = maxSize / 2;
+
+    int queued = m_ringBuffer.getOccupancy();
+    if (queued > m_maxSamples)
+        m_ringBuffer.skip(queued - m_minSamples * 2);
+
+    int n = m_ringBuffer.read(samples, maxSamples);
+    if (n > 0)
+        m_lastSample = samples[n - 1];
+
+    // not enough samples, repeat the last one
+    int minSamples = m_minSamples < maxSamples ? m_minSamples : maxSamples;
+    for (; n < minSamples; n++)
+        samples[n] = m_lastSample;
+
+    return n * 2;
 }
 
 
 qint64 EmuAudioIoDevice::bytesAvailable() const
 {
-    return m_pos * 2;
+    return m_ringBuffer.getOccupancy() * 2;
 }
 
 
 void EmuAudioIoDevice::addSample(int16_t sample)
 {
-    m_lastSample = sample;
-    if (m_pos < 16384)
-        m_buf[m_pos++] = sample;
+    m_ringBuffer.write(&sample, 1);
+}
+
+
+void EmuAudioIoDevice::addSamples(const int16_t* samples, int nSamples)
+{
+    m_ringBuffer.write(samples, nSamples);
 }
@@ -21,6 +21,8 @@
 
 #include <QIODevice>
 
+#include "../AudioRingBuffer.h"
+
 class EmuAudioIoDevice : public QIODevice
 {
     Q_OBJECT
@@ -30,6 +32,11 @@ class EmuAudioIoDevice : public QIODevice
         //~EmuAudioIoDevice();
 
         void addSample(int16_t sample);
+        void addSamples(const int16_t* samples, int nSamples);
+
+        // number of queued samples and target queue size
+        int getQueueSize() {return m_ringBuffer.getOccupancy();}
+        int getLatency() {return m_minSamples * 2;}
 
         void start();
         void stop();
@@ -46,15 +53,11 @@ class EmuAudioIoDevice : public QIODevice
         qint64 bytesAvailable() const override;
 
     private:
-        qint64 m_pos;
-        QByteArray* m_buffer;
+        AudioRingBuffer m_ringBuffer;
         int16_t m_lastSample = 0;
 
         int m_minSamples;
         int m_maxSamples;
-   int maxt = 0;
-
-        int16_t m_buf[16384];
 };
 
 
@@ -366,6 +366,30 @@ void MainWindow::createActions()
 
     m_ramDiskSeparator = fileMenu->addSeparator();
 
+    // Save state
+    QAction* saveStateAction = new QAction(tr("Save State..."), this);
+    saveStateAction->setToolTip(tr("Save emulation state (Alt-F2)"));
+    QList<QKeySequence> saveStateKeysList;
+    saveStateKeysList.append(QKeySequence(Qt::ALT + Qt::Key_F2));
+    saveStateKeysList.append(QKeySequence(Qt::META + Qt::Key_F2));
+    saveStateAction->setShortcuts(saveStateKeysList);
+    addAction(saveStateAction);
+    fileMenu->addAction(saveStateAction);
+    connect(saveStateAction, SIGNAL(triggered()), this, SLOT(onSaveState()));
+
+    // Load state
+    QAction* loadStateAction = new QAction(tr("Load State..."), this);
+    loadStateAction->setToolTip(tr("Load emulation state (Alt-F5)"));
+    QList<QKeySequence> loadStateKeysList;
+    loadStateKeysList.append(QKeySequence(Qt::ALT + Qt::Key_F5));
+    loadStateKeysList.append(QKeySequence(Qt::META + Qt::Key_F5));
+    loadStateAction->setShortcuts(loadStateKeysList);
+    addAction(loadStateAction);
+    fileMenu->addAction(loadStateAction);
+    connect(loadStateAction, SIGNAL(triggered()), this, SLOT(onLoadState()));
+
+    fileMenu->addSeparator();
+
     // Exit
     m_exitAction = new QAction(tr("Exit"), this);
     m_exitAction->setToolTip(tr("Exit (Alt-X)"));
@@ -425,6 +449,17 @@ void MainWindow::createActions()
     m_toolBar->addAction(m_pauseAction);
     connect(m_pauseAction, SIGNAL(triggered()), this, SLOT(onPause()));
 
+    // Rewind
+    QAction* rewindAction = new QAction(tr("Rewind"), this);
+    rewindAction->setToolTip(tr("Rewind (Alt-Backspace)"));
+    QList<QKeySequence> rewindKeysList;
+    rewindKeysList.append(QKeySequence(Qt::ALT + Qt::Key_Backspace));
+    rewindKeysList.append(QKeySequence(Qt::META + Qt::Key_Backspace));
+    rewindAction->setShortcuts(rewindKeysList);
+    addAction(rewindAction);
+    platformMenu->addAction(rewindAction);
+    connect(rewindAction, SIGNAL(triggered()), this, SLOT(onRewind()));
+
     // Fast forward
     QToolButton* forwardButton = new QToolButton(this);
     forwardButton->setFocusPolicy(Qt::NoFocus);
@@ -1621,6 +1656,24 @@ void MainWindow::onSaveRamDisk()
 }
 
 
+void MainWindow::onSaveState()
+{
+    emuSysReq(m_palWindow, SR_SAVESTATE);
+}
+
+
+void MainWindow::onLoadState()
+{
+    emuSysReq(m_palWindow, SR_LOADSTATE);
+}
+
+
+void MainWindow::onRewind()
+{
+    emuSysReq(m_palWindow, SR_REWIND);
+}
+
+
 void MainWindow::updateConfig()
 {
     if (m_palWindow->getWindowType() != EWT_EMULATION)
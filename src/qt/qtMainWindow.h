@@ -109,6 +109,9 @@ private slots:
     void onMute();
     void onLoadRamDisk();
     void onSaveRamDisk();
+    void onSaveState();
+    void onLoadState();
+    void onRewind();
 
 private:
     PaintWidget* m_paintWidget;
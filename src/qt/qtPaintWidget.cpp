@@ -16,6 +16,8 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <utility>
+
 #include <QPainter>
 #include <QOpenGLContext>
 #include <QPaintEvent>
@@ -43,15 +45,16 @@ PaintWidget::PaintWidget(QWidget *parent) :
 
 PaintWidget::~PaintWidget()
 {
-    if (m_image)
-        delete m_image;
-    if (m_image2)
-        delete m_image2;
 }
 
 
 void PaintWidget::draw()
 {
+    if (m_backBufferDrawn) {
+        std::swap(m_frontBuffer, m_backBuffer);
+        m_backBufferDrawn = false;
+    }
+
     m_needPaint = true;
     //repaint();
     update();
@@ -63,7 +66,7 @@ void PaintWidget::screenshot(const QString& ssFileName)
     /*QImage fullImg = grabFramebuffer();
     QImage img = fullImg.copy(m_dstRect);*/
 
-    if (!m_image) // to be on the safe side
+    if (!m_frontBuffer->isValid) // to be on the safe side
         return;
 
     int width = m_dstRect.width();
@@ -96,39 +99,36 @@ void PaintWidget::screenshot(const QString& ssFileName)
 void PaintWidget::colorFill(QColor color)
 {
     m_fillColor = color;
-    if (m_image) {
-        delete m_image;
-        delete m_imageData;
-        m_image = nullptr;
-    }
+    m_backBuffer->isValid = false;
+    m_backBuffer->hasImage2 = false;
+    m_backBufferDrawn = true;
+}
+
+
+void PaintWidget::copyToImage(QImage& image, uint32_t* pixels, int width, int height, QImage::Format format)
+{
+    if (image.width() != width || image.height() != height || image.format() != format)
+        image = QImage(width, height, format);
+    memcpy(image.bits(), pixels, width * height * 4);
 }
 
 
 void PaintWidget::drawImage(uint32_t* pixels, int imageWidth, int imageHeight, int dstX, int dstY, int dstWidth, int dstHeight, bool blend, bool useAlpha)
 {
     m_dstRect.setRect(dstX, dstY, dstWidth, dstHeight);
+    m_backBufferDrawn = true;
 
-    if (m_image2) {
-        delete m_image2;
-        m_image2 = nullptr;
-        delete m_imageData2;
-    }
+    m_backBuffer->hasImage2 = false;
 
     if (useAlpha || blend) {
-        m_imageData2 = new uchar[imageWidth * imageHeight * 4];
-        memcpy(m_imageData2, pixels, imageWidth * imageHeight * 4);
-        m_image2 = new QImage(m_imageData2, imageWidth, imageHeight, useAlpha ? QImage::Format_ARGB32 : QImage::Format_RGB32);
-        m_useAlpha = useAlpha;
+        copyToImage(m_backBuffer->image2, pixels, imageWidth, imageHeight, useAlpha ? QImage::Format_ARGB32 : QImage::Format_RGB32);
+        m_backBuffer->hasImage2 = true;
+        m_backBuffer->useAlpha = useAlpha;
         return;
     }
 
-    if (m_image) {
-        delete m_image;
-        delete m_imageData;
-    }
-    m_imageData = new uchar[imageWidth * imageHeight * 4];
-    memcpy(m_imageData, pixels, imageWidth * imageHeight * 4);
-    m_image = new QImage(m_imageData, imageWidth, imageHeight, QImage::Format_RGB32);
+    copyToImage(m_backBuffer->image, pixels, imageWidth, imageHeight, QImage::Format_RGB32);
+    m_backBuffer->isValid = true;
 }
 
 
@@ -136,20 +136,22 @@ void PaintWidget::paintScreen(QPainter* painter, QRect dstRect)
 {
     painter->setRenderHint(QPainter::SmoothPixmapTransform, m_antialiasing);
 
-    QRect srcRect(0, 0, m_image->width(), m_image->height());
+    const QImage& image = m_frontBuffer->image;
+    const QImage& image2 = m_frontBuffer->image2;
+    QRect srcRect(0, 0, image.width(), image.height());
 
-    if (!m_image2)
-        painter->drawImage(dstRect, *m_image, srcRect);
-    else if (m_useAlpha) {
-        painter->drawImage(dstRect, *m_image, srcRect);
-        QRectF srcRect2(0, 0, m_image2->width(), m_image2->height());
-        painter->drawImage(dstRect, *m_image2, srcRect2);
+    if (!m_frontBuffer->hasImage2)
+        painter->drawImage(dstRect, image, srcRect);
+    else if (m_frontBuffer->useAlpha) {
+        painter->drawImage(dstRect, image, srcRect);
+        QRectF srcRect2(0, 0, image2.width(), image2.height());
+        painter->drawImage(dstRect, image2, srcRect2);
     } else {
         painter->fillRect(dstRect, Qt::black);
         painter->setOpacity(0.5);
-        painter->drawImage(dstRect, *m_image, srcRect);
-        QRectF srcRect2(0, 0, m_image2->width(), m_image2->height());
-        painter->drawImage(dstRect, *m_image2, srcRect2);
+        painter->drawImage(dstRect, image, srcRect);
+        QRectF srcRect2(0, 0, image2.width(), image2.height());
+        painter->drawImage(dstRect, image2, srcRect2);
     }
 }
 
@@ -160,16 +162,14 @@ void PaintWidget::paintEvent(QPaintEvent*)
         return;
     m_needPaint = false;
 
-    QPainter* painter = new QPainter();
-    painter->begin(this);
-    painter->fillRect(QRect(0, 0, width(), height()), m_fillColor);
-
-    if (m_image)
-        paintScreen(painter, m_dstRect);
+    QPainter painter;
+    painter.begin(this);
+    painter.fillRect(QRect(0, 0, width(), height()), m_fillColor);
 
-    painter->end();
+    if (m_frontBuffer->isValid)
+        paintScreen(&painter, m_dstRect);
 
-    delete painter;
+    painter.end();
 
     static_cast<MainWindow*>(parent())->incFrameCount();
 }
@@ -56,15 +56,25 @@ class PaintWidget : public QOpenGLWidget
         void onHideCursorTimer();
 
     private:
+        // Frame images are reused across frames and re-allocated only if frame size or format changes.
+        // Two frame buffers are used: the back one is being drawn by emulation, the front one is painted.
+        struct FrameBuffer {
+            QImage image;
+            QImage image2;          // blended previous field or overlay
+            bool isValid = false;   // image is drawn
+            bool hasImage2 = false;
+            bool useAlpha = false;
+        };
+
         void paintScreen(QPainter* painter, QRect dstRect);
+        void copyToImage(QImage& image, uint32_t* pixels, int width, int height, QImage::Format format);
 
-        QImage* m_image = nullptr;
-        QImage* m_image2 = nullptr;
-        uchar* m_imageData;
-        uchar* m_imageData2;
+        FrameBuffer m_frameBuffers[2];
+        FrameBuffer* m_frontBuffer = &m_frameBuffers[0];
+        FrameBuffer* m_backBuffer = &m_frameBuffers[1];
+        bool m_backBufferDrawn = false;
 
         bool m_needPaint = false;
-        bool m_useAlpha = false;
         QColor m_fillColor = Qt::black;
         QRect m_dstRect;
 
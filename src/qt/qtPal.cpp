@@ -322,6 +322,25 @@ void palPlaySample(int16_t sample)
 }
 
 
+void palPlaySamples(const int16_t* samples, int nSamples)
+{
+    if (audioDevice)
+        audioDevice->addSamples(samples, nSamples);
+}
+
+
+int palGetAudioQueueSize()
+{
+    return audioDevice ? audioDevice->getQueueSize() : 0;
+}
+
+
+int palGetAudioLatency()
+{
+    return audioDevice ? audioDevice->getLatency() : 0;
+}
+
+
 uint64_t palGetCounter()
 {
     return timer.nsecsElapsed();
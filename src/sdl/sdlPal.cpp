@@ -28,22 +28,22 @@
 #include "../EmuCalls.h"
 #include "../EmuTypes.h"
 #include "../Shortcuts.h"
+#include "../AudioRingBuffer.h"
 
 using namespace std;
 
-#define BUF_NUM 3
-
 static string basePath;
 
 static SDL_AudioDeviceID audioDevId;
 
+// samples requested by SDL per callback
 const int audioBufferSize = 2048;
-static int16_t audioBuffer[BUF_NUM][audioBufferSize];
-static int audioBufferPos;
-static int audioBufferNumIn;
-static int audioBufferNumOut;
 
-static uint16_t lastSample;
+// samples queued between emulation and audio callback
+static AudioRingBuffer audioRingBuffer(16384);
+
+// target audio queue size in samples, 0 if audio output is not opened
+static int audioLatency = 0;
 
 //static bool quitReq = false;
 
@@ -77,13 +77,14 @@ void palStart()
     spec.freq = sampleRate;
     spec.format = AUDIO_S16;
     spec.channels = 1;
-    spec.samples = 2048;
+    spec.samples = audioBufferSize;
     spec.callback = audioCallback;
 
-    audioBufferPos = 1024;
-    audioBufferNumIn = 1;
-    audioBufferNumOut = 0;
+    audioRingBuffer.reset();
     audioDevId = SDL_OpenAudioDevice(NULL, false, &spec, &spec, 0);
+    if (audioDevId)
+        // one callback buffer plus 20 ms reserve
+        audioLatency = spec.samples + sampleRate / 50;
     SDL_PauseAudioDevice(audioDevId, false);
 
     SDL_StartTextInput();
@@ -115,6 +116,7 @@ void palExecute()
 void palSdlQuit()
 {
     SDL_CloseAudioDevice(audioDevId);
+    audioLatency = 0;
 
     SDL_Quit();
 }
@@ -533,33 +535,44 @@ void palRequestForQuit()
 }
 
 
+// Called in SDL audio thread
 void audioCallback(void*, Uint8* stream, int len)
 {
-    //cout << audioBufferNumIn << ":" << audioBufferNumOut << " ";
-    //cout << (audioBufferNumIn + BUF_NUM - audioBufferNumOut) % BUF_NUM << ":" << audioBufferPos << " ";
-
-    if (len != audioBufferSize * 2)
-        return; // error
-    if (audioBufferNumIn == audioBufferNumOut) {
-        //memset(stream, 0, len);
-        for (int i = audioBufferPos; i < audioBufferSize; i++)
-            ((uint16_t*)stream)[i] = ::lastSample;
-        audioBufferPos = 0;
-    } else {
-        memcpy(stream, audioBuffer[audioBufferNumOut], len);
-        audioBufferNumOut = (audioBufferNumOut + 1) % BUF_NUM;
-    }
+    // last sample played, repeated on underrun
+    static int16_t lastSample = 0;
+
+    int16_t* samples = (int16_t*)stream;
+    int nSamples = len / 2;
+
+    int n = audioRingBuffer.read(samples, nSamples);
+    if (n > 0)
+        lastSample = samples[n - 1];
+    for (int i = n; i < nSamples; i++)
+        samples[i] = lastSample;
 }
 
 
 void palPlaySample(int16_t sample)
 {
-    ::lastSample = sample;
-    audioBuffer[audioBufferNumIn][audioBufferPos++] = sample;
-    if (audioBufferPos == audioBufferSize) {
-        audioBufferPos = 0;
-        audioBufferNumIn = (audioBufferNumIn + 1) % BUF_NUM;
-    }
+    audioRingBuffer.write(&sample, 1);
+}
+
+
+void palPlaySamples(const int16_t* samples, int nSamples)
+{
+    audioRingBuffer.write(samples, nSamples);
+}
+
+
+int palGetAudioQueueSize()
+{
+    return audioRingBuffer.getOccupancy();
+}
+
+
+int palGetAudioLatency()
+{
+    return audioLatency;
 }
 
 
@@ -55,6 +55,9 @@ uint8_t* palReadFile(const std::string& fileName, int &fileSize, bool useBasePat
 void palRequestForQuit();
 
 void palPlaySample(int16_t sample);
+void palPlaySamples(const int16_t* samples, int nSamples);
+int palGetAudioQueueSize();
+int palGetAudioLatency();
 
 std::string palGetDefaultPlatform();
 
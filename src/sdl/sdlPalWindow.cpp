@@ -36,6 +36,7 @@ PalWindow::PalWindow()
 
 PalWindow::~PalWindow()
 {
+    destroyTextures();
     if (m_renderer)
         SDL_DestroyRenderer(m_renderer);
     if (m_window) {
@@ -130,6 +131,7 @@ void PalWindow::recreateWindow()
                 h = m_lastHeight;
             }
         }
+        destroyTextures();
         SDL_DestroyRenderer(m_renderer);
         m_renderer = nullptr;
         SDL_GetDisplayBounds(SDL_GetWindowDisplayIndex(m_window), &displayBounds);
@@ -163,6 +165,7 @@ void PalWindow::recreateWindow()
 
 void PalWindow::recreateRenderer()
 {
+    destroyTextures();
     if (m_renderer)
         SDL_DestroyRenderer(m_renderer);
     m_renderer = SDL_CreateRenderer(m_window, -1, m_params.vsync ? SDL_RENDERER_PRESENTVSYNC : 0);
@@ -198,18 +201,52 @@ void PalWindow::drawFill(uint32_t color)
 }
 
 
-void PalWindow::drawImage(uint32_t* pixels, int imageWidth, int imageHeight, int dstX, int dstY, int dstWidth, int dstHeight, bool blend, bool useAlpha)
+SDL_Texture* PalWindow::getLayerTexture(int width, int height, bool useAlpha)
 {
-    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, m_params.antialiasing ? "2" : "0");
+    if (m_curLayer >= m_layers.size())
+        m_layers.resize(m_curLayer + 1);
+    LayerTexture& layer = m_layers[m_curLayer++];
+
+    // texture is re-created only if frame geometry or format changes,
+    // scale quality hint is applied at texture creation time so it's checked too
+    if (!layer.texture || layer.width != width || layer.height != height || layer.useAlpha != useAlpha ||
+            layer.antialiasing != m_params.antialiasing) {
+        if (layer.texture)
+            SDL_DestroyTexture(layer.texture);
+        SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, m_params.antialiasing ? "2" : "0");
+        layer.texture = SDL_CreateTexture(m_renderer, useAlpha ? SDL_PIXELFORMAT_ARGB8888 : SDL_PIXELFORMAT_RGB888,
+                                          SDL_TEXTUREACCESS_STREAMING, width, height);
+        layer.width = width;
+        layer.height = height;
+        layer.useAlpha = useAlpha;
+        layer.antialiasing = m_params.antialiasing;
+    }
+
+    return layer.texture;
+}
 
-    SDL_Surface* surface = SDL_CreateRGBSurfaceFrom(pixels, imageWidth, imageHeight,
-                                                    32, imageWidth * 4, 0x00FF0000, 0x0000FF00, 0x000000FF, useAlpha ? 0xFF000000 : 0);
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(m_renderer, surface);
-    SDL_SetTextureBlendMode(texture, blend ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
-    if (blend && !useAlpha)
-        SDL_SetTextureAlphaMod(texture, 0x80);
-    SDL_Rect dstRect = {dstX, dstY, dstWidth, dstHeight};
-    SDL_RenderCopy(m_renderer, texture, NULL, &dstRect);
+
+void PalWindow::destroyTextures()
+{
+    for (auto it = m_layers.begin(); it != m_layers.end(); it++)
+        if (it->texture)
+            SDL_DestroyTexture(it->texture);
+    m_layers.clear();
+    m_curLayer = 0;
+}
+
+
+void PalWindow::drawImage(uint32_t* pixels, int imageWidth, int imageHeight, int dstX, int dstY, int dstWidth, int dstHeight, bool blend, bool useAlpha)
+{
+    SDL_Texture* texture = getLayerTexture(imageWidth, imageHeight, useAlpha);
+    if (texture) {
+        // pixels are uploaded directly from the renderer buffer, no intermediate surface
+        SDL_UpdateTexture(texture, NULL, pixels, imageWidth * 4);
+        SDL_SetTextureBlendMode(texture, blend ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
+        SDL_SetTextureAlphaMod(texture, blend && !useAlpha ? 0x80 : 0xFF);
+        SDL_Rect dstRect = {dstX, dstY, dstWidth, dstHeight};
+        SDL_RenderCopy(m_renderer, texture, NULL, &dstRect);
+    }
 
     // Screenshot processing
     int ssWidth = imageWidth * 2;
@@ -219,22 +256,24 @@ void PalWindow::drawImage(uint32_t* pixels, int imageWidth, int imageHeight, int
         m_ssRenderer = SDL_CreateSoftwareRenderer(m_ssSurface);
     }
     if (m_ssSurface) {
+        SDL_Surface* surface = SDL_CreateRGBSurfaceFrom(pixels, imageWidth, imageHeight,
+                                                        32, imageWidth * 4, 0x00FF0000, 0x0000FF00, 0x000000FF, useAlpha ? 0xFF000000 : 0);
         SDL_Texture* ssTexture = SDL_CreateTextureFromSurface(m_ssRenderer, surface);
         SDL_SetTextureBlendMode(ssTexture, blend ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
         if (blend && !useAlpha)
             SDL_SetTextureAlphaMod(ssTexture, 0x80);
         SDL_Rect ssRect = {0, 0, ssWidth, ssHeight};
         SDL_RenderCopy(m_ssRenderer, ssTexture, NULL, &ssRect);
+        SDL_DestroyTexture(ssTexture);
+        SDL_FreeSurface(surface);
     }
-
-    SDL_FreeSurface(surface);
-    SDL_DestroyTexture(texture);
 }
 
 
 void PalWindow::drawEnd()
 {
     SDL_RenderPresent(m_renderer);
+    m_curLayer = 0;
 
     // Screenshot
     if (m_ssSurface) {
@@ -21,6 +21,7 @@
 
 #include <string>
 #include <map>
+#include <vector>
 
 #include <SDL2/SDL.h>
 
@@ -83,6 +84,21 @@ class PalWindow
         void recreateWindow();
         void recreateRenderer();
 
+        // Streaming textures, one per image drawn during a frame (layer), kept between frames
+        struct LayerTexture {
+            SDL_Texture* texture = nullptr;
+            int width = 0;
+            int height = 0;
+            bool useAlpha = false;
+            bool antialiasing = false;
+        };
+
+        std::vector<LayerTexture> m_layers;
+        unsigned m_curLayer = 0;
+
+        SDL_Texture* getLayerTexture(int width, int height, bool useAlpha);
+        void destroyTextures();
+
         PalWindowParams m_prevParams;
         int m_lastX;
         int m_lastY;